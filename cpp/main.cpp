@@ -1,5 +1,4 @@
 #include <stdio.h>
-#include <map>
 #include "utils/cmdline.hpp"
 #include "utils/timer.hpp"
 #include "utils/AudioLoader.hpp"
@@ -12,18 +11,10 @@ extern "C" {
 }
 #endif
 
-static std::map<std::string, AX_ASR_TYPE_E>     model_type_map = {
-    {"whisper_tiny", AX_WHISPER_TINY},
-    {"whisper_base", AX_WHISPER_BASE},
-    {"whisper_small", AX_WHISPER_SMALL},
-    {"whisper_turbo", AX_WHISPER_TURBO},
-    {"sensevoice", AX_SENSEVOICE}
-};
-
 int main(int argc, char** argv) {
     cmdline::parser cmd;
-    cmd.add<std::string>("audio", 'a', "audio file, support wav and mp3", true, "");
-    cmd.add<std::string>("model_type", 't', "Choose from whisper_tiny, whisper_base, whisper_small, whisper_turbo, sensevoice", true, "");
+    cmd.add<std::string>("audio", 'a', "audio file, support wav, mp3, flac and opus", true, "");
+    cmd.add<std::string>("model_type", 't', "Choose from whisper_tiny, whisper_base, whisper_small, whisper_turbo, sensevoice, sensevoice_whisper_small, sensevoice_whisper_turbo, zipformer, paraformer, or a variant with manifest.json under model_path", true, "");
 #if defined(CHIP_AX650) || defined(CHIP_AX8850)
     cmd.add<std::string>("model_path", 'p', "model path which contains axmodel", false, "./models-ax650");
 #else
@@ -38,12 +29,15 @@ int main(int argc, char** argv) {
     auto model_path = cmd.get<std::string>("model_path");
     auto language = cmd.get<std::string>("language");
 
-    if (model_type_map.find(model_type_key) == model_type_map.end()) {
-        fprintf(stderr, "Cannot find model_type: %s, please check help", model_type_key.c_str());
+    char* base = nullptr;
+    if (0 != AX_ASR_GetModelBase(model_path.c_str(), model_type_key.c_str(), &base)) {
+        char* names = nullptr;
+        AX_ASR_ListModels(model_path.c_str(), &names);
+        fprintf(stderr, "Cannot find model_type: %s, choose from %s\n", model_type_key.c_str(), names ? names : "");
+        AX_ASR_Free(names);
         return -1;
     }
-
-    auto model_type = model_type_map[model_type_key];
+    AX_ASR_Free(base);
 
     utils::AudioLoader audio_loader;
     if (!audio_loader.load(audio_file)) {
@@ -57,7 +51,7 @@ int main(int argc, char** argv) {
     Timer timer;
 
     timer.start();
-    AX_ASR_HANDLE handle = AX_ASR_Init(model_type, model_path.c_str());
+    AX_ASR_HANDLE handle = AX_ASR_InitByName(model_type_key.c_str(), model_path.c_str());
     timer.stop();
 
     if (!handle) {
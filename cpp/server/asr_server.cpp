@@ -18,14 +18,15 @@
 #include <vector>
 #include <net/if.h>
 
-#include <fcntl.h>
 #include <ifaddrs.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 
 #include "asr_server.hpp"
+#include "utils/AudioReader.hpp"
 #include "utils/logger.h"
 #include "utils/nlohmann/json.hpp"
+#include "utils/opus_file_decoder.hpp"
 
 namespace {
 
@@ -34,12 +35,11 @@ using json = nlohmann::json;
 constexpr const char* HEALTH_ENDPOINT = "/healthz";
 constexpr const char* MODELS_ENDPOINT = "/v1/models";
 
-const std::map<std::string, AX_ASR_TYPE_E> kModelMap = {
-    {"whisper_tiny", AX_WHISPER_TINY},
-    {"whisper_base", AX_WHISPER_BASE},
-    {"whisper_small", AX_WHISPER_SMALL},
-    {"whisper_turbo", AX_WHISPER_TURBO},
-    {"sensevoice", AX_SENSEVOICE},
+// Base models the server knows the languages of, variants of them found
+// under model_path are served as well
+const std::set<std::string> kServedBases = {
+    "whisper_tiny", "whisper_base", "whisper_small", "whisper_turbo",
+    "sensevoice", "paraformer",
 };
 
 const std::map<std::string, std::string> kModelAliasMap = {
@@ -52,6 +52,11 @@ const std::vector<std::string> kSenseVoiceLanguages = {
     "auto", "zh", "en", "yue", "ja", "ko",
 };
 
+// Mandarin model, English words mixed into Mandarin speech are recognized too
+const std::vector<std::string> kParaformerLanguages = {
+    "zh",
+};
+
 std::string to_lower_copy(std::string value) {
     std::transform(value.begin(), value.end(), value.begin(),
                    [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
@@ -96,62 +101,30 @@ std::string file_extension_lower(const std::string& filename) {
 }
 
 bool is_supported_audio_extension(const std::string& extension) {
-    return extension == ".wav" || extension == ".mp3";
+    if (extension == ".opus" || extension == ".ogg") {
+        return utils::OpusFileDecoder::available();
+    }
+    return extension == ".wav" || extension == ".mp3" || extension == ".flac";
 }
 
-class TempAudioFile {
-public:
-    TempAudioFile(const httplib::FormData& file, const std::string& request_id) {
-        auto extension = file_extension_lower(file.filename);
-        if (!is_supported_audio_extension(extension)) {
-            return;
-        }
-
-        std::string template_path =
-            (std::filesystem::temp_directory_path() /
-             ("ax_asr_" + request_id + "_XXXXXX" + extension))
-                .string();
-        std::vector<char> buffer(template_path.begin(), template_path.end());
-        buffer.push_back('\0');
-
-        const int fd = mkstemps(buffer.data(), static_cast<int>(extension.size()));
-        if (fd < 0) {
-            return;
-        }
-
-        path_ = buffer.data();
-        const auto* data = file.content.data();
-        size_t remaining = file.content.size();
-        while (remaining > 0) {
-            const ssize_t written = write(fd, data, remaining);
-            if (written < 0) {
-                close(fd);
-                std::remove(path_.c_str());
-                path_.clear();
-                return;
-            }
-
-            data += written;
-            remaining -= static_cast<size_t>(written);
-        }
-
-        close(fd);
-        valid_ = true;
+// Format named by the Content-Type of a multipart file part, empty if it
+// names none we decode
+std::string audio_format_from_content_type(const std::string& content_type) {
+    const std::string type = to_lower_copy(trim_copy(content_type.substr(0, content_type.find(';'))));
+    if (type == "audio/wav" || type == "audio/wave" || type == "audio/x-wav" || type == "audio/vnd.wave") {
+        return "wav";
     }
-
-    ~TempAudioFile() {
-        if (!path_.empty()) {
-            std::remove(path_.c_str());
-        }
+    if (type == "audio/mpeg" || type == "audio/mp3") {
+        return "mp3";
     }
-
-    bool valid() const { return valid_; }
-    const std::string& path() const { return path_; }
-
-private:
-    std::string path_;
-    bool valid_ = false;
-};
+    if (type == "audio/flac" || type == "audio/x-flac") {
+        return "flac";
+    }
+    if (type == "audio/ogg" || type == "audio/opus") {
+        return "opus";
+    }
+    return "";
+}
 
 bool has_bearer_prefix(const std::string& value) {
     static const std::string prefix = "Bearer ";
@@ -226,6 +199,9 @@ bool ASRServer::init(const ASRServerConfig& config) {
     }
 
     config_ = config;
+    if (!load_model_list_()) {
+        return false;
+    }
     srv_.set_payload_max_length(config_.payload_max_length);
     srv_.set_read_timeout(config_.read_timeout_sec);
     srv_.set_write_timeout(config_.write_timeout_sec);
@@ -324,12 +300,16 @@ void ASRServer::setup_routes_() {
         }
 
         json models = json::array();
-        for (const auto& entry : kModelMap) {
-            models.push_back({
+        for (const auto& entry : model_bases_) {
+            json model = {
                 {"id", entry.first},
                 {"object", "model"},
                 {"owned_by", "axera"},
-            });
+            };
+            if (entry.second != entry.first) {
+                model["root"] = entry.second;
+            }
+            models.push_back(model);
         }
 
         for (const auto& entry : kModelAliasMap) {
@@ -373,25 +353,30 @@ void ASRServer::setup_routes_() {
         const std::string request_id = create_request_id_();
         res.set_header("x-request-id", request_id);
 
-        TempAudioFile temp_file(file, request_id);
-        if (!temp_file.valid()) {
-            ErrorResponse(OPENAI_ERR_INTERNAL_SERVER_ERROR,
-                          "Failed to persist uploaded audio.",
-                          "file")
-                .to_res(res);
-            return;
-        }
+        // Decoded straight from the multipart body, check_request_ has
+        // accepted the format already
+        const std::string format = upload_audio_format_(file);
 
         char* text = nullptr;
         int ret = AX_ASR_SUCCESS;
         {
             std::lock_guard<std::mutex> guard(handle->mutex);
-            ret = AX_ASR_RunFile(handle->handle, temp_file.path().c_str(),
-                                 language.c_str(), &text);
+            ret = AX_ASR_RunBuffer(handle->handle, file.content.data(), file.content.size(),
+                                   format.c_str(), language.c_str(), &text);
+        }
+
+        if (ret == AX_ASR_ERR_AUDIO_LOAD_FAILED) {
+            ALOGE("Decode upload failed! request_id=%s", request_id.c_str());
+            ErrorResponse(OPENAI_ERR_BAD_REQUEST,
+                          "Uploaded audio cannot be decoded.",
+                          "file")
+                .to_res(res);
+            AX_ASR_Free(text);
+            return;
         }
 
         if (ret != AX_ASR_SUCCESS) {
-            ALOGE("AX_ASR_RunFile failed! ret=%d request_id=%s", ret, request_id.c_str());
+            ALOGE("AX_ASR_RunBuffer failed! ret=%d request_id=%s", ret, request_id.c_str());
             ErrorResponse(OPENAI_ERR_INTERNAL_SERVER_ERROR,
                           "Transcription failed on server side.",
                           "file")
@@ -429,14 +414,13 @@ std::shared_ptr<ASRServer::ModelInstance> ASRServer::load_asr_(const std::string
         return it->second;
     }
 
-    auto model_it = kModelMap.find(canonical_model_name);
-    if (model_it == kModelMap.end()) {
+    if (model_bases_.find(canonical_model_name) == model_bases_.end()) {
         ALOGE("Unknown model %s", canonical_model_name.c_str());
         return nullptr;
     }
 
     ALOGI("Initializing %s ...", canonical_model_name.c_str());
-    AX_ASR_HANDLE handle = AX_ASR_Init(model_it->second, config_.model_path.c_str());
+    AX_ASR_HANDLE handle = AX_ASR_InitByName(canonical_model_name.c_str(), config_.model_path.c_str());
     if (!handle) {
         ALOGE("Init asr %s failed!", canonical_model_name.c_str());
         return nullptr;
@@ -450,8 +434,8 @@ std::shared_ptr<ASRServer::ModelInstance> ASRServer::load_asr_(const std::string
 std::string ASRServer::canonical_model_name_(const std::string& requested_model_name) const {
     const auto key = to_lower_copy(trim_copy(requested_model_name));
 
-    auto model_it = kModelMap.find(key);
-    if (model_it != kModelMap.end()) {
+    auto model_it = model_bases_.find(key);
+    if (model_it != model_bases_.end()) {
         return model_it->first;
     }
 
@@ -464,15 +448,62 @@ std::string ASRServer::canonical_model_name_(const std::string& requested_model_
 }
 
 std::string ASRServer::default_language_for_model_(const std::string& canonical_model_name) const {
-    return canonical_model_name == "sensevoice" ? "auto" : "en";
+    const std::string base = base_model_(canonical_model_name);
+    if (base == "sensevoice") {
+        return "auto";
+    }
+    return base == "paraformer" ? "zh" : "en";
 }
 
-bool ASRServer::is_supported_audio_file_(const httplib::FormData& file) const {
-    if (file.filename.empty() || file.content.empty()) {
+bool ASRServer::load_model_list_() {
+    char* names = nullptr;
+    if (AX_ASR_ListModels(config_.model_path.c_str(), &names) != AX_ASR_SUCCESS) {
+        ALOGE("List models failed!");
         return false;
     }
+    const auto model_names = split_csv(names);
+    AX_ASR_Free(names);
+
+    model_bases_.clear();
+    for (const auto& name : model_names) {
+        char* base = nullptr;
+        if (AX_ASR_GetModelBase(config_.model_path.c_str(), name.c_str(), &base) != AX_ASR_SUCCESS) {
+            continue;
+        }
+        std::string base_name = base;
+        AX_ASR_Free(base);
+        if (kServedBases.count(base_name) != 0) {
+            model_bases_.emplace(name, base_name);
+        }
+    }
+    return true;
+}
 
-    return is_supported_audio_extension(file_extension_lower(file.filename));
+std::string ASRServer::base_model_(const std::string& canonical_model_name) const {
+    auto it = model_bases_.find(canonical_model_name);
+    return it != model_bases_.end() ? it->second : canonical_model_name;
+}
+
+// A known extension decides, otherwise the part's Content-Type, otherwise
+// the first bytes of the file, e.g. for a browser recording named "blob"
+std::string ASRServer::upload_audio_format_(const httplib::FormData& file) const {
+    if (file.filename.empty() || file.content.empty()) {
+        return "";
+    }
+
+    const std::string extension = file_extension_lower(file.filename);
+    if (is_supported_audio_extension(extension)) {
+        return extension.substr(1);
+    }
+
+    std::string format = audio_format_from_content_type(file.content_type);
+    if (format.empty()) {
+        format = utils::guess_audio_format(file.content.data(), file.content.size());
+    }
+    if (format == "opus" && !utils::OpusFileDecoder::available()) {
+        return "";
+    }
+    return format;
 }
 
 bool ASRServer::validate_auth_(const httplib::Request& req, httplib::Response& res) const {
@@ -541,13 +572,21 @@ bool ASRServer::supported_languages_for_model_(const std::string& canonical_mode
         return true;
     }
 
-    if (canonical_model_name == "sensevoice") {
+    // Variants recognize the same languages as their base
+    const std::string base = base_model_(canonical_model_name);
+    if (base == "sensevoice") {
         languages = kSenseVoiceLanguages;
         language_cache_.emplace(canonical_model_name, languages);
         return true;
     }
 
-    const std::string variant = whisper_variant_from_model(canonical_model_name);
+    if (base == "paraformer") {
+        languages = kParaformerLanguages;
+        language_cache_.emplace(canonical_model_name, languages);
+        return true;
+    }
+
+    const std::string variant = whisper_variant_from_model(base);
     if (variant.empty()) {
         return false;
     }
@@ -659,9 +698,11 @@ bool ASRServer::check_request_(const httplib::Request& req,
     }
 
     const auto& file = req.form.get_file("file");
-    if (!is_supported_audio_file_(file)) {
+    if (upload_audio_format_(file).empty()) {
         ErrorResponse(OPENAI_ERR_BAD_REQUEST,
-                      "Only non-empty .wav and .mp3 uploads are supported.",
+                      utils::OpusFileDecoder::available()
+                          ? "Only non-empty .wav, .mp3, .flac and .opus uploads are supported."
+                          : "Only non-empty .wav, .mp3 and .flac uploads are supported.",
                       "file")
             .to_res(res);
         return false;
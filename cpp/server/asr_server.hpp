@@ -118,10 +118,13 @@ private:
     };
 
     void setup_routes_();
+    bool load_model_list_();
+    std::string base_model_(const std::string& canonical_model_name) const;
     std::shared_ptr<ModelInstance> load_asr_(const std::string& canonical_model_name);
     std::string canonical_model_name_(const std::string& requested_model_name) const;
     std::string default_language_for_model_(const std::string& canonical_model_name) const;
-    bool is_supported_audio_file_(const httplib::FormData& file) const;
+    // "wav", "mp3", "flac", "opus" or "ogg", empty if the upload cannot be decoded
+    std::string upload_audio_format_(const httplib::FormData& file) const;
     bool validate_auth_(const httplib::Request& req, httplib::Response& res) const;
     bool validate_language_(const std::string& canonical_model_name,
                             const std::string& requested_language,
@@ -139,10 +142,14 @@ private:
      * request: Content-Type: multipart/form-data
      * {
      *      "model": "sensevoice",
-      *      "file": binary stream of audio file, supports wav and mp3.
+      *      "file": binary stream of audio file, supports wav, mp3, flac and
+      *              ogg/opus (with ENABLE_OPUS). Judged from the extension,
+      *              then the part's Content-Type, then the data.
      *      "language": optional. For whisper, defaults to en. For sensevoice, defaults to auto.
+     *                  For paraformer, defaults to zh.
      *                  For whisper, check https://whisper-api.com/docs/languages/
      *                  For sensevoice, support auto, zh, en, yue, ja, ko
+     *                  For paraformer, support zh
      * }
     */
     bool check_request_(const httplib::Request& req,
@@ -152,6 +159,8 @@ private:
                         httplib::Response& res);
 
 private:
+    // Served model names from the registry -> the built-in model they derive from
+    std::map<std::string, std::string> model_bases_;
     std::map<std::string, std::shared_ptr<ModelInstance>> handles_;
     mutable std::mutex handles_mutex_;
     mutable std::map<std::string, std::vector<std::string>> language_cache_;
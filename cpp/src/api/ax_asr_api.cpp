@@ -9,12 +9,262 @@
  **************************************************************************************************/
 #include "api/ax_asr_api.h"
 #include "asr/asr_factory.hpp"
+#include "asr/batch_pipeline.hpp"
+#include "asr/request_queue.hpp"
+#include "asr/stream_worker.hpp"
 #include "utils/logger.h"
-
-static std::string partial_copy_;
-#include "utils/AudioLoader.hpp"
+#include "utils/AudioReader.hpp"
 
 #include <string.h>
+#include <set>
+
+struct ASRContext;
+
+// What AX_ASR_STREAM_HANDLE points to
+struct ASRStreamContext {
+    ASRStreamContext(ASRContext* ctx, std::unique_ptr<ASRStream> s): owner(ctx), stream(std::move(s)) {}
+
+    ASRContext* owner;
+    std::unique_ptr<ASRStream> stream;
+    std::unique_ptr<StreamWorker> worker;
+    std::mutex worker_mutex;
+    std::string result;     // backs the pointer returned by AX_ASR_SessionResult
+    std::string final_result;   // backs the pointer returned by AX_ASR_SessionFinalResult
+};
+
+// What AX_ASR_HANDLE points to
+struct ASRContext {
+    explicit ASRContext(ASRInterface* asr): interface(asr) {}
+
+    std::unique_ptr<ASRInterface> interface;
+    // Session behind the handle level AX_ASR_Stream* API, null if the model cannot stream
+    std::unique_ptr<ASRStreamContext> default_stream;
+    // Sessions from AX_ASR_StreamCreate, released by Uninit if the caller forgot
+    std::set<ASRStreamContext*> streams;
+    std::mutex streams_mutex;
+    // Workers of AX_ASR_Submit, started by the first request
+    std::unique_ptr<RequestQueue> requests;
+    std::mutex requests_mutex;
+};
+
+static ASRStreamContext* create_stream_context(ASRContext* context) {
+    auto stream = context->interface->create_stream();
+    if (!stream)
+        return nullptr;
+    return new ASRStreamContext(context, std::move(stream));
+}
+
+static int session_feed(ASRStreamContext* session, const float* pcm_data, int num_samples, int sample_rate) {
+    {
+        // Lock is only contended by Start/StopAsync, never by inference
+        std::lock_guard<std::mutex> lock(session->worker_mutex);
+        if (session->worker)
+            return session->worker->push(pcm_data, num_samples, sample_rate);
+    }
+    session->stream->feed(pcm_data, num_samples, sample_rate);
+    return AX_ASR_SUCCESS;
+}
+
+static int session_feed_s16(ASRStreamContext* session, const int16_t* pcm_data, int num_samples, int sample_rate) {
+    {
+        std::lock_guard<std::mutex> lock(session->worker_mutex);
+        if (session->worker)
+            return session->worker->push_s16(pcm_data, num_samples, sample_rate);
+    }
+    session->stream->feed_s16(pcm_data, num_samples, sample_rate);
+    return AX_ASR_SUCCESS;
+}
+
+static int session_result(ASRStreamContext* session, const char** result) {
+    if (!session->stream->result(session->result)) {
+        *result = nullptr;
+        return AX_ASR_ERR_STREAM_NOT_SUPPORTED;
+    }
+    *result = session->result.c_str();
+    return AX_ASR_SUCCESS;
+}
+
+// The worker feeds the stream from its own thread, so reset and
+// reconfiguration are only allowed while it is stopped
+static int session_reset(ASRStreamContext* session) {
+    std::lock_guard<std::mutex> lock(session->worker_mutex);
+    if (session->worker) {
+        ALOGE("Stop async streaming before reset!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+    session->stream->reset();
+    return AX_ASR_SUCCESS;
+}
+
+static int session_set_endpoint(ASRStreamContext* session, const AX_ASR_ENDPOINT_CONFIG_T* config) {
+    std::lock_guard<std::mutex> lock(session->worker_mutex);
+    if (session->worker) {
+        ALOGE("Stop async streaming before changing the endpoint config!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+    session->stream->set_endpoint(*config);
+    return AX_ASR_SUCCESS;
+}
+
+static int session_final_result(ASRStreamContext* session, const char** result) {
+    if (!session->stream->pop_final(session->final_result)) {
+        *result = nullptr;
+        return AX_ASR_SUCCESS;
+    }
+    *result = session->final_result.c_str();
+    return AX_ASR_SUCCESS;
+}
+
+static int session_start_async(ASRStreamContext* session, const AX_ASR_STREAM_ASYNC_CONFIG_T* config) {
+    std::lock_guard<std::mutex> lock(session->worker_mutex);
+    if (session->worker) {
+        ALOGE("Async streaming already started!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    auto worker = std::make_unique<StreamWorker>(session->stream.get(), *config);
+    if (!worker->start()) {
+        return AX_ASR_ERR_RUN_FAILED;
+    }
+    session->worker = std::move(worker);
+    return AX_ASR_SUCCESS;
+}
+
+static int session_stop_async(ASRStreamContext* session) {
+    std::unique_ptr<StreamWorker> worker;
+    {
+        std::lock_guard<std::mutex> lock(session->worker_mutex);
+        worker = std::move(session->worker);
+    }
+    if (!worker) return AX_ASR_ERR_INVALID_ARGUMENT;
+
+    worker->stop();
+    return AX_ASR_SUCCESS;
+}
+
+// Shared tail of AX_ASR_RunFile, AX_ASR_RunFileSegments and AX_ASR_RunBuffer,
+// result may be NULL
+static int run_reader(ASRInterface* interface, utils::AudioReader& reader, const char* language, char** result,
+                      const ASRSegmentCallback& on_segment = ASRSegmentCallback()) {
+    std::string text_result;
+    if (!interface->run_reader(reader, std::string(language), text_result, on_segment)) {
+        if (reader.failed()) {
+            ALOGE("Read audio failed!");
+            return AX_ASR_ERR_AUDIO_LOAD_FAILED;
+        }
+        ALOGE("Run failed!");
+        return AX_ASR_ERR_RUN_FAILED;
+    }
+
+    if (!result)
+        return AX_ASR_SUCCESS;
+    *result = strdup(text_result.c_str());
+    if (!*result) {
+        ALOGE("strdup result failed!");
+        return AX_ASR_ERR_NO_MEMORY;
+    }
+
+    return AX_ASR_SUCCESS;
+}
+
+// Whole file at native_rate, for the batch and async paths where each file
+// is already on a thread of its own
+static int load_file(const char* path, int native_rate, std::vector<float>& audio) {
+    utils::AudioReader reader;
+    reader.set_decode_threads(1);
+    if (!reader.open(path, native_rate) || !reader.read_all(audio) || audio.empty()) {
+        ALOGE("Load %s failed!", path);
+        return AX_ASR_ERR_AUDIO_LOAD_FAILED;
+    }
+    return AX_ASR_SUCCESS;
+}
+
+static RequestQueue* get_request_queue(ASRContext* context, bool create) {
+    std::lock_guard<std::mutex> lock(context->requests_mutex);
+    if (!context->requests && create) {
+        auto queue = std::make_unique<RequestQueue>(context->interface.get());
+        if (!queue->start())
+            return nullptr;
+        context->requests = std::move(queue);
+    }
+    return context->requests.get();
+}
+
+// Loader of one AX_ASR_Submit request, owning a copy of its input
+static int make_request_loader(const AX_ASR_REQUEST_T* request, int native_rate, RequestLoader& load) {
+    switch (request->type) {
+    case AX_ASR_INPUT_FILE: {
+        if (!request->file) {
+            ALOGE("file is NULL!");
+            return AX_ASR_ERR_INVALID_ARGUMENT;
+        }
+        std::string path(request->file);
+        load = [path, native_rate](std::vector<float>& audio) {
+            return load_file(path.c_str(), native_rate, audio);
+        };
+        return AX_ASR_SUCCESS;
+    }
+    case AX_ASR_INPUT_BUFFER: {
+        if (!request->data || request->size == 0) {
+            ALOGE("Empty audio buffer!");
+            return AX_ASR_ERR_INVALID_ARGUMENT;
+        }
+        auto data = std::make_shared<std::string>(static_cast<const char*>(request->data), request->size);
+        std::string format(request->format ? request->format : "");
+        load = [data, format, native_rate](std::vector<float>& audio) {
+            utils::AudioReader reader;
+            reader.set_decode_threads(1);
+            if (!reader.open_memory(data->data(), data->size(), format, native_rate)
+                || !reader.read_all(audio) || audio.empty()) {
+                ALOGE("Load audio buffer failed!");
+                return (int)AX_ASR_ERR_AUDIO_LOAD_FAILED;
+            }
+            return (int)AX_ASR_SUCCESS;
+        };
+        return AX_ASR_SUCCESS;
+    }
+    case AX_ASR_INPUT_PCM:
+    case AX_ASR_INPUT_PCM_S16:
+        if (!request->data || request->size == 0 || request->sample_rate <= 0) {
+            ALOGE("Empty PCM or sample_rate(%d) not positive!", request->sample_rate);
+            return AX_ASR_ERR_INVALID_ARGUMENT;
+        }
+        break;
+    default:
+        ALOGE("Unknown input type %d!", (int)request->type);
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    const int sample_rate = request->sample_rate;
+    if (request->type == AX_ASR_INPUT_PCM_S16) {
+        auto pcm = static_cast<const int16_t*>(request->data);
+        auto copy = std::make_shared<std::vector<int16_t>>(pcm, pcm + request->size);
+        load = [copy, sample_rate, native_rate](std::vector<float>& audio) {
+            utils::resample_s16(copy->data(), copy->size(), sample_rate, native_rate, audio);
+            return (int)AX_ASR_SUCCESS;
+        };
+        return AX_ASR_SUCCESS;
+    }
+
+    auto pcm = static_cast<const float*>(request->data);
+    auto copy = std::make_shared<std::vector<float>>(pcm, pcm + request->size);
+    load = [copy, sample_rate, native_rate](std::vector<float>& audio) {
+        // The copy is only loaded once, at the native rate it is the buffer
+        if (sample_rate == native_rate) {
+            audio.swap(*copy);
+        } else {
+            utils::resample(copy->data(), copy->size(), sample_rate, native_rate, audio);
+        }
+        return (int)AX_ASR_SUCCESS;
+    };
+    return AX_ASR_SUCCESS;
+}
+
+static AX_ASR_HANDLE create_context(ASRInterface* interface) {
+    auto context = new ASRContext(interface);
+    context->default_stream.reset(create_stream_context(context));
+    return static_cast<AX_ASR_HANDLE>(context);
+}
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,13 +297,76 @@ AX_ASR_API AX_ASR_HANDLE AX_ASR_Init(AX_ASR_TYPE_E asr_type, const char* model_p
         return NULL;
     }
 
-    ASRInterface* handle = ASRFactory::create(asr_type, std::string(model_path));
-    if (!handle) {
+    ASRInterface* interface = ASRFactory::create(asr_type, std::string(model_path));
+    if (!interface) {
         ALOGE("Create asr failed!");
         return NULL;
     }
 
-    return static_cast<AX_ASR_HANDLE>(handle);
+    return create_context(interface);
+}
+
+AX_ASR_API AX_ASR_HANDLE AX_ASR_InitByName(const char* model_name, const char* model_path) {
+    if (!model_name || !model_path) {
+        ALOGE("model_name or model_path is NULL!");
+        return NULL;
+    }
+
+    ASRInterface* interface = ASRFactory::create(std::string(model_name), std::string(model_path));
+    if (!interface) {
+        ALOGE("Create asr %s failed!", model_name);
+        return NULL;
+    }
+
+    return create_context(interface);
+}
+
+AX_ASR_API int AX_ASR_ListModels(const char* model_path, char** names) {
+    if (!names) {
+        ALOGE("names is NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    auto& registry = ASRRegistry::instance();
+    if (model_path)
+        registry.scan(model_path);
+
+    std::string joined;
+    for (auto& name : registry.names()) {
+        if (!joined.empty())
+            joined += ",";
+        joined += name;
+    }
+
+    *names = strdup(joined.c_str());
+    if (!*names) {
+        ALOGE("strdup names failed!");
+        return AX_ASR_ERR_NO_MEMORY;
+    }
+    return AX_ASR_SUCCESS;
+}
+
+AX_ASR_API int AX_ASR_GetModelBase(const char* model_path, const char* model_name, char** base) {
+    if (!model_name || !base) {
+        ALOGE("model_name or base is NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    auto& registry = ASRRegistry::instance();
+    ASRModelInfo info;
+    if (!registry.find(model_name, info)) {
+        if (model_path)
+            registry.scan(model_path);
+        if (!registry.find(model_name, info))
+            return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    *base = strdup(info.base.c_str());
+    if (!*base) {
+        ALOGE("strdup base failed!");
+        return AX_ASR_ERR_NO_MEMORY;
+    }
+    return AX_ASR_SUCCESS;
 }
 
 /**
@@ -69,9 +382,21 @@ AX_ASR_API AX_ASR_HANDLE AX_ASR_Init(AX_ASR_TYPE_E asr_type, const char* model_p
  */
 AX_ASR_API void AX_ASR_Uninit(AX_ASR_HANDLE handle) {
     if (handle) {
-        auto interface = static_cast<ASRInterface*>(handle);
-        interface->uninit();
-        delete interface;
+        auto context = static_cast<ASRContext*>(handle);
+        // Outstanding requests complete as cancelled before the model goes
+        context->requests.reset();
+        // sessions and their workers must be gone before the model they run
+        {
+            std::lock_guard<std::mutex> lock(context->streams_mutex);
+            if (!context->streams.empty())
+                ALOGW("%zu stream(s) not destroyed before Uninit", context->streams.size());
+            for (auto session : context->streams)
+                delete session;
+            context->streams.clear();
+        }
+        context->default_stream.reset();
+        context->interface->uninit();
+        delete context;
     }
 }
 
@@ -88,7 +413,7 @@ AX_ASR_API void AX_ASR_Uninit(AX_ASR_HANDLE handle) {
  * @return int Status code (0 = success, <0 = error)
  * 
  * @note The returned string is allocated with malloc() and must be freed
- *       by the caller using free() when no longer needed.
+ *       by the caller using AX_ASR_Free() when no longer needed.
  */
 AX_ASR_API int AX_ASR_RunFile(AX_ASR_HANDLE handle, 
                    const char* wav_file, 
@@ -116,19 +441,72 @@ AX_ASR_API int AX_ASR_RunFile(AX_ASR_HANDLE handle,
 
     *result = nullptr;
 
-    utils::AudioLoader audio_loader;
-    auto interface = static_cast<ASRInterface*>(handle);
+    // Decoded block by block, models that support it recognize in bounded
+    // windows so long files do not have to fit in memory
+    utils::AudioReader reader;
+    auto interface = static_cast<ASRContext*>(handle)->interface.get();
 
-    if (!audio_loader.load(wav_file, interface->sample_rate())) {
+    if (!reader.open(wav_file, interface->sample_rate())) {
         ALOGE("load wav failed!\n");
         return AX_ASR_ERR_AUDIO_LOAD_FAILED;
     }
 
-    auto& samples = audio_loader.samples;
-    int n_samples = samples.size();
-    int sample_rate = audio_loader.get_sample_rate();
-    
-    return AX_ASR_RunPCM(handle, samples.data(), n_samples, sample_rate, language, result);
+    return run_reader(interface, reader, language, result);
+}
+
+AX_ASR_API int AX_ASR_RunFileSegments(AX_ASR_HANDLE handle,
+                   const char* wav_file,
+                   const char* language,
+                   AX_ASR_SEGMENT_CALLBACK callback,
+                   void* user_data,
+                   char** result) {
+    if (!handle || !wav_file || !language) {
+        ALOGE("handle, wav_file or language is NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    if (result)
+        *result = nullptr;
+
+    utils::AudioReader reader;
+    auto interface = static_cast<ASRContext*>(handle)->interface.get();
+
+    if (!reader.open(wav_file, interface->sample_rate())) {
+        ALOGE("load %s failed!", wav_file);
+        return AX_ASR_ERR_AUDIO_LOAD_FAILED;
+    }
+
+    ASRSegmentCallback on_segment;
+    if (callback) {
+        on_segment = [callback, user_data](const ASRFinalResult& segment) {
+            callback(segment.text.c_str(), segment.start_ms, segment.end_ms, user_data);
+        };
+    }
+    return run_reader(interface, reader, language, result, on_segment);
+}
+
+AX_ASR_API int AX_ASR_RunBuffer(AX_ASR_HANDLE handle,
+                   const void* data,
+                   size_t size,
+                   const char* format,
+                   const char* language,
+                   char** result) {
+    if (!handle || !data || !language || !result) {
+        ALOGE("handle, data, language or result is NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    *result = nullptr;
+
+    utils::AudioReader reader;
+    auto interface = static_cast<ASRContext*>(handle)->interface.get();
+
+    if (!reader.open_memory(data, size, format ? format : "", interface->sample_rate())) {
+        ALOGE("load audio buffer failed!");
+        return AX_ASR_ERR_AUDIO_LOAD_FAILED;
+    }
+
+    return run_reader(interface, reader, language, result);
 }
 
 /**
@@ -147,10 +525,10 @@ AX_ASR_API int AX_ASR_RunFile(AX_ASR_HANDLE handle,
  * @return int Status code (0 = success, <0 = error)
  * 
  * @note The returned string is allocated with malloc() and must be freed
- *       by the caller using free() when no longer needed.
+ *       by the caller using AX_ASR_Free() when no longer needed.
  */
 AX_ASR_API int AX_ASR_RunPCM(AX_ASR_HANDLE handle, 
-                   float* pcm_data, 
+                   const float* pcm_data, 
                    int num_samples,
                    int sample_rate,
                    const char* language,
@@ -187,11 +565,11 @@ AX_ASR_API int AX_ASR_RunPCM(AX_ASR_HANDLE handle,
 
     *result = nullptr;
 
-    auto interface = static_cast<ASRInterface*>(handle);
-    std::vector<float> audio_data(pcm_data, pcm_data + num_samples);    
+    auto interface = static_cast<ASRContext*>(handle)->interface.get();
     std::string text_result;
-    
-    if (!interface->run(audio_data, sample_rate, std::string(language), text_result)) {
+
+    // pcm_data goes straight into the one buffer the model works on
+    if (!interface->run_pcm(pcm_data, num_samples, sample_rate, std::string(language), text_result)) {
         ALOGE("RunPCM failed!");
         return AX_ASR_ERR_RUN_FAILED;
     }
@@ -205,45 +583,488 @@ AX_ASR_API int AX_ASR_RunPCM(AX_ASR_HANDLE handle,
     return AX_ASR_SUCCESS;
 }
 
+AX_ASR_API int AX_ASR_RunPCM_S16(AX_ASR_HANDLE handle,
+                   const int16_t* pcm_data,
+                   int num_samples,
+                   int sample_rate,
+                   const char* language,
+                   char** result) {
+    if (!handle || !pcm_data || !language || !result) {
+        ALOGE("handle, pcm_data, language and result must not be NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    if (num_samples <= 0 || sample_rate <= 0) {
+        ALOGE("num_samples(%d) and sample_rate(%d) must be positive!", num_samples, sample_rate);
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    *result = nullptr;
+
+    auto interface = static_cast<ASRContext*>(handle)->interface.get();
+    std::string text_result;
+    if (!interface->run_pcm_s16(pcm_data, num_samples, sample_rate, std::string(language), text_result)) {
+        ALOGE("RunPCM_S16 failed!");
+        return AX_ASR_ERR_RUN_FAILED;
+    }
+
+    *result = strdup(text_result.c_str());
+    if (!*result) {
+        ALOGE("strdup result failed!");
+        return AX_ASR_ERR_NO_MEMORY;
+    }
+
+    return AX_ASR_SUCCESS;
+}
+
+AX_ASR_API int AX_ASR_RunPCMBatch(AX_ASR_HANDLE handle,
+                   const float* const* pcm_list,
+                   const int* num_samples,
+                   int count,
+                   int sample_rate,
+                   const char* language,
+                   char** results) {
+    if (!handle) {
+        ALOGE("handle is NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    if (!pcm_list || !num_samples || !results) {
+        ALOGE("pcm_list, num_samples and results must not be NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    if (count <= 0) {
+        ALOGE("count(%d) must be positive!", count);
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    if (sample_rate <= 0) {
+        ALOGE("sample_rate(%d) must be positive!", sample_rate);
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    if (!language) {
+        ALOGE("language is NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    for (int i = 0; i < count; i++) {
+        results[i] = nullptr;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (!pcm_list[i] || num_samples[i] <= 0) {
+            ALOGE("Utterance %d is empty!", i);
+            return AX_ASR_ERR_INVALID_ARGUMENT;
+        }
+    }
+
+    auto interface = static_cast<ASRContext*>(handle)->interface.get();
+    const int native_rate = interface->sample_rate();
+    std::vector<int> status;
+    std::vector<std::string> text_results;
+    BatchPipeline pipeline(interface);
+    pipeline.run(count, [&](size_t i, std::vector<float>& audio) {
+        utils::resample(pcm_list[i], num_samples[i], sample_rate, native_rate, audio);
+        return (int)AX_ASR_SUCCESS;
+    }, std::string(language), status, text_results);
+
+    for (int i = 0; i < count; i++) {
+        if (status[i] != AX_ASR_SUCCESS) {
+            ALOGE("RunPCMBatch failed!");
+            return status[i];
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        results[i] = strdup(text_results[i].c_str());
+        if (!results[i]) {
+            ALOGE("strdup result failed!");
+            for (int j = 0; j < i; j++) {
+                free(results[j]);
+                results[j] = nullptr;
+            }
+            return AX_ASR_ERR_NO_MEMORY;
+        }
+    }
+
+    return AX_ASR_SUCCESS;
+}
+
+AX_ASR_API int AX_ASR_RunBatch(AX_ASR_HANDLE handle,
+                   const char* const* files,
+                   int count,
+                   const char* language,
+                   char** results) {
+    if (!handle || !files || !language || !results) {
+        ALOGE("handle, files, language and results must not be NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    if (count <= 0) {
+        ALOGE("count(%d) must be positive!", count);
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    for (int i = 0; i < count; i++) {
+        results[i] = nullptr;
+    }
+
+    auto interface = static_cast<ASRContext*>(handle)->interface.get();
+    const int native_rate = interface->sample_rate();
+    std::vector<int> status;
+    std::vector<std::string> text_results;
+    BatchPipeline pipeline(interface);
+    pipeline.run(count, [&](size_t i, std::vector<float>& audio) {
+        if (!files[i]) {
+            ALOGE("File %zu is NULL!", i);
+            return (int)AX_ASR_ERR_INVALID_ARGUMENT;
+        }
+        return load_file(files[i], native_rate, audio);
+    }, std::string(language), status, text_results);
+
+    int ret = AX_ASR_SUCCESS;
+    for (int i = 0; i < count; i++) {
+        if (status[i] != AX_ASR_SUCCESS) {
+            if (ret == AX_ASR_SUCCESS)
+                ret = status[i];
+            continue;
+        }
+        results[i] = strdup(text_results[i].c_str());
+        if (!results[i] && ret == AX_ASR_SUCCESS) {
+            ALOGE("strdup result failed!");
+            ret = AX_ASR_ERR_NO_MEMORY;
+        }
+    }
+    return ret;
+}
+
+AX_ASR_API int64_t AX_ASR_Submit(AX_ASR_HANDLE handle,
+                   const AX_ASR_REQUEST_T* request,
+                   AX_ASR_REQUEST_CALLBACK callback,
+                   void* user_data) {
+    if (!handle || !request || !request->language) {
+        ALOGE("handle, request or language is NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    auto context = static_cast<ASRContext*>(handle);
+    RequestLoader load;
+    int ret = make_request_loader(request, context->interface->sample_rate(), load);
+    if (ret != AX_ASR_SUCCESS)
+        return ret;
+
+    RequestDone done;
+    if (callback) {
+        done = [callback](const ASRCompletion& completion) {
+            AX_ASR_COMPLETION_T out;
+            out.request_id = completion.id;
+            out.status = completion.status;
+            out.result = completion.status == AX_ASR_SUCCESS ? const_cast<char*>(completion.text.c_str()) : nullptr;
+            out.user_data = completion.user_data;
+            callback(&out, completion.user_data);
+        };
+    }
+
+    auto queue = get_request_queue(context, true);
+    if (!queue)
+        return AX_ASR_ERR_RUN_FAILED;
+    int64_t id = queue->submit(std::move(load), std::string(request->language), std::move(done), user_data);
+    return id > 0 ? id : (int64_t)AX_ASR_ERR_RUN_FAILED;
+}
+
+AX_ASR_API int AX_ASR_Poll(AX_ASR_HANDLE handle, AX_ASR_COMPLETION_T* completion) {
+    return AX_ASR_Wait(handle, completion, 0);
+}
+
+AX_ASR_API int AX_ASR_Wait(AX_ASR_HANDLE handle, AX_ASR_COMPLETION_T* completion, int timeout_ms) {
+    if (!handle || !completion) {
+        ALOGE("handle or completion is NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    auto queue = get_request_queue(static_cast<ASRContext*>(handle), false);
+    ASRCompletion done;
+    if (!queue || !queue->wait(done, timeout_ms))
+        return AX_ASR_ERR_NOT_READY;
+
+    completion->request_id = done.id;
+    completion->status = done.status;
+    completion->result = nullptr;
+    completion->user_data = done.user_data;
+    if (done.status == AX_ASR_SUCCESS) {
+        completion->result = strdup(done.text.c_str());
+        if (!completion->result) {
+            ALOGE("strdup result failed!");
+            completion->status = AX_ASR_ERR_NO_MEMORY;
+        }
+    }
+    return AX_ASR_SUCCESS;
+}
+
+AX_ASR_API int AX_ASR_Cancel(AX_ASR_HANDLE handle, int64_t request_id) {
+    if (!handle) {
+        ALOGE("handle is NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    auto queue = get_request_queue(static_cast<ASRContext*>(handle), false);
+    if (!queue || !queue->cancel(request_id))
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    return AX_ASR_SUCCESS;
+}
+
+// The result, both timestamp arrays and all strings live in one malloc()
+// block so AX_ASR_FreeDetailed is a single free()
+static AX_ASR_DETAILED_RESULT_T* pack_detailed_result(const ASRResult& res) {
+    size_t bytes = sizeof(AX_ASR_DETAILED_RESULT_T)
+        + (res.tokens.size() + res.words.size()) * sizeof(AX_ASR_TIMESTAMP_T)
+        + res.text.size() + 1;
+    for (auto& ts : res.tokens) bytes += ts.text.size() + 1;
+    for (auto& ts : res.words) bytes += ts.text.size() + 1;
+
+    char* block = static_cast<char*>(malloc(bytes));
+    if (!block)
+        return nullptr;
+
+    auto out = reinterpret_cast<AX_ASR_DETAILED_RESULT_T*>(block);
+    auto stamps = reinterpret_cast<AX_ASR_TIMESTAMP_T*>(block + sizeof(AX_ASR_DETAILED_RESULT_T));
+    char* strings = reinterpret_cast<char*>(stamps + res.tokens.size() + res.words.size());
+
+    auto put_string = [&strings](const std::string& str) {
+        const char* p = strings;
+        memcpy(strings, str.c_str(), str.size() + 1);
+        strings += str.size() + 1;
+        return p;
+    };
+    auto put_stamps = [&](const std::vector<ASRTimestamp>& src, AX_ASR_TIMESTAMP_T* dst) {
+        for (size_t i = 0; i < src.size(); i++) {
+            dst[i].text = put_string(src[i].text);
+            dst[i].start_ms = src[i].start_ms;
+            dst[i].end_ms = src[i].end_ms;
+        }
+    };
+
+    out->text = put_string(res.text);
+    out->num_tokens = res.tokens.size();
+    out->tokens = res.tokens.empty() ? nullptr : stamps;
+    put_stamps(res.tokens, stamps);
+    out->num_words = res.words.size();
+    out->words = res.words.empty() ? nullptr : stamps + res.tokens.size();
+    put_stamps(res.words, stamps + res.tokens.size());
+    return out;
+}
+
+AX_ASR_API int AX_ASR_RunPCMDetailed(AX_ASR_HANDLE handle,
+                   const float* pcm_data,
+                   int num_samples,
+                   int sample_rate,
+                   const char* language,
+                   AX_ASR_DETAILED_RESULT_T** result) {
+    if (!handle || !pcm_data || !language || !result) {
+        ALOGE("handle, pcm_data, language and result must not be NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    if (num_samples <= 0 || sample_rate <= 0) {
+        ALOGE("num_samples(%d) and sample_rate(%d) must be positive!", num_samples, sample_rate);
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    *result = nullptr;
+
+    auto interface = static_cast<ASRContext*>(handle)->interface.get();
+    ASRResult res;
+    if (!interface->run_pcm_detailed(pcm_data, num_samples, sample_rate, std::string(language), res)) {
+        ALOGE("RunPCMDetailed failed!");
+        return AX_ASR_ERR_RUN_FAILED;
+    }
+
+    *result = pack_detailed_result(res);
+    if (!*result) {
+        ALOGE("Allocate detailed result failed!");
+        return AX_ASR_ERR_NO_MEMORY;
+    }
+    return AX_ASR_SUCCESS;
+}
+
+AX_ASR_API void AX_ASR_FreeDetailed(AX_ASR_DETAILED_RESULT_T* result) {
+    free(result);
+}
+
+AX_ASR_API int AX_ASR_SetParam(AX_ASR_HANDLE handle, const char* key, const char* value) {
+    if (!handle || !key || !value) {
+        ALOGE("handle, key and value must not be NULL!");
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    }
+
+    auto interface = static_cast<ASRContext*>(handle)->interface.get();
+    if (!interface->set_param(key, value))
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    return AX_ASR_SUCCESS;
+}
+
 AX_ASR_API void AX_ASR_Free(char* result) {
     free(result);
 }
 
+// Handle level streaming API, a thin wrapper over the default session.
+// Init/Feed/Reset are no-ops on models that cannot stream.
+
 AX_ASR_API int AX_ASR_StreamInit(AX_ASR_HANDLE handle) {
     if (!handle) return AX_ASR_ERR_INVALID_ARGUMENT;
-    auto interface = static_cast<ASRInterface*>(handle);
-    interface->stream_init();
+    auto session = static_cast<ASRContext*>(handle)->default_stream.get();
+    if (session)
+        return session_reset(session);
     return AX_ASR_SUCCESS;
 }
 
 AX_ASR_API int AX_ASR_StreamFeed(AX_ASR_HANDLE handle,
-    float* pcm_data, int num_samples, int sample_rate) {
+    const float* pcm_data, int num_samples, int sample_rate) {
     if (!handle || !pcm_data || num_samples <= 0 || sample_rate <= 0)
         return AX_ASR_ERR_INVALID_ARGUMENT;
-    auto interface = static_cast<ASRInterface*>(handle);
-    std::vector<float> chunk(pcm_data, pcm_data + num_samples);
-    interface->stream_feed(chunk, sample_rate);
-    return AX_ASR_SUCCESS;
+    auto session = static_cast<ASRContext*>(handle)->default_stream.get();
+    if (!session)
+        return AX_ASR_SUCCESS;
+    return session_feed(session, pcm_data, num_samples, sample_rate);
+}
+
+AX_ASR_API int AX_ASR_StreamFeed_S16(AX_ASR_HANDLE handle,
+    const int16_t* pcm_data, int num_samples, int sample_rate) {
+    if (!handle || !pcm_data || num_samples <= 0 || sample_rate <= 0)
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    auto session = static_cast<ASRContext*>(handle)->default_stream.get();
+    if (!session)
+        return AX_ASR_SUCCESS;
+    return session_feed_s16(session, pcm_data, num_samples, sample_rate);
 }
 
 AX_ASR_API int AX_ASR_StreamResult(AX_ASR_HANDLE handle, const char** result) {
     if (!handle || !result) return AX_ASR_ERR_INVALID_ARGUMENT;
-    auto interface = static_cast<ASRInterface*>(handle);
-    static thread_local std::string partial;
-    if (!interface->stream_result(partial)) {
+    auto session = static_cast<ASRContext*>(handle)->default_stream.get();
+    if (!session) {
         *result = nullptr;
         return AX_ASR_ERR_STREAM_NOT_SUPPORTED;
     }
-    partial_copy_ = partial;  // stable pointer
-    *result = partial_copy_.c_str();
-    return AX_ASR_SUCCESS;
+    return session_result(session, result);
 }
 
 AX_ASR_API int AX_ASR_StreamReset(AX_ASR_HANDLE handle) {
+    return AX_ASR_StreamInit(handle);
+}
+
+AX_ASR_API int AX_ASR_StreamStartAsync(AX_ASR_HANDLE handle, const AX_ASR_STREAM_ASYNC_CONFIG_T* config) {
+    if (!handle || !config) return AX_ASR_ERR_INVALID_ARGUMENT;
+    auto session = static_cast<ASRContext*>(handle)->default_stream.get();
+    if (!session) {
+        ALOGE("Streaming is not supported by this model!");
+        return AX_ASR_ERR_STREAM_NOT_SUPPORTED;
+    }
+    return session_start_async(session, config);
+}
+
+AX_ASR_API int AX_ASR_StreamStopAsync(AX_ASR_HANDLE handle) {
     if (!handle) return AX_ASR_ERR_INVALID_ARGUMENT;
-    auto interface = static_cast<ASRInterface*>(handle);
-    interface->stream_reset();
-    return AX_ASR_SUCCESS;
+    auto session = static_cast<ASRContext*>(handle)->default_stream.get();
+    if (!session) return AX_ASR_ERR_INVALID_ARGUMENT;
+    return session_stop_async(session);
+}
+
+AX_ASR_API int AX_ASR_StreamSetEndpoint(AX_ASR_HANDLE handle, const AX_ASR_ENDPOINT_CONFIG_T* config) {
+    if (!handle || !config) return AX_ASR_ERR_INVALID_ARGUMENT;
+    auto session = static_cast<ASRContext*>(handle)->default_stream.get();
+    if (!session) return AX_ASR_ERR_STREAM_NOT_SUPPORTED;
+    return session_set_endpoint(session, config);
+}
+
+AX_ASR_API int AX_ASR_StreamFinalResult(AX_ASR_HANDLE handle, const char** result) {
+    if (!handle || !result) return AX_ASR_ERR_INVALID_ARGUMENT;
+    auto session = static_cast<ASRContext*>(handle)->default_stream.get();
+    if (!session) {
+        *result = nullptr;
+        return AX_ASR_ERR_STREAM_NOT_SUPPORTED;
+    }
+    return session_final_result(session, result);
+}
+
+AX_ASR_API AX_ASR_STREAM_HANDLE AX_ASR_StreamCreate(AX_ASR_HANDLE handle) {
+    if (!handle) {
+        ALOGE("handle is NULL!");
+        return NULL;
+    }
+
+    auto context = static_cast<ASRContext*>(handle);
+    auto session = create_stream_context(context);
+    if (!session) {
+        ALOGE("Streaming is not supported by this model!");
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(context->streams_mutex);
+    context->streams.insert(session);
+    return static_cast<AX_ASR_STREAM_HANDLE>(session);
+}
+
+AX_ASR_API void AX_ASR_StreamDestroy(AX_ASR_STREAM_HANDLE stream) {
+    if (!stream)
+        return;
+
+    auto session = static_cast<ASRStreamContext*>(stream);
+    auto context = session->owner;
+    {
+        std::lock_guard<std::mutex> lock(context->streams_mutex);
+        if (context->streams.erase(session) == 0) {
+            ALOGE("Unknown stream %p", stream);
+            return;
+        }
+    }
+    // ~StreamWorker stops a running worker
+    delete session;
+}
+
+AX_ASR_API int AX_ASR_SessionFeed(AX_ASR_STREAM_HANDLE stream,
+    const float* pcm_data, int num_samples, int sample_rate) {
+    if (!stream || !pcm_data || num_samples <= 0 || sample_rate <= 0)
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    return session_feed(static_cast<ASRStreamContext*>(stream), pcm_data, num_samples, sample_rate);
+}
+
+AX_ASR_API int AX_ASR_SessionFeed_S16(AX_ASR_STREAM_HANDLE stream,
+    const int16_t* pcm_data, int num_samples, int sample_rate) {
+    if (!stream || !pcm_data || num_samples <= 0 || sample_rate <= 0)
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+    return session_feed_s16(static_cast<ASRStreamContext*>(stream), pcm_data, num_samples, sample_rate);
+}
+
+AX_ASR_API int AX_ASR_SessionResult(AX_ASR_STREAM_HANDLE stream, const char** result) {
+    if (!stream || !result) return AX_ASR_ERR_INVALID_ARGUMENT;
+    return session_result(static_cast<ASRStreamContext*>(stream), result);
+}
+
+AX_ASR_API int AX_ASR_SessionReset(AX_ASR_STREAM_HANDLE stream) {
+    if (!stream) return AX_ASR_ERR_INVALID_ARGUMENT;
+    return session_reset(static_cast<ASRStreamContext*>(stream));
+}
+
+AX_ASR_API int AX_ASR_SessionStartAsync(AX_ASR_STREAM_HANDLE stream, const AX_ASR_STREAM_ASYNC_CONFIG_T* config) {
+    if (!stream || !config) return AX_ASR_ERR_INVALID_ARGUMENT;
+    return session_start_async(static_cast<ASRStreamContext*>(stream), config);
+}
+
+AX_ASR_API int AX_ASR_SessionStopAsync(AX_ASR_STREAM_HANDLE stream) {
+    if (!stream) return AX_ASR_ERR_INVALID_ARGUMENT;
+    return session_stop_async(static_cast<ASRStreamContext*>(stream));
+}
+
+AX_ASR_API int AX_ASR_SessionSetEndpoint(AX_ASR_STREAM_HANDLE stream, const AX_ASR_ENDPOINT_CONFIG_T* config) {
+    if (!stream || !config) return AX_ASR_ERR_INVALID_ARGUMENT;
+    return session_set_endpoint(static_cast<ASRStreamContext*>(stream), config);
+}
+
+AX_ASR_API int AX_ASR_SessionFinalResult(AX_ASR_STREAM_HANDLE stream, const char** result) {
+    if (!stream || !result) return AX_ASR_ERR_INVALID_ARGUMENT;
+    return session_final_result(static_cast<ASRStreamContext*>(stream), result);
 }
 
 #ifdef __cplusplus
@@ -10,6 +10,9 @@
 #ifndef _AX_ASR_API_H_
 #define _AX_ASR_API_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -23,7 +26,10 @@ enum AX_ASR_STATUS_E {
     AX_ASR_ERR_AUDIO_LOAD_FAILED = -3,
     AX_ASR_ERR_RUN_FAILED = -4,
     AX_ASR_ERR_NO_MEMORY = -5,
-    AX_ASR_ERR_STREAM_NOT_SUPPORTED = -6
+    AX_ASR_ERR_STREAM_NOT_SUPPORTED = -6,
+    AX_ASR_ERR_QUEUE_FULL = -7,
+    AX_ASR_ERR_NOT_READY = -8,
+    AX_ASR_ERR_CANCELLED = -9
 };
 
 // Supported asr
@@ -32,7 +38,15 @@ enum AX_ASR_TYPE_E {
     AX_WHISPER_BASE,
     AX_WHISPER_SMALL,
     AX_WHISPER_TURBO,
-    AX_SENSEVOICE
+    AX_SENSEVOICE,
+    // SenseVoice partials, low confidence finals rescored by Whisper.
+    // model_path must hold both sensevoice/ and whisper/<size>/
+    AX_SENSEVOICE_WHISPER_SMALL,
+    AX_SENSEVOICE_WHISPER_TURBO,
+    // Chunk-wise streaming transducer, models in <model_path>/zipformer/
+    AX_ZIPFORMER,
+    // Non-autoregressive Mandarin model, models in <model_path>/paraformer/
+    AX_PARAFORMER
 };
 
 /**
@@ -66,6 +80,38 @@ typedef void* AX_ASR_HANDLE;
  */
 AX_ASR_API AX_ASR_HANDLE AX_ASR_Init(AX_ASR_TYPE_E asr_type, const char* model_path);
 
+/**
+ * @brief Initialize by model name
+ *
+ * Looks the name up in the model registry: the built-in names
+ * ("whisper_tiny", "sensevoice", "zipformer", ...) or a variant described
+ * by <model_path>/<dir>/manifest.json, e.g.
+ *   {"name": "sensevoice_int8", "base": "sensevoice",
+ *    "files": ["sensevoice.axmodel", "tokens.txt"]}
+ * A variant is created like its base model from <model_path>/<dir>/.
+ *
+ * @return AX_ASR_HANDLE, or NULL if the name is unknown, a listed file is
+ *         missing or initialization fails
+ */
+AX_ASR_API AX_ASR_HANDLE AX_ASR_InitByName(const char* model_name, const char* model_path);
+
+/**
+ * @brief List the model names AX_ASR_InitByName() accepts
+ *
+ * @param model_path Model root scanned for manifest.json, may be NULL for
+ *                   the built-in names only
+ * @param names Comma separated names, release with AX_ASR_Free()
+ */
+AX_ASR_API int AX_ASR_ListModels(const char* model_path, char** names);
+
+/**
+ * @brief Built-in model a name derives from, the name itself for built-ins
+ *
+ * @param base Release with AX_ASR_Free()
+ * @return AX_ASR_SUCCESS, or AX_ASR_ERR_INVALID_ARGUMENT if the name is unknown
+ */
+AX_ASR_API int AX_ASR_GetModelBase(const char* model_path, const char* model_name, char** base);
+
 /**
  * @brief Deinitialize and release asr ASR resources
  * 
@@ -92,13 +138,64 @@ AX_ASR_API void AX_ASR_Uninit(AX_ASR_HANDLE handle);
  * @return int Status code (0 = success, <0 = error)
  * 
  * @note The returned string is allocated with malloc() and must be freed
- *       by the caller using free() when no longer needed.
+ *       by the caller using AX_ASR_Free() when no longer needed.
  */
 AX_ASR_API int AX_ASR_RunFile(AX_ASR_HANDLE handle, 
                    const char* wav_file, 
                    const char* language,
                    char** result);
 
+/**
+ * @brief Called with each piece of text of a file as soon as it is recognized
+ *
+ * @param text Text of the audio between start_ms and end_ms, only valid
+ *             during the call
+ */
+typedef void (*AX_ASR_SEGMENT_CALLBACK)(const char* text, int start_ms, int end_ms, void* user_data);
+
+/**
+ * @brief AX_ASR_RunFile() that reports results while the file is decoded
+ *
+ * The file is decoded block by block and fed to recognition as it goes.
+ * SenseVoice calls back after every decoded window or VAD segment, so the
+ * first text of a long recording arrives after seconds rather than after
+ * the whole file (with VAD on, after one fast energy pass over the file).
+ * Other models call back once with the whole text.
+ *
+ * @param callback Called from the calling thread, may be NULL
+ * @param result Whole text, release with AX_ASR_Free(). May be NULL if
+ *               the callback is enough.
+ *
+ * @return int Status code (0 = success, <0 = error)
+ */
+AX_ASR_API int AX_ASR_RunFileSegments(AX_ASR_HANDLE handle,
+                   const char* wav_file,
+                   const char* language,
+                   AX_ASR_SEGMENT_CALLBACK callback,
+                   void* user_data,
+                   char** result);
+
+/**
+ * @brief Recognize an encoded audio file that is already in memory
+ *
+ * Same as AX_ASR_RunFile() without going through the file system, e.g. for
+ * an uploaded file. The buffer is decoded in place, block by block.
+ *
+ * @param data Content of a wav, mp3, flac or ogg/opus file
+ * @param size Size of data in bytes
+ * @param format "wav", "mp3", "flac" or "opus", NULL or "" to guess from the data.
+ *               Ogg/Opus needs the library built with ENABLE_OPUS
+ * @param result Release with AX_ASR_Free()
+ *
+ * @return int Status code (0 = success, <0 = error)
+ */
+AX_ASR_API int AX_ASR_RunBuffer(AX_ASR_HANDLE handle,
+                   const void* data,
+                   size_t size,
+                   const char* format,
+                   const char* language,
+                   char** result);
+
 /**
  * @brief Perform speech recognition and return dynamically allocated string
  * 
@@ -115,15 +212,162 @@ AX_ASR_API int AX_ASR_RunFile(AX_ASR_HANDLE handle,
  * @return int Status code (0 = success, <0 = error)
  * 
  * @note The returned string is allocated with malloc() and must be freed
- *       by the caller using free() when no longer needed.
+ *       by the caller using AX_ASR_Free() when no longer needed.
  */
 AX_ASR_API int AX_ASR_RunPCM(AX_ASR_HANDLE handle, 
-                   float* pcm_data, 
+                   const float* pcm_data, 
+                   int num_samples,
+                   int sample_rate,
+                   const char* language,
+                   char** result);
+
+/**
+ * @brief Same as AX_ASR_RunPCM for 16 bit signed mono PCM, e.g. straight
+ *      from a capture device. Converted while it is copied into the model's
+ *      input buffer, so no float copy is needed on the caller side.
+ */
+AX_ASR_API int AX_ASR_RunPCM_S16(AX_ASR_HANDLE handle,
+                   const int16_t* pcm_data,
                    int num_samples,
                    int sample_rate,
                    const char* language,
                    char** result);
 
+/**
+ * @brief Recognize many audio files in one call
+ * 
+ * Files are decoded and their features extracted on a few worker threads,
+ * ahead of the NPU, which keeps working on the files before them. Models
+ * that support it (sensevoice) also pack short files into shared encoder
+ * runs. Meant for offline jobs over large archives, the result of each file
+ * is the same as from AX_ASR_RunFile except for packed short files.
+ * 
+ * @param handle asr context handle
+ * @param files count paths of wav, mp3, flac (or ogg/opus) files
+ * @param count Number of files
+ * @param language Preferred language, same as AX_ASR_RunPCM
+ * @param results Caller provided array of count pointers, each receives an
+ *      allocated result string to be released with AX_ASR_Free(), or NULL
+ *      if that file failed
+ * 
+ * @return int Status code, 0 if every file succeeded, otherwise the error
+ *      of the first file that failed. The other files are recognized
+ *      anyway and their results must be released in both cases.
+ */
+AX_ASR_API int AX_ASR_RunBatch(AX_ASR_HANDLE handle,
+                   const char* const* files,
+                   int count,
+                   const char* language,
+                   char** results);
+
+/**
+ * @brief Recognize several independent utterances in one call
+ * 
+ * Resampling and feature extraction of the next utterances overlap the
+ * encoder runs, as in AX_ASR_RunBatch. Models that support it (sensevoice)
+ * pack short utterances into a single encoder run, which is much cheaper
+ * than one AX_ASR_RunPCM per utterance for keyword-length audio.
+ * 
+ * @param handle asr context handle
+ * @param pcm_list count pointers to mono PCM f32 data, range from -1.0 to 1.0
+ * @param num_samples count sample numbers, one per pcm_list entry
+ * @param count Number of utterances
+ * @param sample_rate Sample rate shared by all utterances
+ * @param language Preferred language, same as AX_ASR_RunPCM
+ * @param results Caller provided array of count pointers, each receives an
+ *      allocated result string to be released with AX_ASR_Free()
+ * 
+ * @return int Status code (0 = success, <0 = error). On error no result
+ *      is allocated.
+ */
+AX_ASR_API int AX_ASR_RunPCMBatch(AX_ASR_HANDLE handle,
+                   const float* const* pcm_list,
+                   const int* num_samples,
+                   int count,
+                   int sample_rate,
+                   const char* language,
+                   char** results);
+
+typedef struct {
+    const char* text;                   // Token piece or word, UTF-8
+    int start_ms;                       // Relative to the start of the audio
+    int end_ms;
+} AX_ASR_TIMESTAMP_T;
+
+typedef struct {
+    const char* text;                   // Same text as AX_ASR_RunPCM returns
+    int num_tokens;
+    const AX_ASR_TIMESTAMP_T* tokens;   // Model output units in decoding order
+    int num_words;
+    const AX_ASR_TIMESTAMP_T* words;    // Tokens grouped into words, punctuation
+                                        // is attached to the word before it
+} AX_ASR_DETAILED_RESULT_T;
+
+/**
+ * @brief Perform speech recognition and return text with token and word timestamps
+ * 
+ * Timestamps have the resolution of one encoder frame (60ms for sensevoice).
+ * Models without alignment information (whisper) return the text only, with
+ * num_tokens and num_words set to 0.
+ * 
+ * @param handle asr context handle
+ * @param pcm_data Mono PCM f32 data, range from -1.0 to 1.0
+ * @param num_samples Sample num of PCM data
+ * @param sample_rate Sample rate of input audio
+ * @param language Preferred language, same as AX_ASR_RunPCM
+ * @param result Pointer to receive the allocated result, release it with
+ *      AX_ASR_FreeDetailed()
+ * 
+ * @return int Status code (0 = success, <0 = error)
+ */
+AX_ASR_API int AX_ASR_RunPCMDetailed(AX_ASR_HANDLE handle,
+                   const float* pcm_data,
+                   int num_samples,
+                   int sample_rate,
+                   const char* language,
+                   AX_ASR_DETAILED_RESULT_T** result);
+
+/**
+ * @brief Free a result returned by AX_ASR_RunPCMDetailed.
+ */
+AX_ASR_API void AX_ASR_FreeDetailed(AX_ASR_DETAILED_RESULT_T* result);
+
+/**
+ * @brief Set a model specific parameter.
+ * 
+ * Supported keys for sensevoice:
+ *   vad                 1 (default) encodes only speech found by energy VAD,
+ *                       0 encodes the whole audio in fixed slices
+ *   vad_threshold_db    Speech level above the estimated noise floor, default 12
+ *   vad_min_silence_ms  Shorter pauses do not split a segment, default 300
+ *   vad_speech_pad_ms   Context kept around speech, default 150
+ *   dither              deterministic (default): seeded noise, the same audio
+ *                       always gives the same text; random: unseeded noise as
+ *                       in kaldi; none: no dither
+ * 
+ * Supported keys for sensevoice_whisper_*, plus all sensevoice keys:
+ *   cascade_threshold   Finals with a lower SenseVoice confidence (mean CTC
+ *                       token posterior, 0~1) are decoded again by Whisper,
+ *                       default 0.85. 0 never rescores, above 1 always does
+ *   cascade_language    Whisper language when the request says auto, default zh
+ * 
+ * Supported keys for zipformer:
+ *   beam_size           Paths kept by modified beam search, default 4, 1 is greedy
+ * 
+ * Supported keys for paraformer: vad, vad_threshold_db, vad_min_silence_ms,
+ *   vad_speech_pad_ms and dither, same meaning as for sensevoice
+ * 
+ * @param handle ASR context handle
+ * @param key Parameter name
+ * @param value Parameter value as text
+ * 
+ * @return int AX_ASR_SUCCESS, or AX_ASR_ERR_INVALID_ARGUMENT if the key is
+ *         unknown to this model or the value cannot be parsed
+ * 
+ * @note Not thread safe with respect to running recognition on the same handle.
+ */
+AX_ASR_API int AX_ASR_SetParam(AX_ASR_HANDLE handle, const char* key, const char* value);
+
 /**
  * @brief Free transcription text returned by AX_ASR_RunFile/AX_ASR_RunPCM.
  *
@@ -148,11 +392,18 @@ AX_ASR_API int AX_ASR_StreamInit(AX_ASR_HANDLE handle);
  * @param sample_rate Sample rate of the audio (resampled to 16kHz internally)
  */
 AX_ASR_API int AX_ASR_StreamFeed(AX_ASR_HANDLE handle,
-    float* pcm_data, int num_samples, int sample_rate);
+    const float* pcm_data, int num_samples, int sample_rate);
+
+/**
+ * @brief Same as AX_ASR_StreamFeed for 16 bit signed mono PCM. The samples
+ * go straight into the feature frontend, which works in the int16 range.
+ */
+AX_ASR_API int AX_ASR_StreamFeed_S16(AX_ASR_HANDLE handle,
+    const int16_t* pcm_data, int num_samples, int sample_rate);
 
 /**
  * @brief Get the current partial streaming result.
- * The returned string is allocated internally and freed on next StreamFeed or StreamReset.
+ * The returned string is owned by the handle and valid until the next StreamResult call.
  * 
  * @param handle ASR context handle
  * @param result Pointer to receive partial transcription text. DO NOT free externally.
@@ -161,9 +412,272 @@ AX_ASR_API int AX_ASR_StreamResult(AX_ASR_HANDLE handle, const char** result);
 
 /**
  * @brief Reset streaming state (equivalent to StreamInit).
+ * Returns AX_ASR_ERR_INVALID_ARGUMENT while async mode is running, call
+ * AX_ASR_StreamStopAsync first.
  */
 AX_ASR_API int AX_ASR_StreamReset(AX_ASR_HANDLE handle);
 
+/**
+ * @brief Streaming hypothesis delivered to AX_ASR_STREAM_CALLBACK.
+ * 
+ * stable_text + unstable_text is the full hypothesis. stable_text is the
+ * prefix that is not expected to change any more, unstable_text may still
+ * be revised by later audio.
+ * is_final is set for every utterance closed by endpoint detection and once
+ * more when the worker stops; the next hypothesis starts from empty text.
+ * Strings are only valid during the callback.
+ */
+typedef struct {
+    const char* stable_text;
+    const char* unstable_text;
+    int is_final;
+} AX_ASR_STREAM_RESULT_T;
+
+typedef void (*AX_ASR_STREAM_CALLBACK)(const AX_ASR_STREAM_RESULT_T* result, void* user_data);
+
+typedef struct {
+    int interval_ms;                    // Inference cadence, <= 0 means 200ms
+    int max_buffer_ms;                  // Pending audio capacity, <= 0 means 10000ms
+    AX_ASR_STREAM_CALLBACK callback;    // Invoked on the worker thread
+    void* user_data;
+} AX_ASR_STREAM_ASYNC_CONFIG_T;
+
+/**
+ * @brief Switch streaming recognition to a background worker.
+ * 
+ * After this call AX_ASR_StreamFeed only queues audio and returns immediately,
+ * inference runs on a worker thread every interval_ms over all audio queued
+ * since the previous run, and results are pushed through config->callback.
+ * AX_ASR_StreamFeed returns AX_ASR_ERR_QUEUE_FULL if the worker falls behind
+ * by more than max_buffer_ms, the chunk is dropped in that case.
+ * 
+ * @param handle ASR context handle
+ * @param config Worker configuration, copied internally
+ */
+AX_ASR_API int AX_ASR_StreamStartAsync(AX_ASR_HANDLE handle, const AX_ASR_STREAM_ASYNC_CONFIG_T* config);
+
+/**
+ * @brief Stop the background worker started by AX_ASR_StreamStartAsync.
+ * 
+ * Queued audio is processed first, then the callback is invoked once more
+ * with is_final = 1. Blocks until the worker has exited.
+ * Call AX_ASR_StreamReset to start a new utterance.
+ */
+AX_ASR_API int AX_ASR_StreamStopAsync(AX_ASR_HANDLE handle);
+
+/**
+ * @brief Endpoint detection rules for streaming recognition.
+ * 
+ * Once an endpoint fires the current utterance is finalized: its text is
+ * queued as a final result (see AX_ASR_StreamFinalResult) or delivered with
+ * is_final = 1 in async mode, and its features are released, so the next
+ * partial result starts from an empty hypothesis.
+ * Integer fields <= 0 and silence_dbfs >= 0 take the default value.
+ */
+typedef struct {
+    int enable;                         // 0 = disabled (default), utterances grow until StreamReset
+    int min_trailing_silence_ms;        // Silence after speech that ends an utterance, default 800ms
+    int max_utterance_ms;               // Force an endpoint after this much audio, default 20000ms
+    int min_speech_ms;                  // Utterances with less speech are dropped silently, default 200ms
+    float silence_dbfs;                 // Energy below this level counts as silence, default -50dBFS.
+                                        // Silence is also detected from CTC blank frames.
+} AX_ASR_ENDPOINT_CONFIG_T;
+
+/**
+ * @brief Configure endpoint detection of the handle's default stream.
+ * Takes effect from the next AX_ASR_StreamFeed. Like AX_ASR_StreamReset,
+ * not allowed while async mode is running.
+ */
+AX_ASR_API int AX_ASR_StreamSetEndpoint(AX_ASR_HANDLE handle, const AX_ASR_ENDPOINT_CONFIG_T* config);
+
+/**
+ * @brief Pop the oldest finalized utterance of the handle's default stream.
+ * 
+ * @param handle ASR context handle
+ * @param result Receives the final text, or NULL if no utterance was finalized
+ *               since the last call. Valid until the next call. DO NOT free externally.
+ * 
+ * @note In async mode final results go to the callback instead.
+ */
+AX_ASR_API int AX_ASR_StreamFinalResult(AX_ASR_HANDLE handle, const char** result);
+
+/**
+ * @brief Opaque handle of one streaming session
+ * 
+ * Sessions created from the same AX_ASR_HANDLE share its loaded model, each
+ * one only holds its own features and partial result. Encoder runs from
+ * different sessions are serialized on the NPU.
+ * The handle level AX_ASR_Stream* functions above operate on a built-in
+ * default session of the handle.
+ */
+typedef void* AX_ASR_STREAM_HANDLE;
+
+/**
+ * @brief Create a new streaming session on a loaded model.
+ * 
+ * @param handle ASR context handle
+ * 
+ * @return AX_ASR_STREAM_HANDLE Session handle, or NULL if the model does not
+ *         support streaming
+ * 
+ * @note Release with AX_ASR_StreamDestroy() before AX_ASR_Uninit().
+ */
+AX_ASR_API AX_ASR_STREAM_HANDLE AX_ASR_StreamCreate(AX_ASR_HANDLE handle);
+
+/**
+ * @brief Destroy a session, stopping its async worker if still running.
+ */
+AX_ASR_API void AX_ASR_StreamDestroy(AX_ASR_STREAM_HANDLE stream);
+
+/**
+ * @brief Same as AX_ASR_StreamFeed on a session.
+ * Different sessions may be fed from different threads concurrently,
+ * a single session must not.
+ */
+AX_ASR_API int AX_ASR_SessionFeed(AX_ASR_STREAM_HANDLE stream,
+    const float* pcm_data, int num_samples, int sample_rate);
+
+/**
+ * @brief Same as AX_ASR_StreamFeed_S16 on a session.
+ */
+AX_ASR_API int AX_ASR_SessionFeed_S16(AX_ASR_STREAM_HANDLE stream,
+    const int16_t* pcm_data, int num_samples, int sample_rate);
+
+/**
+ * @brief Same as AX_ASR_StreamResult on a session.
+ * The returned string is owned by the session and valid until the next
+ * AX_ASR_SessionResult call or AX_ASR_StreamDestroy.
+ */
+AX_ASR_API int AX_ASR_SessionResult(AX_ASR_STREAM_HANDLE stream, const char** result);
+
+/**
+ * @brief Same as AX_ASR_StreamReset on a session.
+ */
+AX_ASR_API int AX_ASR_SessionReset(AX_ASR_STREAM_HANDLE stream);
+
+/**
+ * @brief Same as AX_ASR_StreamStartAsync on a session.
+ */
+AX_ASR_API int AX_ASR_SessionStartAsync(AX_ASR_STREAM_HANDLE stream, const AX_ASR_STREAM_ASYNC_CONFIG_T* config);
+
+/**
+ * @brief Same as AX_ASR_StreamStopAsync on a session.
+ */
+AX_ASR_API int AX_ASR_SessionStopAsync(AX_ASR_STREAM_HANDLE stream);
+
+/**
+ * @brief Same as AX_ASR_StreamSetEndpoint on a session.
+ */
+AX_ASR_API int AX_ASR_SessionSetEndpoint(AX_ASR_STREAM_HANDLE stream, const AX_ASR_ENDPOINT_CONFIG_T* config);
+
+/**
+ * @brief Same as AX_ASR_StreamFinalResult on a session.
+ */
+AX_ASR_API int AX_ASR_SessionFinalResult(AX_ASR_STREAM_HANDLE stream, const char** result);
+
+/**
+ * @brief Input of an asynchronous request
+ */
+enum AX_ASR_INPUT_TYPE_E {
+    AX_ASR_INPUT_FILE = 0,      // file: path of a wav, mp3, flac (or ogg/opus) file
+    AX_ASR_INPUT_BUFFER,        // data/size: file content in memory, format as in AX_ASR_RunBuffer
+    AX_ASR_INPUT_PCM,           // data/size: mono PCM f32 samples at sample_rate
+    AX_ASR_INPUT_PCM_S16        // data/size: mono PCM s16 samples at sample_rate
+};
+
+typedef struct {
+    AX_ASR_INPUT_TYPE_E type;
+    const char* file;
+    const void* data;
+    size_t size;                // Bytes for AX_ASR_INPUT_BUFFER, samples for PCM
+    const char* format;         // AX_ASR_INPUT_BUFFER only, NULL to guess
+    int sample_rate;            // PCM only
+    const char* language;       // Same as AX_ASR_RunPCM
+} AX_ASR_REQUEST_T;
+
+/**
+ * @brief Result of an asynchronous request
+ */
+typedef struct {
+    int64_t request_id;
+    int status;                 // AX_ASR_STATUS_E, AX_ASR_ERR_CANCELLED if cancelled
+    char* result;               // Text or NULL on error, release with AX_ASR_Free()
+    void* user_data;            // As passed to AX_ASR_Submit
+} AX_ASR_COMPLETION_T;
+
+/**
+ * @brief Called once per request submitted with a callback.
+ * Runs on an internal thread, or on the thread calling AX_ASR_Cancel or
+ * AX_ASR_Uninit for requests that had not started. completion->result
+ * is only valid during the call, do not free it. Must not call
+ * AX_ASR_Uninit.
+ */
+typedef void (*AX_ASR_REQUEST_CALLBACK)(const AX_ASR_COMPLETION_T* completion, void* user_data);
+
+/**
+ * @brief Queue a recognition request and return at once
+ * 
+ * Requests are decoded and their features extracted on a few worker
+ * threads of the handle, oldest first, while one thread keeps the NPU busy
+ * with the requests before them. A single thread can keep
+ * many requests outstanding instead of blocking in AX_ASR_Run* for each.
+ * Everything the request points to is copied, the caller's buffers can
+ * be reused as soon as this returns.
+ * 
+ * @param handle asr context handle
+ * @param request What to recognize
+ * @param callback Receives the completion, or NULL to collect it with
+ *      AX_ASR_Poll/AX_ASR_Wait
+ * @param user_data Passed back with the completion
+ * 
+ * @return int64_t Request id (> 0), or a negative AX_ASR_STATUS_E if the
+ *      request was rejected, in which case there is no completion
+ * 
+ * @note Blocking AX_ASR_Run* calls on the same handle share the model with
+ *       the workers; whisper models must not be used both ways at once.
+ */
+AX_ASR_API int64_t AX_ASR_Submit(AX_ASR_HANDLE handle,
+                   const AX_ASR_REQUEST_T* request,
+                   AX_ASR_REQUEST_CALLBACK callback,
+                   void* user_data);
+
+/**
+ * @brief Take the oldest completion of a request submitted without callback
+ * 
+ * @param completion Filled in on success, release completion->result with
+ *      AX_ASR_Free()
+ * 
+ * @return int AX_ASR_SUCCESS if a completion was returned (the request's
+ *      own status is in completion->status), AX_ASR_ERR_NOT_READY if none
+ *      is available yet
+ */
+AX_ASR_API int AX_ASR_Poll(AX_ASR_HANDLE handle, AX_ASR_COMPLETION_T* completion);
+
+/**
+ * @brief AX_ASR_Poll waiting up to timeout_ms for a completion
+ * 
+ * @param timeout_ms Negative to wait until one is available
+ * 
+ * @return int AX_ASR_SUCCESS, or AX_ASR_ERR_NOT_READY on timeout, and at
+ *      once if no request without callback is outstanding
+ */
+AX_ASR_API int AX_ASR_Wait(AX_ASR_HANDLE handle, AX_ASR_COMPLETION_T* completion, int timeout_ms);
+
+/**
+ * @brief Cancel an outstanding request
+ * 
+ * A request still waiting for a worker completes right away with
+ * AX_ASR_ERR_CANCELLED. One already being decoded or recognized finishes
+ * that step first and then completes with AX_ASR_ERR_CANCELLED, its text
+ * is dropped. Either way it gets exactly one completion.
+ * 
+ * @return int AX_ASR_SUCCESS, or AX_ASR_ERR_INVALID_ARGUMENT if the id is
+ *      not outstanding (unknown or already completed)
+ * 
+ * @note AX_ASR_Uninit cancels all outstanding requests the same way.
+ */
+AX_ASR_API int AX_ASR_Cancel(AX_ASR_HANDLE handle, int64_t request_id);
+
 #ifdef __cplusplus
 }
 #endif
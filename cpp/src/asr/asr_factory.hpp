@@ -11,57 +11,32 @@
 
 #include <memory>
 #include "asr/asr_interface.hpp"
+#include "asr/asr_registry.hpp"
 #include "api/ax_asr_api.h"
 #include "utils/logger.h"
-#include "asr/whisper.hpp"
-#include "asr/sensevoice.hpp"
 
 class ASRFactory {
 public:
     static ASRInterface* create(AX_ASR_TYPE_E asr_type, const std::string& model_path) {
-        ASRInterface* interface = nullptr;
-        
-        std::string spec_model_path;
-        spec_model_path.reserve(64);
-
-        switch (asr_type)
-        {
-        case AX_WHISPER_TINY: {
-            interface = new Whisper();
-            spec_model_path = model_path + "/whisper/tiny/";
-            break;
-        }
-        case AX_WHISPER_BASE: {
-            interface = new Whisper();
-            spec_model_path = model_path + "/whisper/base/";
-            break;
-        }
-        case AX_WHISPER_SMALL: {
-            interface = new Whisper();
-            spec_model_path = model_path + "/whisper/small/";
-            break;
-        }
-        case AX_WHISPER_TURBO: {
-            interface = new Whisper();
-            spec_model_path = model_path + "/whisper/turbo/";
-            break;
-        }
-        case AX_SENSEVOICE: {
-            interface = new Sensevoice();
-            spec_model_path = model_path + "/sensevoice/";
-            break;
-        }
-        default:
+        ASRModelInfo info;
+        if (!ASRRegistry::instance().find(asr_type, info)) {
             ALOGE("Unknown asr_type %d", asr_type);
             return nullptr;
         }
+        return ASRRegistry::instance().create(info, model_path);
+    }
 
-        if (!interface->init(asr_type, spec_model_path)) {
-            ALOGE("Init asr failed!");
-            delete interface;
-            return nullptr;
+    // Built-in names, or variants with a manifest.json under model_path
+    static ASRInterface* create(const std::string& model_name, const std::string& model_path) {
+        auto& registry = ASRRegistry::instance();
+        ASRModelInfo info;
+        if (!registry.find(model_name, info)) {
+            registry.scan(model_path);
+            if (!registry.find(model_name, info)) {
+                ALOGE("Unknown model %s", model_name.c_str());
+                return nullptr;
+            }
         }
-
-        return interface;
+        return registry.create(info, model_path);
     }
-};
\ No newline at end of file
+};
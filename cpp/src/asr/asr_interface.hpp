@@ -9,9 +9,84 @@
  **************************************************************************************************/
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include "api/ax_asr_api.h"
+#include "utils/AudioReader.hpp"
+#include "utils/pcm_convert.hpp"
+#include "utils/resample.h"
+
+// One utterance finalized by endpoint detection. Times are from the first
+// sample fed since the stream was created or reset.
+struct ASRFinalResult {
+    std::string text;
+    int start_ms = 0;
+    int end_ms = 0;
+    float confidence = -1.0f;   // in [0, 1], -1 if the model has no estimate
+    std::string language;       // detected language code, empty if the model has none
+};
+
+// Partial results of a file, in order
+typedef std::function<void(const ASRFinalResult&)> ASRSegmentCallback;
+
+// One streaming recognition session.
+// Holds only per-stream state (features, partial text), the model itself is
+// owned by the ASRInterface that created it and shared by all its streams.
+// A single stream must not be fed from several threads at once.
+class ASRStream {
+public:
+    virtual ~ASRStream() {}
+    // pcm: mono float in [-1.0, 1.0], only read during the call
+    virtual void feed(const float* pcm, size_t num_samples, int sample_rate) = 0;
+    void feed(const std::vector<float>& pcm_chunk, int sample_rate) {
+        feed(pcm_chunk.data(), pcm_chunk.size(), sample_rate);
+    }
+    // 16 bit PCM. Streams whose frontend takes it directly override this,
+    // the default converts the chunk to float first.
+    virtual void feed_s16(const int16_t* pcm, size_t num_samples, int sample_rate) {
+        std::vector<float> chunk(num_samples);
+        utils::s16_to_f32(pcm, num_samples, 1.0f / 32768.0f, chunk.data());
+        feed(chunk.data(), chunk.size(), sample_rate);
+    }
+    virtual bool result(std::string& partial_text) = 0;
+    virtual void reset() = 0;
+
+    // Endpoint detection (optional), finalized utterances are queued for pop_final()
+    virtual void set_endpoint(const AX_ASR_ENDPOINT_CONFIG_T& /*config*/) {}
+    virtual bool pop_final(ASRFinalResult& /*final_result*/) { return false; }
+    bool pop_final(std::string& text) {
+        ASRFinalResult final_result;
+        if (!pop_final(final_result))
+            return false;
+        text = std::move(final_result.text);
+        return true;
+    }
+};
+
+// Text of one token or word and where it was heard
+struct ASRTimestamp {
+    std::string text;
+    int start_ms;
+    int end_ms;
+};
+
+// One utterance after the part of recognition that runs on the CPU, made
+// by ASRInterface::prepare(). Models derive from it to keep their features.
+struct ASRPrepared {
+    virtual ~ASRPrepared() {}
+    std::vector<float> audio;       // at sample_rate(), empty once consumed
+};
+
+struct ASRResult {
+    std::string text;
+    std::vector<ASRTimestamp> tokens;   // empty if the model has no timestamps
+    std::vector<ASRTimestamp> words;
+    float confidence = -1.0f;           // in [0, 1], -1 if the model has no estimate
+    std::string language;               // detected language code, empty if the model has none
+};
 
 class ASRInterface {
 public:
@@ -21,9 +96,110 @@ public:
     virtual void uninit(void) = 0;
     virtual bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) = 0;
 
-    // Streaming API (optional — default no-op). Override in sensevoice for real streaming.
-    virtual void stream_init() {}
-    virtual void stream_feed(const std::vector<float>& pcm_chunk, int sample_rate) {}
-    virtual bool stream_result(std::string& partial_text) { return false; }
-    virtual void stream_reset() {}
+    // Recognize audio already in the model's native format: mono float in
+    // [-1.0, 1.0] at sample_rate(). audio is the request's own buffer, so
+    // models override this to scale and dither it in place on the way into
+    // feature extraction instead of copying it again.
+    virtual bool run_native(std::vector<float>& audio, const std::string& language, std::string& text_result) {
+        return run(audio, sample_rate(), language, text_result);
+    }
+
+    // The audio front end of a request: pcm is resampled straight into the
+    // native buffer, or copied into it once if the rate already matches,
+    // and that one buffer goes on to run_native().
+    bool run_pcm(const float* pcm, size_t num_samples, int sample_rate, const std::string& language,
+                 std::string& text_result) {
+        std::vector<float> audio;
+        utils::resample(pcm, num_samples, sample_rate, this->sample_rate(), audio);
+        return run_native(audio, language, text_result);
+    }
+
+    // run_pcm() for 16 bit PCM, converted on the way into the native buffer
+    bool run_pcm_s16(const int16_t* pcm, size_t num_samples, int sample_rate, const std::string& language,
+                     std::string& text_result) {
+        std::vector<float> audio;
+        utils::resample_s16(pcm, num_samples, sample_rate, this->sample_rate(), audio);
+        return run_native(audio, language, text_result);
+    }
+
+    // Recognize a whole file read block by block from reader. Models that
+    // can work in bounded windows override this so memory does not grow
+    // with the duration, the default reads everything in one buffer and
+    // calls run_native(), or run() if the reader was not opened at
+    // sample_rate(). on_segment, if set, gets each piece of text as soon as
+    // it has been recognized, times are from the start of the file.
+    virtual bool run_reader(utils::AudioReader& reader, const std::string& language, std::string& text_result,
+                            const ASRSegmentCallback& on_segment) {
+        std::vector<float> audio_data;
+        if (!reader.read_all(audio_data) || audio_data.empty())
+            return false;
+        const int reader_rate = reader.get_sample_rate();
+        const int64_t duration_ms = audio_data.size() * 1000LL / reader_rate;
+        bool ok = reader_rate == sample_rate() ? run_native(audio_data, language, text_result)
+                                               : run(audio_data, reader_rate, language, text_result);
+        if (!ok)
+            return false;
+        if (on_segment && !text_result.empty()) {
+            ASRFinalResult segment;
+            segment.text = text_result;
+            segment.end_ms = (int)duration_ms;
+            on_segment(segment);
+        }
+        return true;
+    }
+
+    // Text plus token and word timestamps. Models without alignment only
+    // fill in the text.
+    virtual bool run_detailed(const std::vector<float>& audio_data, int sample_rate, const std::string& language,
+                              ASRResult& result) {
+        result.tokens.clear();
+        result.words.clear();
+        result.confidence = -1.0f;
+        return run(audio_data, sample_rate, language, result.text);
+    }
+
+    // run_detailed() on a native buffer, see run_native()
+    virtual bool run_native_detailed(std::vector<float>& audio, const std::string& language, ASRResult& result) {
+        return run_detailed(audio, sample_rate(), language, result);
+    }
+
+    // run_pcm() with timestamps
+    bool run_pcm_detailed(const float* pcm, size_t num_samples, int sample_rate, const std::string& language,
+                          ASRResult& result) {
+        std::vector<float> audio;
+        utils::resample(pcm, num_samples, sample_rate, this->sample_rate(), audio);
+        return run_native_detailed(audio, language, result);
+    }
+
+    // Batch recognition in two halves a pipeline can overlap, see
+    // BatchPipeline. prepare() does what needs no NPU (VAD, features) on
+    // audio at sample_rate(), which it may consume, and is called from
+    // several threads at once. run_prepared() is called from one thread
+    // with consecutive items and may share encoder runs between them.
+    virtual std::unique_ptr<ASRPrepared> prepare(std::vector<float>& audio) {
+        auto item = std::make_unique<ASRPrepared>();
+        item->audio.swap(audio);
+        return item;
+    }
+
+    virtual bool run_prepared(std::vector<std::unique_ptr<ASRPrepared>>& items, const std::string& language,
+                              std::vector<std::string>& text_results) {
+        text_results.assign(items.size(), std::string());
+        for (size_t i = 0; i < items.size(); i++) {
+            if (!run_native(items[i]->audio, language, text_results[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // Most items run_prepared() can make use of in one call, 1 if the
+    // model gains nothing from seeing several
+    virtual int max_batch_items() { return 1; }
+
+    // Model specific tuning, returns false for unknown keys or bad values
+    virtual bool set_param(const std::string& /*key*/, const std::string& /*value*/) { return false; }
+
+    // Streaming API (optional). Returns nullptr if the model cannot stream.
+    // Streams must be destroyed before uninit().
+    virtual std::unique_ptr<ASRStream> create_stream() { return nullptr; }
 };
\ No newline at end of file
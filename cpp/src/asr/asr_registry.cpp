@@ -0,0 +1,182 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <cctype>
+#include <dirent.h>
+#include <fstream>
+#include <unistd.h>
+
+#include "asr/asr_registry.hpp"
+#include "utils/nlohmann/json.hpp"
+#include "utils/logger.h"
+
+using json = nlohmann::json;
+
+ASRRegistry& ASRRegistry::instance() {
+    static ASRRegistry registry;
+    return registry;
+}
+
+// The library is static, so built-ins are registered by explicit calls
+// rather than static initializers the linker could drop
+ASRRegistry::ASRRegistry() {
+    register_whisper_models(*this);
+    register_sensevoice_models(*this);
+    register_cascade_models(*this);
+    register_zipformer_models(*this);
+    register_paraformer_models(*this);
+}
+
+bool ASRRegistry::add(const ASRModelInfo& info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return add_locked_(info);
+}
+
+bool ASRRegistry::add_locked_(const ASRModelInfo& info) {
+    if (info.name.empty() || !info.create) {
+        ALOGE("Model registered without name or constructor");
+        return false;
+    }
+    for (auto& model : models_) {
+        if (model.name == info.name)
+            return false;
+    }
+    models_.push_back(info);
+    return true;
+}
+
+bool ASRRegistry::find(const std::string& name, ASRModelInfo& info) const {
+    std::string key = name;
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& model : models_) {
+        if (model.name == key) {
+            info = model;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ASRRegistry::find(AX_ASR_TYPE_E type, ASRModelInfo& info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& model : models_) {
+        if (model.type == type) {
+            info = model;
+            return true;
+        }
+    }
+    return false;
+}
+
+int ASRRegistry::scan(const std::string& model_root) {
+    DIR* dir = opendir(model_root.c_str());
+    if (!dir)
+        return 0;
+
+    std::vector<std::string> dir_names;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string dir_name = entry->d_name;
+        if (dir_name == "." || dir_name == "..")
+            continue;
+        if (access((model_root + "/" + dir_name + "/manifest.json").c_str(), R_OK) == 0)
+            dir_names.push_back(dir_name);
+    }
+    closedir(dir);
+    // Same order whatever the file system returns
+    std::sort(dir_names.begin(), dir_names.end());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    int added = 0;
+    for (auto& dir_name : dir_names) {
+        if (add_manifest_(model_root, dir_name))
+            added++;
+    }
+    return added;
+}
+
+// Call with mutex_ held
+bool ASRRegistry::add_manifest_(const std::string& model_root, const std::string& dir_name) {
+    std::string path = model_root + "/" + dir_name + "/manifest.json";
+    std::ifstream fs(path);
+    json manifest = json::parse(fs, nullptr, false);
+    if (manifest.is_discarded() || !manifest.is_object()) {
+        ALOGW("Ignore invalid manifest %s", path.c_str());
+        return false;
+    }
+
+    // value() throws when a key holds another type
+    if ((manifest.contains("name") && !manifest["name"].is_string()) ||
+        (manifest.contains("base") && !manifest["base"].is_string())) {
+        ALOGW("Manifest %s: name and base must be strings", path.c_str());
+        return false;
+    }
+    std::vector<std::string> files;
+    if (manifest.contains("files") && manifest["files"].is_array()) {
+        for (auto& file : manifest["files"]) {
+            if (!file.is_string()) {
+                ALOGW("Manifest %s: files must be strings", path.c_str());
+                return false;
+            }
+            files.push_back(file.get<std::string>());
+        }
+    }
+
+    // Requested model names are matched lowercased
+    std::string name = manifest.value("name", dir_name);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    std::string base = manifest.value("base", std::string());
+    auto it = std::find_if(models_.begin(), models_.end(), [&](const ASRModelInfo& m) { return m.name == base; });
+    if (it == models_.end()) {
+        ALOGW("Manifest %s: unknown base model \"%s\"", path.c_str(), base.c_str());
+        return false;
+    }
+
+    // Same implementation and file layout as the base, other files
+    ASRModelInfo info = *it;
+    info.name = name;
+    info.base = it->base;
+    info.sub_path = dir_name;
+    if (manifest.contains("files") && manifest["files"].is_array())
+        info.files = std::move(files);
+
+    if (!add_locked_(info))
+        return false;
+    ALOGD("Registered %s from %s, based on %s", name.c_str(), path.c_str(), info.base.c_str());
+    return true;
+}
+
+std::vector<std::string> ASRRegistry::names() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> names;
+    for (auto& model : models_) {
+        names.push_back(model.name);
+    }
+    return names;
+}
+
+ASRInterface* ASRRegistry::create(const ASRModelInfo& info, const std::string& model_root) const {
+    std::string model_path = info.sub_path.empty() ? model_root : model_root + "/" + info.sub_path + "/";
+    for (auto& file : info.files) {
+        std::string file_path = model_path + "/" + file;
+        if (access(file_path.c_str(), R_OK) != 0) {
+            ALOGE("Model %s needs %s", info.name.c_str(), file_path.c_str());
+            return nullptr;
+        }
+    }
+
+    ASRInterface* interface = info.create();
+    if (!interface->init(info.type, model_path)) {
+        ALOGE("Init asr %s failed!", info.name.c_str());
+        delete interface;
+        return nullptr;
+    }
+    return interface;
+}
@@ -0,0 +1,74 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "asr/asr_interface.hpp"
+
+// Everything needed to create one named model
+struct ASRModelInfo {
+    std::string name;                   // lookup key, e.g. "sensevoice"
+    std::string base;                   // built-in model it derives from, name itself for built-ins
+    AX_ASR_TYPE_E type;                 // passed to ASRInterface::init()
+    std::string sub_path;               // model directory under the model root, empty for the root
+    std::vector<std::string> files;     // must all exist under sub_path before init
+    std::function<ASRInterface*()> create;
+};
+
+// Name -> model table shared by the C API, the server and Python.
+//
+// Built-in recognizers add themselves through the register_*_models()
+// function next to their implementation. Variants that only differ in
+// their model files (a quantized or short window export) are described by
+// a manifest.json in their own directory under the model root:
+//   {"name": "sensevoice_int8", "base": "sensevoice", "files": [...]}
+// and can be created by name without a rebuild, see scan().
+class ASRRegistry {
+public:
+    static ASRRegistry& instance();
+
+    // false if the name is already taken
+    bool add(const ASRModelInfo& info);
+
+    // name is matched case-insensitively, registered names are lowercase
+    bool find(const std::string& name, ASRModelInfo& info) const;
+    // First model registered with this type
+    bool find(AX_ASR_TYPE_E type, ASRModelInfo& info) const;
+
+    // Register <model_root>/*/manifest.json, returns the number of new models
+    int scan(const std::string& model_root);
+
+    // Registration order, built-ins first
+    std::vector<std::string> names() const;
+
+    // Check the model files, then create and init. nullptr on failure.
+    ASRInterface* create(const ASRModelInfo& info, const std::string& model_root) const;
+
+private:
+    ASRRegistry();
+
+    bool add_locked_(const ASRModelInfo& info);
+    bool add_manifest_(const std::string& model_root, const std::string& dir_name);
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<ASRModelInfo> models_;
+};
+
+// Defined next to each recognizer
+void register_whisper_models(ASRRegistry& registry);
+void register_sensevoice_models(ASRRegistry& registry);
+void register_cascade_models(ASRRegistry& registry);
+void register_zipformer_models(ASRRegistry& registry);
+void register_paraformer_models(ASRRegistry& registry);
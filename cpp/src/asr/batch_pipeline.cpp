@@ -0,0 +1,174 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "asr/batch_pipeline.hpp"
+#include "api/ax_asr_api.h"
+#include "utils/logger.h"
+
+// Default number of loader threads is capped here, the NPU is the limit
+// beyond that
+#define BATCH_MAX_THREADS       4
+// Items loaded ahead of the NPU per loader thread, bounds memory
+#define BATCH_AHEAD_PER_THREAD  4
+
+class BatchPipeline::Impl {
+public:
+    Impl(ASRInterface* asr, int num_threads):
+        asr_(asr) {
+        if (num_threads <= 0) {
+            num_threads = std::min<int>(std::max<int>(std::thread::hardware_concurrency(), 1), BATCH_MAX_THREADS);
+        }
+        num_threads_ = num_threads;
+    }
+
+    void run(size_t count, const BatchLoader& load, const std::string& language,
+             std::vector<int>& status, std::vector<std::string>& texts) {
+        status.assign(count, AX_ASR_SUCCESS);
+        texts.assign(count, std::string());
+        if (count == 0)
+            return;
+
+        const size_t max_items = std::max(asr_->max_batch_items(), 1);
+        const int num_threads = std::min<size_t>(num_threads_, count);
+        // Enough ahead for every thread to stay busy while a full group runs
+        ahead_ = (size_t)num_threads * BATCH_AHEAD_PER_THREAD + max_items;
+
+        slots_.clear();
+        slots_.resize(count);
+        next_ = 0;
+        done_ = 0;
+        count_ = count;
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < num_threads; i++) {
+            workers.emplace_back(&Impl::load_loop_, this, std::cref(load));
+        }
+        ALOGD("Batch: %zu items, %d loader threads, up to %zu items per run", count, num_threads, max_items);
+
+        std::vector<std::unique_ptr<ASRPrepared>> group;
+        std::vector<size_t> group_index;
+        std::vector<std::string> group_texts;
+        size_t pos = 0;
+        while (pos < count) {
+            // Everything ready from pos on, in order, at least one item
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_cv_.wait(lock, [&] { return slots_[pos].ready; });
+                for (; pos < count && slots_[pos].ready && group.size() < max_items; pos++) {
+                    if (slots_[pos].status != AX_ASR_SUCCESS) {
+                        status[pos] = slots_[pos].status;
+                        continue;
+                    }
+                    group.push_back(std::move(slots_[pos].item));
+                    group_index.push_back(pos);
+                }
+            }
+
+            if (!group.empty()) {
+                if (asr_->run_prepared(group, language, group_texts)) {
+                    for (size_t k = 0; k < group.size(); k++) {
+                        texts[group_index[k]] = std::move(group_texts[k]);
+                    }
+                } else {
+                    ALOGE("Batch items %zu-%zu failed", group_index.front(), group_index.back());
+                    for (size_t index : group_index) {
+                        status[index] = AX_ASR_ERR_RUN_FAILED;
+                    }
+                }
+                group.clear();
+                group_index.clear();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_ = pos;
+            }
+            space_cv_.notify_all();
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        slots_.clear();
+    }
+
+private:
+    struct Slot {
+        std::unique_ptr<ASRPrepared> item;
+        int status = AX_ASR_SUCCESS;
+        bool ready = false;
+    };
+
+    void load_loop_(const BatchLoader& load) {
+        std::vector<float> audio;
+        while (true) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                space_cv_.wait(lock, [&] { return next_ >= count_ || next_ < done_ + ahead_; });
+                if (next_ >= count_)
+                    return;
+                index = next_++;
+            }
+
+            std::unique_ptr<ASRPrepared> item;
+            audio.clear();
+            int status = load(index, audio);
+            if (status == AX_ASR_SUCCESS) {
+                item = asr_->prepare(audio);
+                if (!item) {
+                    ALOGW("Batch item %zu not prepared", index);
+                    status = AX_ASR_ERR_RUN_FAILED;
+                }
+            } else {
+                ALOGW("Batch item %zu not loaded", index);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                slots_[index].item = std::move(item);
+                slots_[index].status = status;
+                slots_[index].ready = true;
+            }
+            ready_cv_.notify_one();
+        }
+    }
+
+private:
+    ASRInterface* asr_;
+    int num_threads_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;      // a slot became ready
+    std::condition_variable space_cv_;      // the NPU side moved on
+    std::vector<Slot> slots_;
+    size_t next_ = 0;                       // next item to load
+    size_t done_ = 0;                       // items handed to run_prepared()
+    size_t count_ = 0;
+    size_t ahead_ = 0;
+};
+
+BatchPipeline::BatchPipeline(ASRInterface* asr, int num_threads):
+    impl_(std::make_unique<BatchPipeline::Impl>(asr, num_threads)) {
+
+}
+
+BatchPipeline::~BatchPipeline() {
+
+}
+
+void BatchPipeline::run(size_t count, const BatchLoader& load, const std::string& language,
+                        std::vector<int>& status, std::vector<std::string>& texts) {
+    impl_->run(count, load, language, status, texts);
+}
@@ -0,0 +1,45 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asr/asr_interface.hpp"
+
+// Fill audio with item index at the model's sample_rate(). Called from the
+// pipeline threads, several items at once. Returns an AX_ASR_STATUS_E.
+typedef std::function<int(size_t index, std::vector<float>& audio)> BatchLoader;
+
+// Recognizes many independent items with the CPU and the NPU busy at the
+// same time.
+//
+// Worker threads load items (decode, resample) and run
+// ASRInterface::prepare() on them, a bounded number of items ahead. The
+// calling thread hands whatever is ready, in order and up to
+// max_batch_items() at a time, to ASRInterface::run_prepared(), so the
+// next items are decoded and extracted while the NPU runs. A failed item
+// does not stop the others.
+class BatchPipeline {
+public:
+    // num_threads: loader threads, 0 picks one per core up to 4
+    BatchPipeline(ASRInterface* asr, int num_threads = 0);
+    ~BatchPipeline();
+
+    // status[i] is the AX_ASR_STATUS_E of item i, texts[i] its text
+    void run(size_t count, const BatchLoader& load, const std::string& language,
+             std::vector<int>& status, std::vector<std::string>& texts);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
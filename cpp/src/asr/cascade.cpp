@@ -0,0 +1,341 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "asr/cascade.hpp"
+#include "asr/asr_registry.hpp"
+#include "asr/sensevoice.hpp"
+#include "asr/whisper.hpp"
+#include "utils/logger.h"
+
+// Finals at or above this SenseVoice confidence skip Whisper
+#define CASCADE_DEFAULT_THRESHOLD   0.85f
+// Whisper decodes a single 30s window
+#define CASCADE_MAX_RESCORE_MS      30000
+// Audio kept by a stream beyond the longest utterance
+#define CASCADE_HISTORY_MARGIN_MS   2000
+
+class Cascade::Impl {
+public:
+    friend class Cascade;
+    friend class CascadeStream;
+
+    bool init(AX_ASR_TYPE_E asr_type, const std::string& model_path) {
+        AX_ASR_TYPE_E whisper_type;
+        std::string whisper_path;
+        if (asr_type == AX_SENSEVOICE_WHISPER_SMALL) {
+            whisper_type = AX_WHISPER_SMALL;
+            whisper_path = model_path + "/whisper/small/";
+        } else if (asr_type == AX_SENSEVOICE_WHISPER_TURBO) {
+            whisper_type = AX_WHISPER_TURBO;
+            whisper_path = model_path + "/whisper/turbo/";
+        } else {
+            ALOGE("Unsupported cascade type %d", asr_type);
+            return false;
+        }
+
+        if (!first_pass_.init(AX_SENSEVOICE, model_path + "/sensevoice/")) {
+            ALOGE("Init sensevoice of cascade failed!");
+            return false;
+        }
+        if (!second_pass_.init(whisper_type, whisper_path)) {
+            ALOGE("Init whisper of cascade failed!");
+            first_pass_.uninit();
+            return false;
+        }
+        return true;
+    }
+
+    void uninit(void) {
+        second_pass_.uninit();
+        first_pass_.uninit();
+    }
+
+    bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) {
+        ASRResult result;
+        if (!first_pass_.run_detailed(audio_data, sample_rate, language, result))
+            return false;
+
+        int duration_ms = (int)(audio_data.size() * 1000LL / sample_rate);
+        if (!need_rescore_(result.confidence, duration_ms)) {
+            text_result = std::move(result.text);
+            return true;
+        }
+
+        ALOGD("Cascade: confidence %.3f, rescore %dms with whisper", result.confidence, duration_ms);
+        const std::string& lang = language.empty() || language == "auto" ? result.language : language;
+        if (!rescore_(audio_data, sample_rate, lang, text_result)) {
+            // The first pass is still a usable answer
+            text_result = std::move(result.text);
+        }
+        return true;
+    }
+
+    bool set_param(const std::string& key, const std::string& value) {
+        if (key == "cascade_threshold") {
+            char* end = nullptr;
+            float v = strtof(value.c_str(), &end);
+            if (value.empty() || *end != '\0') {
+                ALOGE("Invalid value %s for %s", value.c_str(), key.c_str());
+                return false;
+            }
+            threshold_ = v;
+            return true;
+        }
+        if (key == "cascade_language") {
+            std::lock_guard<std::mutex> lock(whisper_mutex_);
+            language_ = value;
+            return true;
+        }
+        // Everything else tunes the first pass
+        return first_pass_.set_param(key, value);
+    }
+
+private:
+    bool need_rescore_(float confidence, int duration_ms) const {
+        return confidence >= 0 && confidence < threshold_ && duration_ms > 0 && duration_ms <= CASCADE_MAX_RESCORE_MS;
+    }
+
+    // language is the one requested or detected by the first pass. Whisper
+    // has no language detection here, so "auto", an empty one or one it
+    // has no token for falls back to cascade_language.
+    bool rescore_(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) {
+        std::lock_guard<std::mutex> lock(whisper_mutex_);
+        bool known = !language.empty() && language != "auto" && second_pass_.has_language(language);
+        const std::string& lang = known ? language : language_;
+        std::string text;
+        if (!second_pass_.run(audio_data, sample_rate, lang, text) || text.empty())
+            return false;
+        text_result = std::move(text);
+        return true;
+    }
+
+private:
+    Sensevoice first_pass_;
+    Whisper second_pass_;
+    // Whisper keeps its decoder state in the model, one run at a time
+    std::mutex whisper_mutex_;
+    float threshold_ = CASCADE_DEFAULT_THRESHOLD;
+    std::string language_ = "zh";
+};
+
+// Streaming session: partials come straight from a SenseVoice stream, its
+// finals go through a worker thread that rescores the unsure ones, so feed()
+// never waits for Whisper. Finals come out in the order they were spoken.
+class CascadeStream : public ASRStream {
+public:
+    explicit CascadeStream(Cascade::Impl& model):
+        model_(model),
+        first_pass_(model.first_pass_.create_stream()) {
+        worker_ = std::thread(&CascadeStream::loop_, this);
+    }
+
+    ~CascadeStream() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        worker_.join();
+    }
+
+    using ASRStream::feed;
+    void feed(const float* pcm, size_t num_samples, int sample_rate) {
+        if (num_samples == 0) return;
+
+        std::lock_guard<std::mutex> feed_lock(feed_mutex_);
+        keep_history_(pcm, num_samples, sample_rate);
+        first_pass_->feed(pcm, num_samples, sample_rate);
+
+        ASRFinalResult final_result;
+        while (first_pass_->pop_final(final_result)) {
+            Job job;
+            job.generation = generation_;
+            job.sample_rate = sample_rate_;
+            int duration_ms = final_result.end_ms - final_result.start_ms;
+            if (model_.need_rescore_(final_result.confidence, duration_ms))
+                cut_history_(final_result.start_ms, final_result.end_ms, job.pcm);
+            job.final_result = std::move(final_result);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+            cond_.notify_all();
+        }
+    }
+
+    bool result(std::string& partial_text) {
+        return first_pass_->result(partial_text);
+    }
+
+    void set_endpoint(const AX_ASR_ENDPOINT_CONFIG_T& config) {
+        std::lock_guard<std::mutex> feed_lock(feed_mutex_);
+        max_utterance_ms_ = config.max_utterance_ms > 0 ? config.max_utterance_ms : 20000;
+        first_pass_->set_endpoint(config);
+    }
+
+    using ASRStream::pop_final;
+    bool pop_final(ASRFinalResult& final_result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (finals_.empty()) return false;
+        final_result = std::move(finals_.front());
+        finals_.pop_front();
+        return true;
+    }
+
+    void reset(void) {
+        std::lock_guard<std::mutex> feed_lock(feed_mutex_);
+        first_pass_->reset();
+        history_.clear();
+        history_start_ = 0;
+
+        // A job already in Whisper finishes, but its result is dropped
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_++;
+        jobs_.clear();
+        finals_.clear();
+    }
+
+private:
+    struct Job {
+        unsigned generation;
+        ASRFinalResult final_result;
+        std::vector<float> pcm;             // empty if the first pass is kept
+        int sample_rate;
+    };
+
+    // Keep at least the last max_utterance_ms_ of audio, indexed by stream
+    // time, so a final can be decoded again after the first pass has dropped it
+    void keep_history_(const float* pcm, size_t num_samples, int sample_rate) {
+        if (sample_rate != sample_rate_) {
+            // Stream time cannot be mapped across a rate change, start over
+            if (!history_.empty() || history_start_ > 0)
+                ALOGW("Sample rate changed from %d to %d, cascade history restarted", sample_rate_, sample_rate);
+            sample_rate_ = sample_rate;
+            history_start_ += history_.size();
+            history_.clear();
+        }
+        history_.insert(history_.end(), pcm, pcm + num_samples);
+
+        // Trimmed only once twice the window has built up, so the move of
+        // the kept audio is paid once per window rather than on every feed
+        size_t keep = (size_t)(max_utterance_ms_ + CASCADE_HISTORY_MARGIN_MS) * sample_rate_ / 1000;
+        if (history_.size() > 2 * keep) {
+            size_t drop = history_.size() - keep;
+            history_.erase(history_.begin(), history_.begin() + drop);
+            history_start_ += drop;
+        }
+    }
+
+    void cut_history_(int start_ms, int end_ms, std::vector<float>& pcm) const {
+        int64_t begin = (int64_t)start_ms * sample_rate_ / 1000 - (int64_t)history_start_;
+        int64_t end = (int64_t)end_ms * sample_rate_ / 1000 - (int64_t)history_start_;
+        begin = std::max<int64_t>(begin, 0);
+        end = std::min<int64_t>(end, history_.size());
+        if (end > begin)
+            pcm.assign(history_.begin() + begin, history_.begin() + end);
+    }
+
+    void loop_(void) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cond_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+            if (stop_)
+                break;
+
+            Job job = std::move(jobs_.front());
+            jobs_.pop_front();
+
+            if (!job.pcm.empty()) {
+                lock.unlock();
+                ALOGD("Cascade: final %d-%dms confidence %.3f, rescore with whisper",
+                      job.final_result.start_ms, job.final_result.end_ms, job.final_result.confidence);
+                // Keeps the first pass text on failure
+                model_.rescore_(job.pcm, job.sample_rate, job.final_result.language, job.final_result.text);
+                lock.lock();
+            }
+
+            if (job.generation != generation_)
+                continue;
+            if (finals_.size() >= MAX_PENDING_FINALS) {
+                ALOGW("Final results not consumed, drop the oldest one");
+                finals_.pop_front();
+            }
+            finals_.push_back(std::move(job.final_result));
+        }
+    }
+
+private:
+    static constexpr size_t MAX_PENDING_FINALS = 64;
+
+    Cascade::Impl& model_;
+    std::unique_ptr<ASRStream> first_pass_;
+
+    // Held by feed(), reset() and set_endpoint() for everything below up to
+    // mutex_, so they may come from different threads (an async worker
+    // feeding, the application resetting). Taken before mutex_.
+    std::mutex feed_mutex_;
+    int max_utterance_ms_ = 20000;
+    std::vector<float> history_;            // latest audio at sample_rate_
+    size_t history_start_ = 0;              // stream sample index of history_[0]
+    int sample_rate_ = 0;
+
+    // Shared with the worker
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<Job> jobs_;
+    std::deque<ASRFinalResult> finals_;     // finals ready to pop, in order
+    unsigned generation_ = 0;               // bumped by reset()
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+Cascade::Cascade():
+    impl_(std::make_unique<Cascade::Impl>()) {
+
+}
+
+Cascade::~Cascade() {
+    uninit();
+}
+
+bool Cascade::init(AX_ASR_TYPE_E asr_type, const std::string& model_path) {
+    return impl_->init(asr_type, model_path);
+}
+
+void Cascade::uninit(void) {
+    impl_->uninit();
+}
+
+bool Cascade::run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) {
+    return impl_->run(audio_data, sample_rate, language, text_result);
+}
+
+bool Cascade::set_param(const std::string& key, const std::string& value) {
+    return impl_->set_param(key, value);
+}
+
+std::unique_ptr<ASRStream> Cascade::create_stream() {
+    return std::make_unique<CascadeStream>(*impl_);
+}
+
+// Both passes live under the model root
+void register_cascade_models(ASRRegistry& registry) {
+    registry.add({"sensevoice_whisper_small", "sensevoice_whisper_small", AX_SENSEVOICE_WHISPER_SMALL, "",
+                  {"sensevoice/sensevoice.axmodel", "whisper/small/small-encoder.axmodel"},
+                  [] { return static_cast<ASRInterface*>(new Cascade()); }});
+    registry.add({"sensevoice_whisper_turbo", "sensevoice_whisper_turbo", AX_SENSEVOICE_WHISPER_TURBO, "",
+                  {"sensevoice/sensevoice.axmodel", "whisper/turbo/turbo-encoder.axmodel"},
+                  [] { return static_cast<ASRInterface*>(new Cascade()); }});
+}
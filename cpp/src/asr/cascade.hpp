@@ -0,0 +1,36 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <memory>
+
+#include "asr/asr_interface.hpp"
+
+// Two pass recognition: SenseVoice gives fast partials, utterances it is not
+// confident about are decoded again by Whisper once they are final.
+//
+// model_path is the root that holds both sensevoice/ and whisper/<size>/.
+class Cascade : public ASRInterface {
+public:
+    Cascade();
+    ~Cascade();
+
+    int sample_rate()   { return 16000; }
+    bool init(AX_ASR_TYPE_E asr_type, const std::string& model_path);
+    void uninit(void);
+    bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result);
+    bool set_param(const std::string& key, const std::string& value);
+    std::unique_ptr<ASRStream> create_stream();
+
+private:
+    friend class CascadeStream;
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
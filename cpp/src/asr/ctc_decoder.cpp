@@ -0,0 +1,53 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <cmath>
+#include <cstddef>
+
+#include "asr/ctc_decoder.hpp"
+#include "utils/simd.hpp"
+
+int CtcGreedyDecoder::decode(const float* logits, int num_frames, int vocab_size, int frame_offset,
+                             std::vector<CtcToken>& tokens, bool with_prob) const {
+    if (!logits || num_frames <= 0 || vocab_size <= 0)
+        return 0;
+
+    const size_t old_size = tokens.size();
+    int prev = blank_id_;
+    for (int t = 0; t < num_frames; t++) {
+        const float* row = logits + (size_t)t * vocab_size;
+        int id = utils::argmax_f32(row, vocab_size);
+        if (id == prev) {
+            // Repeat of the open token extends it, repeated blanks do nothing
+            if (id != blank_id_)
+                tokens.back().end = frame_offset + t + 1;
+            continue;
+        }
+
+        if (id != blank_id_) {
+            CtcToken token;
+            token.id = id;
+            token.start = frame_offset + t;
+            token.end = frame_offset + t + 1;
+            token.prob = with_prob ? softmax_max_(row, vocab_size, row[id]) : -1.0f;
+            tokens.push_back(token);
+        }
+        prev = id;
+    }
+    return tokens.size() - old_size;
+}
+
+float CtcGreedyDecoder::softmax_max_(const float* row, int vocab_size, float max_value) {
+    // p(argmax) = 1 / sum(exp(x - max))
+    float sum = 0.0f;
+    for (int i = 0; i < vocab_size; i++) {
+        sum += expf(row[i] - max_value);
+    }
+    return 1.0f / sum;
+}
@@ -0,0 +1,44 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <vector>
+
+// One emitted CTC token and the output frames it was the best path over
+struct CtcToken {
+    int id;
+    int start;      // first frame
+    int end;        // one past the last frame
+    float prob;     // posterior at the first frame, -1 if not requested
+};
+
+// Greedy CTC decoding in a single pass over the logits.
+//
+// Each frame is reduced to its argmax, blanks are skipped and repeats merged
+// on the fly, so no per-frame id sequence is built. The frame range of every
+// token falls out of the same pass and gives token timestamps for free.
+class CtcGreedyDecoder {
+public:
+    explicit CtcGreedyDecoder(int blank_id = 0): blank_id_(blank_id) {}
+
+    // logits: [num_frames, vocab_size] row major.
+    // Tokens are appended to tokens with frame_offset added to their frames.
+    // with_prob adds a softmax over the frame where each token starts, which
+    // costs one exp per vocabulary entry and token.
+    // Returns number of tokens appended.
+    int decode(const float* logits, int num_frames, int vocab_size, int frame_offset,
+               std::vector<CtcToken>& tokens, bool with_prob = false) const;
+
+private:
+    static float softmax_max_(const float* row, int vocab_size, float max_value);
+
+private:
+    int blank_id_;
+};
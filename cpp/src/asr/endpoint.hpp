@@ -0,0 +1,116 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "api/ax_asr_api.h"
+
+// Decides when a streaming utterance is complete.
+//
+// Trailing silence is taken from two sources and the longer one wins:
+//   - CTC: output frames after the last non-blank frame
+//   - energy: consecutive 10ms PCM blocks below silence_dbfs
+// The detector itself holds no audio, the stream reports what it decoded.
+class EndpointDetector {
+public:
+    enum Decision {
+        ENDPOINT_NONE = 0,
+        ENDPOINT_FINALIZE,      // emit the utterance as final result
+        ENDPOINT_DISCARD        // drop the utterance, it holds no real speech
+    };
+
+    EndpointDetector() {
+        AX_ASR_ENDPOINT_CONFIG_T config = {};
+        set_config(config);
+    }
+
+    void set_config(const AX_ASR_ENDPOINT_CONFIG_T& config) {
+        config_ = config;
+        if (config_.min_trailing_silence_ms <= 0)
+            config_.min_trailing_silence_ms = 800;
+        if (config_.max_utterance_ms <= 0)
+            config_.max_utterance_ms = 20000;
+        if (config_.min_speech_ms <= 0)
+            config_.min_speech_ms = 200;
+        if (config_.silence_dbfs >= 0)
+            config_.silence_dbfs = -50.0f;
+
+        // RMS threshold compared against mean square to avoid a sqrt per block
+        float rms = powf(10.0f, config_.silence_dbfs / 20.0f);
+        silence_power_ = rms * rms;
+    }
+
+    inline bool enabled() const {
+        return config_.enable != 0;
+    }
+
+    // Track trailing silence on the raw input, pcm in [-1.0, 1.0]
+    void accept_waveform(const float* pcm, int num_samples, int sample_rate) {
+        accept_samples_(pcm, num_samples, sample_rate, 1.0f);
+    }
+
+    // Same for 16 bit PCM
+    void accept_waveform(const int16_t* pcm, int num_samples, int sample_rate) {
+        accept_samples_(pcm, num_samples, sample_rate, 1.0f / (32768.0f * 32768.0f));
+    }
+
+    // utterance_ms: audio decoded for the current utterance
+    // speech_ms:    span from first to last non-blank CTC frame, 0 if none
+    // trailing_ms:  blank CTC frames after the last non-blank one
+    Decision detect(int utterance_ms, int speech_ms, int trailing_ms) const {
+        if (!enabled())
+            return ENDPOINT_NONE;
+
+        int silence_ms = std::max(trailing_ms, (int)energy_silence_ms_);
+        bool has_speech = speech_ms >= config_.min_speech_ms;
+
+        if (silence_ms >= config_.min_trailing_silence_ms || utterance_ms >= config_.max_utterance_ms)
+            return has_speech ? ENDPOINT_FINALIZE : ENDPOINT_DISCARD;
+        return ENDPOINT_NONE;
+    }
+
+    // Called once the utterance has been finalized or discarded
+    void reset() {
+        energy_silence_ms_ = 0;
+    }
+
+private:
+    // power_scale brings the mean square of a block to full scale 1.0
+    template <typename T>
+    void accept_samples_(const T* pcm, int num_samples, int sample_rate, float power_scale) {
+        if (!enabled() || !pcm || num_samples <= 0 || sample_rate <= 0)
+            return;
+
+        // 10ms blocks, at least one sample so odd low rates still advance
+        int block = std::max(1, sample_rate / 100);
+        for (int i = 0; i < num_samples; i += block) {
+            int n = std::min(block, num_samples - i);
+            float power = 0.0f;
+            for (int j = 0; j < n; j++) {
+                float x = pcm[i + j];
+                power += x * x;
+            }
+            power = power * power_scale / n;
+
+            if (power < silence_power_)
+                energy_silence_ms_ += n * 1000.0 / sample_rate;
+            else
+                energy_silence_ms_ = 0;
+        }
+    }
+
+private:
+    AX_ASR_ENDPOINT_CONFIG_T config_;
+    float silence_power_;
+    double energy_silence_ms_ = 0;
+};
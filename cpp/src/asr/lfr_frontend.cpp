@@ -0,0 +1,404 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "asr/lfr_frontend.hpp"
+#include "utils/logger.h"
+#include "utils/pcm_convert.hpp"
+#include "utils/resample.h"
+#include "utils/simd.hpp"
+#include "kaldi-native-fbank/csrc/online-feature.h"
+
+// CMVN statistics of one 80-bin fbank frame shared by the FunASR 16k
+// models, the LFR frame stacks lfr_window_size fbank frames and repeats them
+static const float kNegMean[80] = {
+    -8.311879, -8.600912, -9.615928, -10.43595, -11.21292, -11.88333, -12.36243, -12.63706, -12.8818, -12.83066,
+    -12.89103, -12.95666, -13.19763, -13.40598, -13.49113, -13.5546, -13.55639, -13.51915, -13.68284, -13.53289,
+    -13.42107, -13.65519, -13.50713, -13.75251, -13.76715, -13.87408, -13.73109, -13.70412, -13.56073, -13.53488,
+    -13.54895, -13.56228, -13.59408, -13.62047, -13.64198, -13.66109, -13.62669, -13.58297, -13.57387, -13.4739,
+    -13.53063, -13.48348, -13.61047, -13.64716, -13.71546, -13.79184, -13.90614, -14.03098, -14.18205, -14.35881,
+    -14.48419, -14.60172, -14.70591, -14.83362, -14.92122, -15.00622, -15.05122, -15.03119, -14.99028, -14.92302,
+    -14.86927, -14.82691, -14.7972, -14.76909, -14.71356, -14.61277, -14.51696, -14.42252, -14.36405, -14.30451,
+    -14.23161, -14.19851, -14.16633, -14.15649, -14.10504, -13.99518, -13.79562, -13.3996, -12.7767, -11.71208,
+};
+
+static const float kInvStddev[80] = {
+    0.155775, 0.154484, 0.1527379, 0.1518718, 0.1506028, 0.1489256, 0.147067, 0.1447061, 0.1436307, 0.1443568,
+    0.1451849, 0.1455157, 0.1452821, 0.1445717, 0.1439195, 0.1435867, 0.1436018, 0.1438781, 0.1442086, 0.1448844,
+    0.1454756, 0.145663, 0.146268, 0.1467386, 0.1472724, 0.147664, 0.1480913, 0.1483739, 0.1488841, 0.1493636,
+    0.1497088, 0.1500379, 0.1502916, 0.1505389, 0.1506787, 0.1507102, 0.1505992, 0.1505445, 0.1505938, 0.1508133,
+    0.1509569, 0.1512396, 0.1514625, 0.1516195, 0.1516156, 0.1515561, 0.1514966, 0.1513976, 0.1512612, 0.151076,
+    0.1510596, 0.1510431, 0.151077, 0.1511168, 0.1511917, 0.151023, 0.1508045, 0.1505885, 0.1503493, 0.1502373,
+    0.1501726, 0.1500762, 0.1500065, 0.1499782, 0.150057, 0.1502658, 0.150469, 0.1505335, 0.1505505, 0.1505328,
+    0.1504275, 0.1502438, 0.1499674, 0.1497118, 0.1494661, 0.1493102, 0.1493681, 0.1495501, 0.1499738, 0.1509654,
+};
+
+
+class LfrFrontend::Impl {
+public:
+    explicit Impl(const LfrFrontendConfig& config):
+        config_(config) {
+        feature_dim_ = config_.n_mels * config_.lfr_window_size;
+        if ((int)config_.neg_mean.size() != feature_dim_ ||
+            (int)config_.inv_stddev.size() != feature_dim_) {
+            ALOGW("CMVN dim mismatch: neg_mean=%zu inv_stddev=%zu feature_dim=%d, CMVN disabled",
+                config_.neg_mean.size(), config_.inv_stddev.size(), feature_dim_);
+            config_.neg_mean.assign(feature_dim_, 0.0f);
+            config_.inv_stddev.assign(feature_dim_, 1.0f);
+        }
+
+        // (x + neg_mean) * inv_stddev == x * scale + bias, one multiply-add per value
+        cmvn_scale_ = config_.inv_stddev;
+        cmvn_bias_.resize(feature_dim_);
+        for (int i = 0; i < feature_dim_; i++) {
+            cmvn_bias_[i] = config_.neg_mean[i] * config_.inv_stddev[i];
+        }
+        reset();
+    }
+
+    void reset(void) {
+        knf::FbankOptions opts;
+        opts.frame_opts.dither = config_.dither_mode == LFR_DITHER_RANDOM ? config_.dither : 0.0f;
+        opts.frame_opts.snip_edges = config_.snip_edges;
+        opts.frame_opts.samp_freq = config_.sample_rate;
+        opts.frame_opts.frame_shift_ms = 10;
+        opts.frame_opts.frame_length_ms = 25;
+        opts.frame_opts.remove_dc_offset = true;
+        opts.frame_opts.window_type = config_.window_type;
+
+        opts.mel_opts.num_bins = config_.n_mels;
+
+        opts.mel_opts.high_freq = config_.high_freq;
+        opts.mel_opts.low_freq = 20;
+        opts.mel_opts.is_librosa = false;
+
+        fbank_ = std::make_unique<knf::OnlineFbank>(opts);
+        fbank_frames_popped_ = 0;
+
+        resampler_.reset();
+        resampler_in_rate_ = 0;
+
+        ring_.clear();
+        ring_head_ = 0;
+        finished_ = false;
+        dither_state_ = DITHER_SEED;
+    }
+
+    void accept_waveform(const float* pcm, int num_samples, int sample_rate) {
+        if (!can_accept_(pcm, num_samples, sample_rate))
+            return;
+
+        scaled_.resize(num_samples);
+        utils::scale_f32(pcm, config_.input_scale, scaled_.data(), num_samples);
+        accept_scaled_(scaled_.data(), num_samples, sample_rate);
+    }
+
+    void accept_waveform_inplace(float* pcm, int num_samples, int sample_rate) {
+        if (!can_accept_(pcm, num_samples, sample_rate))
+            return;
+
+        utils::scale_f32(pcm, config_.input_scale, pcm, num_samples);
+        accept_scaled_(pcm, num_samples, sample_rate);
+    }
+
+    void accept_waveform_s16(const int16_t* pcm, int num_samples, int sample_rate) {
+        if (!can_accept_(pcm, num_samples, sample_rate))
+            return;
+
+        scaled_.resize(num_samples);
+        utils::s16_to_f32(pcm, num_samples, config_.input_scale / 32768.0f, scaled_.data());
+        accept_scaled_(scaled_.data(), num_samples, sample_rate);
+    }
+
+    void input_finished(void) {
+        if (finished_)
+            return;
+        flush_resampler_();
+        fbank_->InputFinished();
+        drain_fbank_();
+        finished_ = true;
+    }
+
+    int num_frames_ready(void) const {
+        int n = ring_frames_();
+        if (n < config_.lfr_window_size)
+            return 0;
+        return (n - config_.lfr_window_size) / config_.lfr_window_shift + 1;
+    }
+
+    int pop_frames(std::vector<float>& out, int max_frames) {
+        int n = num_frames_ready();
+        if (max_frames >= 0)
+            n = std::min(n, max_frames);
+        if (n <= 0)
+            return 0;
+
+        size_t base = out.size();
+        out.resize(base + (size_t)n * feature_dim_);
+        return pop_frames(out.data() + base, n);
+    }
+
+    int pop_frames(float* out, int max_frames) {
+        int n = std::min(num_frames_ready(), max_frames);
+        if (n <= 0)
+            return 0;
+
+        const int shift = config_.lfr_window_shift * config_.n_mels;
+
+        // LFR frame i is lfr_window_size consecutive fbank frames, which are
+        // contiguous in the ring, so stacking and CMVN are one pass
+        const float* src = ring_.data() + ring_head_;
+        float* dst = out;
+        for (int i = 0; i < n; i++) {
+            utils::affine_f32(src, cmvn_scale_.data(), cmvn_bias_.data(), dst, feature_dim_);
+            src += shift;
+            dst += feature_dim_;
+        }
+
+        ring_head_ += (size_t)n * shift;
+        compact_ring_();
+        return n;
+    }
+
+    inline int feature_dim(void) const {
+        return feature_dim_;
+    }
+
+private:
+    bool can_accept_(const void* pcm, int num_samples, int sample_rate) const {
+        if (finished_) {
+            ALOGW("accept_waveform after input_finished, call reset() first");
+            return false;
+        }
+        return pcm && num_samples > 0 && sample_rate > 0;
+    }
+
+    // samples: scaled by input_scale, may be dithered in place
+    void accept_scaled_(float* samples, int num_samples, int sample_rate) {
+        if (sample_rate != config_.sample_rate) {
+            if (!resampler_ || resampler_in_rate_ != sample_rate) {
+                flush_resampler_();
+                ALOGD("Stream resample: %d -> %d", sample_rate, config_.sample_rate);
+                float min_freq = std::min<int32_t>(sample_rate, config_.sample_rate);
+                float lowpass_cutoff = 0.99 * 0.5 * min_freq;
+                int32_t lowpass_filter_width = 6;
+                resampler_ = std::make_unique<utils::LinearResample>(
+                    sample_rate, config_.sample_rate, lowpass_cutoff, lowpass_filter_width);
+                resampler_in_rate_ = sample_rate;
+            }
+            resampler_->Resample(samples, num_samples, false, &resampled_);
+            accept_fbank_(resampled_.data(), resampled_.size());
+        } else {
+            flush_resampler_();
+            accept_fbank_(samples, num_samples);
+        }
+
+        drain_fbank_();
+    }
+
+    void flush_resampler_(void) {
+        if (!resampler_)
+            return;
+        resampler_->Resample(nullptr, 0, true, &resampled_);
+        if (!resampled_.empty())
+            accept_fbank_(resampled_.data(), resampled_.size());
+        resampler_.reset();
+        resampler_in_rate_ = 0;
+    }
+
+    void accept_fbank_(float* samples, int num_samples) {
+        if (config_.dither_mode == LFR_DITHER_DETERMINISTIC && config_.dither > 0.0f) {
+            // Triangular noise from two xorshift32 draws, scaled to unit
+            // variance: var(u1 - u2) = 1/6 for u uniform in [0, 1)
+            const float scale = config_.dither * 2.449490f / 4294967296.0f;
+            uint32_t x = dither_state_;
+            for (int i = 0; i < num_samples; i++) {
+                x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+                uint32_t a = x;
+                x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+                samples[i] += ((float)a - (float)x) * scale;
+            }
+            dither_state_ = x;
+        }
+        fbank_->AcceptWaveform(config_.sample_rate, samples, num_samples);
+    }
+
+    // Move newly computed fbank frames into the ring and release them from knf
+    void drain_fbank_(void) {
+        int32_t ready = fbank_->NumFramesReady();
+        if (ready <= fbank_frames_popped_)
+            return;
+
+        const int n_mels = config_.n_mels;
+        ring_.reserve(ring_.size() + (size_t)(ready - fbank_frames_popped_) * n_mels);
+        for (int32_t i = fbank_frames_popped_; i < ready; i++) {
+            const float* f = fbank_->GetFrame(i);
+            ring_.insert(ring_.end(), f, f + n_mels);
+        }
+        fbank_->Pop(ready - fbank_frames_popped_);
+        fbank_frames_popped_ = ready;
+    }
+
+    inline int ring_frames_(void) const {
+        return (int)((ring_.size() - ring_head_) / config_.n_mels);
+    }
+
+    void compact_ring_(void) {
+        if (ring_head_ == 0)
+            return;
+        if (ring_head_ * 2 < ring_.size() && ring_head_ < 4096)
+            return;
+        ring_.erase(ring_.begin(), ring_.begin() + ring_head_);
+        ring_head_ = 0;
+    }
+
+private:
+    static constexpr uint32_t DITHER_SEED = 0x9E3779B9u;
+
+    LfrFrontendConfig config_;
+    int feature_dim_;
+    std::vector<float> cmvn_scale_;
+    std::vector<float> cmvn_bias_;
+    uint32_t dither_state_;
+
+    std::unique_ptr<knf::OnlineFbank> fbank_;
+    int32_t fbank_frames_popped_;
+
+    std::unique_ptr<utils::LinearResample> resampler_;
+    int resampler_in_rate_;
+
+    // fbank frames not yet consumed by LFR, [n, n_mels]
+    std::vector<float> ring_;
+    size_t ring_head_;
+
+    std::vector<float> scaled_;
+    std::vector<float> resampled_;
+    bool finished_;
+};
+
+LfrFrontend::LfrFrontend(const LfrFrontendConfig& config):
+    impl_(std::make_unique<LfrFrontend::Impl>(config)) {
+
+}
+
+LfrFrontend::~LfrFrontend() = default;
+
+void LfrFrontend::reset() {
+    impl_->reset();
+}
+
+void LfrFrontend::accept_waveform(const float* pcm, int num_samples, int sample_rate) {
+    impl_->accept_waveform(pcm, num_samples, sample_rate);
+}
+
+void LfrFrontend::accept_waveform_inplace(float* pcm, int num_samples, int sample_rate) {
+    impl_->accept_waveform_inplace(pcm, num_samples, sample_rate);
+}
+
+void LfrFrontend::accept_waveform_s16(const int16_t* pcm, int num_samples, int sample_rate) {
+    impl_->accept_waveform_s16(pcm, num_samples, sample_rate);
+}
+
+void LfrFrontend::input_finished() {
+    impl_->input_finished();
+}
+
+int LfrFrontend::num_frames_ready() const {
+    return impl_->num_frames_ready();
+}
+
+int LfrFrontend::pop_frames(std::vector<float>& out, int max_frames) {
+    return impl_->pop_frames(out, max_frames);
+}
+
+int LfrFrontend::pop_frames(float* out, int max_frames) {
+    return impl_->pop_frames(out, max_frames);
+}
+
+int LfrFrontend::feature_dim() const {
+    return impl_->feature_dim();
+}
+
+LfrFrontendConfig funasr_frontend_config(LfrDitherMode dither_mode) {
+    LfrFrontendConfig config;
+    config.sample_rate = 16000;
+    config.n_mels = 80;
+    config.lfr_window_size = 7;
+    config.lfr_window_shift = 6;
+    config.dither = 1.0f;
+    config.dither_mode = dither_mode;
+
+    config.neg_mean.reserve(config.n_mels * config.lfr_window_size);
+    config.inv_stddev.reserve(config.n_mels * config.lfr_window_size);
+    for (int i = 0; i < config.lfr_window_size; i++) {
+        config.neg_mean.insert(config.neg_mean.end(), kNegMean, kNegMean + config.n_mels);
+        config.inv_stddev.insert(config.inv_stddev.end(), kInvStddev, kInvStddev + config.n_mels);
+    }
+    return config;
+}
+
+LfrFrontendConfig icefall_frontend_config(int n_mels) {
+    LfrFrontendConfig config;
+    config.sample_rate = 16000;
+    config.n_mels = n_mels;
+    config.lfr_window_size = 1;
+    config.lfr_window_shift = 1;
+    config.dither = 0.0f;
+    config.dither_mode = LFR_DITHER_NONE;
+    config.window_type = "povey";
+    config.input_scale = 1.0f;
+    config.snip_edges = false;
+    config.high_freq = -400.0f;
+    config.neg_mean.assign(n_mels, 0.0f);
+    config.inv_stddev.assign(n_mels, 1.0f);
+    return config;
+}
+
+// am.mvn is a kaldi nnet1 text model:
+//   <AddShift> ... <LearnRateCoef> 0 [ neg_mean ... ]
+//   <Rescale> ... <LearnRateCoef> 0 [ inv_stddev ... ]
+bool load_funasr_cmvn(const std::string& am_mvn_path, LfrFrontendConfig& config) {
+    std::ifstream fs(am_mvn_path);
+    if (!fs.is_open())
+        return false;
+
+    std::vector<float> neg_mean, inv_stddev;
+    std::vector<float>* target = nullptr;
+    bool in_values = false;
+    std::string word;
+    while (fs >> word) {
+        if (word == "<AddShift>") {
+            target = &neg_mean;
+        } else if (word == "<Rescale>") {
+            target = &inv_stddev;
+        } else if (word == "[") {
+            in_values = target != nullptr;
+        } else if (word == "]") {
+            in_values = false;
+            target = nullptr;
+        } else if (in_values) {
+            target->push_back(strtof(word.c_str(), nullptr));
+        }
+    }
+
+    const size_t dim = (size_t)config.n_mels * config.lfr_window_size;
+    if (neg_mean.size() != dim || inv_stddev.size() != dim) {
+        ALOGE("CMVN in %s has %zu/%zu values, expect %zu", am_mvn_path.c_str(), neg_mean.size(), inv_stddev.size(), dim);
+        return false;
+    }
+    config.neg_mean = std::move(neg_mean);
+    config.inv_stddev = std::move(inv_stddev);
+    return true;
+}
@@ -0,0 +1,97 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum LfrDitherMode {
+    LFR_DITHER_RANDOM = 0,          // kaldi-native-fbank internal RNG, features differ between runs
+    LFR_DITHER_DETERMINISTIC,       // seeded generator restarted by reset(), same audio gives same features
+    LFR_DITHER_NONE
+};
+
+struct LfrFrontendConfig {
+    int sample_rate = 16000;
+    int n_mels = 80;
+    int lfr_window_size = 7;
+    int lfr_window_shift = 6;
+    float dither = 1.0f;            // standard deviation, in units of the scaled input
+    LfrDitherMode dither_mode = LFR_DITHER_DETERMINISTIC;
+    std::string window_type = "hamming";    // fbank analysis window, kaldi names
+    float input_scale = 32768.0f;   // [-1.0, 1.0] PCM is multiplied by this before fbank
+    bool snip_edges = true;         // false: frames centered on multiples of the shift, kaldi semantics
+    float high_freq = 0.0f;         // mel upper edge in Hz, <= 0 is relative to Nyquist
+
+    // [n_mels * lfr_window_size], applied as (x + neg_mean) * inv_stddev
+    std::vector<float> neg_mean;
+    std::vector<float> inv_stddev;
+};
+
+// Front end of the FunASR 16k models (SenseVoice, Paraformer): 80 bin
+// fbank, LFR 7/6 and the CMVN they were trained with
+LfrFrontendConfig funasr_frontend_config(LfrDitherMode dither_mode);
+
+// Front end of the icefall models (Zipformer): kaldifeat fbank defaults,
+// [-1, 1] input, frames centered on the shift, mel bins up to 400Hz below
+// Nyquist, no LFR, CMVN or dither
+LfrFrontendConfig icefall_frontend_config(int n_mels);
+
+// Replace the CMVN of config with the one in a FunASR am.mvn file
+bool load_funasr_cmvn(const std::string& am_mvn_path, LfrFrontendConfig& config);
+
+// Fbank + LFR + CMVN feature pipeline that keeps its state across calls.
+//
+// PCM can be fed in chunks of any size and at any sample rate. The resampler
+// remainder, the fbank frame window and the LFR stacking window are carried
+// over between calls, so feeding a signal chunk by chunk yields the same
+// frames as feeding it at once.
+class LfrFrontend {
+public:
+    explicit LfrFrontend(const LfrFrontendConfig& config);
+    ~LfrFrontend();
+
+    // Drop all carried state, ready for a new signal
+    void reset();
+
+    // pcm: mono float PCM in [-1.0, 1.0], resampled to config.sample_rate internally
+    void accept_waveform(const float* pcm, int num_samples, int sample_rate);
+
+    // Same as accept_waveform(), for a buffer the caller is done with: pcm
+    // is scaled by config.input_scale and dithered in place rather than copied
+    void accept_waveform_inplace(float* pcm, int num_samples, int sample_rate);
+
+    // Same as accept_waveform() for 16 bit PCM, scaled by
+    // config.input_scale / 32768 in the same pass as the conversion
+    void accept_waveform_s16(const int16_t* pcm, int num_samples, int sample_rate);
+
+    // Flush the resampler tail. No more audio may be accepted until reset().
+    void input_finished();
+
+    // Number of LFR frames that can be popped now
+    int num_frames_ready() const;
+
+    // Append up to max_frames (all if < 0) normalized LFR frames to out.
+    // Returns number of frames appended.
+    int pop_frames(std::vector<float>& out, int max_frames = -1);
+
+    // Write up to max_frames normalized LFR frames to out, which must hold
+    // max_frames * feature_dim() floats. Returns number of frames written.
+    int pop_frames(float* out, int max_frames);
+
+    // n_mels * lfr_window_size
+    int feature_dim() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
@@ -0,0 +1,455 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+#include "asr/paraformer.hpp"
+#include "asr/asr_registry.hpp"
+#include "asr/lfr_frontend.hpp"
+#include "ax_model_runner/ax_model_runner.hpp"
+#include "utils/energy_vad.hpp"
+#include "utils/logger.h"
+#include "utils/simd.hpp"
+
+// CIF fires a token each time the accumulated weight reaches the threshold,
+// the tail weight lets the last partial token fire at the end of input
+#define PARAFORMER_CIF_THRESHOLD    1.0f
+#define PARAFORMER_CIF_TAIL         0.45f
+
+// Features of one batch item and the frame ranges to decode
+struct ParaformerPrepared : public ASRPrepared {
+    std::vector<float> features;
+    std::vector<std::pair<int, int>> ranges;
+};
+
+// pImpl
+class Paraformer::Impl {
+    friend class Paraformer;
+public:
+    bool init(AX_ASR_TYPE_E /*asr_type*/, const std::string& model_path) {
+        if (!load_models_(model_path + "/encoder.axmodel", model_path + "/predictor.axmodel",
+                          model_path + "/decoder.axmodel"))
+            return false;
+
+        // encoder: speech [1, T, 560], mask [1, T] -> encoder_out [1, T, D]
+        auto input_shape = encoder_.get_input_shape(0);
+        max_seq_len_ = input_shape[1];
+        feature_dim_ = input_shape[2];
+        enc_dim_ = encoder_.get_output_shape(0)[2];
+
+        // decoder: encoder_out, mask, acoustic_embeds [1, N, D], token mask [1, N] -> logits [1, N, V]
+        max_tokens_ = decoder_.get_input_shape(2)[1];
+        vocab_size_ = decoder_.get_output_shape(0)[2];
+
+        frontend_config_ = funasr_frontend_config(dither_mode_);
+        if (frontend_config_.n_mels * frontend_config_.lfr_window_size != feature_dim_) {
+            ALOGE("Encoder expects %d dim features, front end gives %d", feature_dim_,
+                  frontend_config_.n_mels * frontend_config_.lfr_window_size);
+            return false;
+        }
+        // Models exported with their own statistics ship them as am.mvn
+        if (load_funasr_cmvn(model_path + "/am.mvn", frontend_config_))
+            ALOGI("Paraformer: CMVN from %s/am.mvn", model_path.c_str());
+
+        if (!load_tokens_(model_path + "/tokens.txt")) {
+            ALOGE("Load tokens from %s/tokens.txt failed!", model_path.c_str());
+            return false;
+        }
+
+        feat_.resize((size_t)max_seq_len_ * feature_dim_);
+        mask_.resize(max_seq_len_);
+        enc_out_.resize((size_t)max_seq_len_ * enc_dim_);
+        alphas_.resize(max_seq_len_);
+        acoustic_embeds_.resize((size_t)max_tokens_ * enc_dim_);
+        token_mask_.resize(max_tokens_);
+        logits_.resize((size_t)max_tokens_ * vocab_size_);
+
+        // A segment plus LFR rounding on both ends must fit in one encoder run
+        vad_config_.max_segment_ms = (max_seq_len_ - 2) * frontend_config_.lfr_window_shift * 10;
+
+        ALOGI("Paraformer: %d frames, %d tokens per run, vocab %d", max_seq_len_, max_tokens_, vocab_size_);
+        return true;
+    }
+
+    void uninit(void) {
+        encoder_.unload_model();
+        predictor_.unload_model();
+        decoder_.unload_model();
+    }
+
+    bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) {
+        std::vector<float> audio;
+        utils::resample(audio_data.data(), audio_data.size(), sample_rate, frontend_config_.sample_rate, audio);
+        return run_native(audio, language, text_result);
+    }
+
+    bool run_native(std::vector<float>& audio, const std::string& /*language*/, std::string& text_result) {
+        ParaformerPrepared item;
+        extract_(audio, item.features, item.ranges);
+        return decode_ranges_(item.features, item.ranges, text_result);
+    }
+
+    // extract_() runs on the pipeline threads, only the decoders wait for
+    // the NPU
+    std::unique_ptr<ASRPrepared> prepare(std::vector<float>& audio) {
+        auto item = std::make_unique<ParaformerPrepared>();
+        extract_(audio, item->features, item->ranges);
+        std::vector<float>().swap(audio);
+        return item;
+    }
+
+    bool run_prepared(std::vector<std::unique_ptr<ASRPrepared>>& items, const std::string& /*language*/,
+                      std::vector<std::string>& text_results) {
+        text_results.assign(items.size(), std::string());
+        for (size_t i = 0; i < items.size(); i++) {
+            auto& item = static_cast<ParaformerPrepared&>(*items[i]);
+            if (!decode_ranges_(item.features, item.ranges, text_results[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // audio is at frontend_config_.sample_rate, VAD reads it before the
+    // frontend scales it in place. ranges: [start, end) LFR frames, each
+    // fits one encoder run
+    void extract_(std::vector<float>& audio, std::vector<float>& features, std::vector<std::pair<int, int>>& ranges) {
+        const int sample_rate = frontend_config_.sample_rate;
+        LfrFrontendConfig frontend_config;
+        bool vad_enabled;
+        utils::EnergyVadConfig vad_config;
+        {
+            std::lock_guard<std::mutex> lock(param_mutex_);
+            frontend_config = frontend_config_;
+            vad_enabled = vad_enabled_;
+            vad_config = vad_config_;
+        }
+
+        std::vector<utils::VadSegment> segments;
+        if (vad_enabled) {
+            utils::EnergyVad vad(vad_config);
+            segments = vad.detect(audio.data(), audio.size(), sample_rate);
+        }
+
+        LfrFrontend frontend(frontend_config);
+        frontend.accept_waveform_inplace(audio.data(), audio.size(), sample_rate);
+        frontend.input_finished();
+        int num_frames = frontend.pop_frames(features);
+
+        const double frame_ms = frontend_config.lfr_window_shift * 10;
+        if (vad_enabled) {
+            for (auto& seg : segments) {
+                int start = (int)(seg.start * 1000.0 / sample_rate / frame_ms);
+                int end = std::min((int)std::ceil(seg.end * 1000.0 / sample_rate / frame_ms), num_frames);
+                if (end > start)
+                    ranges.emplace_back(start, std::min(end, start + max_seq_len_));
+            }
+        } else {
+            for (int start = 0; start < num_frames; start += max_seq_len_) {
+                ranges.emplace_back(start, std::min(start + max_seq_len_, num_frames));
+            }
+        }
+    }
+
+    bool decode_ranges_(const std::vector<float>& features, const std::vector<std::pair<int, int>>& ranges,
+                        std::string& text_result) {
+        text_result.clear();
+        std::vector<int> token_ids;
+        for (auto& range : ranges) {
+            token_ids.clear();
+            if (!decode_(features.data() + (size_t)range.first * feature_dim_, range.second - range.first, token_ids))
+                return false;
+            append_text_(token_ids, text_result);
+        }
+        return true;
+    }
+
+    bool set_param(const std::string& key, const std::string& value) {
+        if (key == "dither") {
+            LfrDitherMode mode;
+            if (value == "random")
+                mode = LFR_DITHER_RANDOM;
+            else if (value == "deterministic")
+                mode = LFR_DITHER_DETERMINISTIC;
+            else if (value == "none")
+                mode = LFR_DITHER_NONE;
+            else {
+                ALOGE("Invalid value %s for %s", value.c_str(), key.c_str());
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(param_mutex_);
+            dither_mode_ = mode;
+            frontend_config_.dither_mode = mode;
+            return true;
+        }
+
+        char* end = nullptr;
+        float v = strtof(value.c_str(), &end);
+        if (value.empty() || *end != '\0') {
+            ALOGE("Invalid value %s for %s", value.c_str(), key.c_str());
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(param_mutex_);
+        if (key == "vad") {
+            vad_enabled_ = v != 0;
+        } else if (key == "vad_threshold_db") {
+            vad_config_.threshold_db = v;
+        } else if (key == "vad_min_silence_ms") {
+            vad_config_.min_silence_ms = (int)v;
+        } else if (key == "vad_speech_pad_ms") {
+            vad_config_.speech_pad_ms = (int)v;
+        } else {
+            ALOGE("Unknown param %s", key.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool load_models_(const std::string& encoder_path, const std::string& predictor_path, const std::string& decoder_path) {
+        int ret = encoder_.load_model(encoder_path.c_str());
+        if (0 != ret) {
+            ALOGE("Load encoder failed! ret=0x%x", ret);
+            return false;
+        }
+
+        ret = predictor_.load_model(predictor_path.c_str());
+        if (0 != ret) {
+            ALOGE("Load predictor failed! ret=0x%x", ret);
+            return false;
+        }
+
+        ret = decoder_.load_model(decoder_path.c_str());
+        if (0 != ret) {
+            ALOGE("Load decoder failed! ret=0x%x", ret);
+            return false;
+        }
+        return true;
+    }
+
+    bool load_tokens_(const std::string& token_path) {
+        std::ifstream fs(token_path);
+        if (!fs.is_open()) {
+            ALOGE("Cannot open token file: %s", token_path.c_str());
+            return false;
+        }
+
+        std::string line;
+        tokens_.reserve(vocab_size_);
+        while (std::getline(fs, line)) {
+            tokens_.push_back(line);
+        }
+        return true;
+    }
+
+    // Encoder, predictor and decoder once each over num_frames LFR frames,
+    // whatever the number of tokens
+    bool decode_(const float* features, int num_frames, std::vector<int>& token_ids) {
+        std::lock_guard<std::mutex> lock(model_mutex_);
+
+        memcpy(feat_.data(), features, (size_t)num_frames * feature_dim_ * sizeof(float));
+        std::fill(feat_.begin() + (size_t)num_frames * feature_dim_, feat_.end(), 0.0f);
+        std::fill(mask_.begin(), mask_.end(), 0);
+        std::fill(mask_.begin(), mask_.begin() + num_frames, 1);
+
+        encoder_.set_input(0, feat_.data());
+        encoder_.set_input(1, mask_.data());
+        int ret = encoder_.run();
+        if (0 != ret) {
+            ALOGE("Run encoder failed! ret=0x%x", ret);
+            return false;
+        }
+        encoder_.get_output(0, enc_out_.data());
+
+        predictor_.set_input_dma(0, encoder_, 0);
+        predictor_.set_input(1, mask_.data());
+        ret = predictor_.run();
+        if (0 != ret) {
+            ALOGE("Run predictor failed! ret=0x%x", ret);
+            return false;
+        }
+        predictor_.get_output(0, alphas_.data());
+
+        int num_tokens = cif_(num_frames);
+        ALOGD("Paraformer: %d frames -> %d tokens", num_frames, num_tokens);
+        if (num_tokens == 0)
+            return true;
+
+        std::fill(token_mask_.begin(), token_mask_.end(), 0);
+        std::fill(token_mask_.begin(), token_mask_.begin() + num_tokens, 1);
+
+        decoder_.set_input_dma(0, encoder_, 0);
+        decoder_.set_input(1, mask_.data());
+        decoder_.set_input(2, acoustic_embeds_.data());
+        decoder_.set_input(3, token_mask_.data());
+        ret = decoder_.run();
+        if (0 != ret) {
+            ALOGE("Run decoder failed! ret=0x%x", ret);
+            return false;
+        }
+        decoder_.get_output(0, logits_.data());
+
+        for (int i = 0; i < num_tokens; i++) {
+            token_ids.push_back(utils::argmax_f32(logits_.data() + (size_t)i * vocab_size_, vocab_size_));
+        }
+        return true;
+    }
+
+    // Continuous integrate-and-fire over the encoder frames: every time the
+    // predicted weights add up to the threshold, the weighted sum of the
+    // frames since the last fire becomes one acoustic embedding. Returns the
+    // number of embeddings written to acoustic_embeds_.
+    int cif_(int num_frames) {
+        std::fill(acoustic_embeds_.begin(), acoustic_embeds_.end(), 0.0f);
+        std::vector<float> frame(enc_dim_, 0.0f);
+        float integrate = 0.0f;
+        int num_tokens = 0;
+
+        auto fire = [&]() {
+            if (num_tokens < max_tokens_)
+                memcpy(acoustic_embeds_.data() + (size_t)num_tokens * enc_dim_, frame.data(), enc_dim_ * sizeof(float));
+            num_tokens++;
+        };
+
+        for (int t = 0; t < num_frames; t++) {
+            const float alpha = alphas_[t];
+            const float* hidden = enc_out_.data() + (size_t)t * enc_dim_;
+            if (integrate + alpha < PARAFORMER_CIF_THRESHOLD) {
+                integrate += alpha;
+                for (int d = 0; d < enc_dim_; d++) {
+                    frame[d] += alpha * hidden[d];
+                }
+                continue;
+            }
+
+            // Part of this frame completes the current token, the rest starts the next
+            const float used = PARAFORMER_CIF_THRESHOLD - integrate;
+            for (int d = 0; d < enc_dim_; d++) {
+                frame[d] += used * hidden[d];
+            }
+            fire();
+            integrate = alpha - used;
+            for (int d = 0; d < enc_dim_; d++) {
+                frame[d] = integrate * hidden[d];
+            }
+        }
+
+        // The tail is a silent frame, it only adds weight
+        if (integrate + PARAFORMER_CIF_TAIL >= PARAFORMER_CIF_THRESHOLD)
+            fire();
+
+        if (num_tokens > max_tokens_) {
+            ALOGW("CIF fired %d tokens, decoder holds %d", num_tokens, max_tokens_);
+            num_tokens = max_tokens_;
+        }
+        return num_tokens;
+    }
+
+    // CJK characters are joined directly, latin words are separated by
+    // spaces and a trailing "@@" glues a piece to the next one. Special
+    // tokens such as <blank>, <s>, </s> and <unk> are dropped.
+    void append_text_(const std::vector<int>& token_ids, std::string& text_result) const {
+        bool glue = false;
+        for (int id : token_ids) {
+            if (id < 0 || id >= (int)tokens_.size())
+                continue;
+            const std::string& token = tokens_[id];
+            if (token.empty() || (token.front() == '<' && token.back() == '>'))
+                continue;
+
+            bool latin = (unsigned char)token[0] < 0x80;
+            if (latin && !glue && !text_result.empty() && (unsigned char)text_result.back() < 0x80 &&
+                text_result.back() != ' ')
+                text_result.push_back(' ');
+
+            if (token.size() > 2 && token.compare(token.size() - 2, 2, "@@") == 0) {
+                text_result.append(token, 0, token.size() - 2);
+                glue = true;
+            } else {
+                text_result.append(token);
+                glue = false;
+            }
+        }
+    }
+
+private:
+    AxModelRunner encoder_;
+    AxModelRunner predictor_;
+    AxModelRunner decoder_;
+    // Guards the three runners and the buffers below
+    std::mutex model_mutex_;
+    std::vector<float> feat_;
+    std::vector<int> mask_;
+    std::vector<float> enc_out_;
+    std::vector<float> alphas_;
+    std::vector<float> acoustic_embeds_;
+    std::vector<int> token_mask_;
+    std::vector<float> logits_;
+
+    int max_seq_len_, feature_dim_, enc_dim_;
+    int max_tokens_, vocab_size_;
+    std::vector<std::string> tokens_;
+
+    // Guards frontend_config_ and the VAD settings against set_param()
+    // during run()
+    std::mutex param_mutex_;
+    LfrFrontendConfig frontend_config_;
+    LfrDitherMode dither_mode_ = LFR_DITHER_DETERMINISTIC;
+    bool vad_enabled_ = true;
+    utils::EnergyVadConfig vad_config_;
+};
+
+Paraformer::Paraformer():
+    impl_(std::make_unique<Paraformer::Impl>()) {
+
+}
+
+Paraformer::~Paraformer() {
+    uninit();
+}
+
+bool Paraformer::init(AX_ASR_TYPE_E asr_type, const std::string& model_path) {
+    return impl_->init(asr_type, model_path);
+}
+
+void Paraformer::uninit(void) {
+    impl_->uninit();
+}
+
+bool Paraformer::run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) {
+    return impl_->run(audio_data, sample_rate, language, text_result);
+}
+
+bool Paraformer::run_native(std::vector<float>& audio, const std::string& language, std::string& text_result) {
+    return impl_->run_native(audio, language, text_result);
+}
+
+std::unique_ptr<ASRPrepared> Paraformer::prepare(std::vector<float>& audio) {
+    return impl_->prepare(audio);
+}
+
+bool Paraformer::run_prepared(std::vector<std::unique_ptr<ASRPrepared>>& items, const std::string& language,
+                              std::vector<std::string>& text_results) {
+    return impl_->run_prepared(items, language, text_results);
+}
+
+bool Paraformer::set_param(const std::string& key, const std::string& value) {
+    return impl_->set_param(key, value);
+}
+
+void register_paraformer_models(ASRRegistry& registry) {
+    registry.add({"paraformer", "paraformer", AX_PARAFORMER, "paraformer",
+                  {"encoder.axmodel", "predictor.axmodel", "decoder.axmodel", "tokens.txt"},
+                  [] { return static_cast<ASRInterface*>(new Paraformer()); }});
+}
@@ -0,0 +1,39 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <memory>
+
+#include "asr/asr_interface.hpp"
+
+// Non-autoregressive Paraformer: encoder, CIF predictor and a decoder that
+// emits every token of an utterance in one run.
+//
+// model_path holds encoder.axmodel, predictor.axmodel, decoder.axmodel,
+// tokens.txt and optionally am.mvn.
+class Paraformer : public ASRInterface {
+public:
+    Paraformer();
+    ~Paraformer();
+
+    int sample_rate()   { return 16000; }
+    bool init(AX_ASR_TYPE_E asr_type, const std::string& model_path);
+    void uninit(void);
+    bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result);
+    bool run_native(std::vector<float>& audio, const std::string& language, std::string& text_result);
+    std::unique_ptr<ASRPrepared> prepare(std::vector<float>& audio);
+    bool run_prepared(std::vector<std::unique_ptr<ASRPrepared>>& items, const std::string& language,
+                      std::vector<std::string>& text_results);
+    bool set_param(const std::string& key, const std::string& value);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
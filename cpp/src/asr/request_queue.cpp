@@ -0,0 +1,320 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "asr/request_queue.hpp"
+#include "api/ax_asr_api.h"
+#include "utils/logger.h"
+
+// Default number of loader threads is capped here, the NPU is the limit
+// beyond that
+#define REQUEST_MAX_THREADS         4
+// Requests prepared ahead of the NPU per loader thread, bounds memory
+#define REQUEST_AHEAD_PER_THREAD    2
+
+class RequestQueue::Impl {
+public:
+    Impl(ASRInterface* asr, int num_threads):
+        asr_(asr) {
+        if (num_threads <= 0) {
+            num_threads = std::min<int>(std::max<int>(std::thread::hardware_concurrency(), 1), REQUEST_MAX_THREADS);
+        }
+        num_threads_ = num_threads;
+    }
+
+    ~Impl() {
+        std::vector<int64_t> ids;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+            for (auto& it : requests_) {
+                ids.push_back(it.first);
+            }
+            if (!ids.empty())
+                ALOGW("Cancel %zu outstanding request(s)", ids.size());
+            for (int64_t id : ids) {
+                auto it = requests_.find(id);
+                if (it != requests_.end())
+                    cancel_(lock, it->second.get());
+            }
+        }
+        load_cv_.notify_all();
+        run_cv_.notify_all();
+        for (auto& thread : loaders_) {
+            thread.join();
+        }
+        if (runner_.joinable())
+            runner_.join();
+    }
+
+    bool start() {
+        if (runner_.joinable()) {
+            ALOGE("Request queue already started");
+            return false;
+        }
+
+        max_items_ = std::max(asr_->max_batch_items(), 1);
+        ahead_ = (size_t)num_threads_ * REQUEST_AHEAD_PER_THREAD + max_items_;
+        for (int i = 0; i < num_threads_; i++) {
+            loaders_.emplace_back(&Impl::load_loop_, this);
+        }
+        runner_ = std::thread(&Impl::run_loop_, this);
+        ALOGD("Request queue: %d loader threads, up to %zu requests per run", num_threads_, max_items_);
+        return true;
+    }
+
+    int64_t submit(RequestLoader load, const std::string& language, RequestDone done, void* user_data) {
+        std::unique_ptr<Request> request(new Request);
+        request->load = std::move(load);
+        request->language = language;
+        request->done = std::move(done);
+        request->user_data = user_data;
+
+        int64_t id;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_) {
+                ALOGE("Request queue is shutting down");
+                return 0;
+            }
+            id = ++last_id_;
+            request->id = id;
+            if (!request->done)
+                waiting_++;
+            pending_.push_back(request.get());
+            requests_[id] = std::move(request);
+        }
+        load_cv_.notify_one();
+        return id;
+    }
+
+    bool cancel(int64_t id) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = requests_.find(id);
+        if (it == requests_.end())
+            return false;
+        cancel_(lock, it->second.get());
+        return true;
+    }
+
+    bool wait(ASRCompletion& completion, int timeout_ms) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto ready = [&] { return !completions_.empty() || waiting_ == 0; };
+        if (timeout_ms < 0) {
+            completion_cv_.wait(lock, ready);
+        } else {
+            completion_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+        }
+        if (completions_.empty())
+            return false;
+
+        completion = std::move(completions_.front());
+        completions_.pop_front();
+        return true;
+    }
+
+private:
+    enum State {
+        QUEUED,         // in pending_
+        LOADING,        // on a loader thread
+        PREPARED,       // in prepared_
+        RUNNING         // on the runner thread
+    };
+
+    struct Request {
+        int64_t id = 0;
+        RequestLoader load;
+        std::string language;
+        RequestDone done;
+        void* user_data = nullptr;
+        std::unique_ptr<ASRPrepared> item;
+        State state = QUEUED;
+        bool cancelled = false;
+    };
+
+    // Call with lock held
+    void cancel_(std::unique_lock<std::mutex>& lock, Request* request) {
+        if (request->state == QUEUED) {
+            pending_.erase(std::find(pending_.begin(), pending_.end(), request));
+        } else if (request->state == PREPARED) {
+            prepared_.erase(std::find(prepared_.begin(), prepared_.end(), request));
+            load_cv_.notify_one();
+        } else {
+            // Finished by its thread, which checks the flag
+            request->cancelled = true;
+            return;
+        }
+        std::string text;
+        complete_(lock, request, AX_ASR_ERR_CANCELLED, text);
+    }
+
+    // Releases the request and delivers its completion. Call with lock
+    // held, it is dropped while a RequestDone runs.
+    void complete_(std::unique_lock<std::mutex>& lock, Request* request, int status, std::string& text) {
+        ASRCompletion completion;
+        completion.id = request->id;
+        completion.status = status;
+        completion.text = std::move(text);
+        completion.user_data = request->user_data;
+
+        RequestDone done = std::move(request->done);
+        requests_.erase(request->id);
+        if (!done) {
+            completions_.push_back(std::move(completion));
+            waiting_--;
+            completion_cv_.notify_all();
+            return;
+        }
+
+        lock.unlock();
+        done(completion);
+        lock.lock();
+    }
+
+    void load_loop_() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            load_cv_.wait(lock, [&] {
+                return stop_ || (!pending_.empty() && prepared_.size() + loading_ < ahead_);
+            });
+            if (stop_)
+                return;
+
+            Request* request = pending_.front();
+            pending_.pop_front();
+            request->state = LOADING;
+            loading_++;
+            lock.unlock();
+
+            std::vector<float> audio;
+            std::unique_ptr<ASRPrepared> item;
+            int status = request->load(audio);
+            if (status == AX_ASR_SUCCESS) {
+                item = asr_->prepare(audio);
+                if (!item) {
+                    ALOGW("Request %lld not prepared", (long long)request->id);
+                    status = AX_ASR_ERR_RUN_FAILED;
+                }
+            } else {
+                ALOGW("Request %lld not loaded", (long long)request->id);
+            }
+
+            lock.lock();
+            loading_--;
+            if (request->cancelled || status != AX_ASR_SUCCESS) {
+                std::string text;
+                complete_(lock, request, request->cancelled ? AX_ASR_ERR_CANCELLED : status, text);
+                continue;
+            }
+            request->item = std::move(item);
+            request->state = PREPARED;
+            prepared_.push_back(request);
+            run_cv_.notify_one();
+        }
+    }
+
+    void run_loop_() {
+        std::vector<std::unique_ptr<ASRPrepared>> group;
+        std::vector<Request*> group_requests;
+        std::vector<std::string> texts;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            run_cv_.wait(lock, [&] { return stop_ || !prepared_.empty(); });
+            if (prepared_.empty())
+                return;
+
+            // Consecutive requests of the same language share one run
+            std::string language = prepared_.front()->language;
+            while (!prepared_.empty() && group.size() < max_items_ && prepared_.front()->language == language) {
+                Request* request = prepared_.front();
+                prepared_.pop_front();
+                request->state = RUNNING;
+                group.push_back(std::move(request->item));
+                group_requests.push_back(request);
+            }
+            lock.unlock();
+            load_cv_.notify_all();
+
+            bool ok = asr_->run_prepared(group, language, texts);
+            if (!ok)
+                ALOGE("Requests %lld-%lld failed", (long long)group_requests.front()->id,
+                      (long long)group_requests.back()->id);
+            group.clear();
+
+            lock.lock();
+            for (size_t k = 0; k < group_requests.size(); k++) {
+                Request* request = group_requests[k];
+                std::string text;
+                int status = AX_ASR_ERR_CANCELLED;
+                if (!request->cancelled) {
+                    status = ok ? AX_ASR_SUCCESS : AX_ASR_ERR_RUN_FAILED;
+                    if (ok)
+                        text = std::move(texts[k]);
+                }
+                complete_(lock, request, status, text);
+            }
+            group_requests.clear();
+        }
+    }
+
+private:
+    ASRInterface* asr_;
+    int num_threads_;
+    size_t max_items_ = 1;
+    size_t ahead_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable load_cv_;           // pending work or room ahead
+    std::condition_variable run_cv_;            // a request was prepared
+    std::condition_variable completion_cv_;     // a completion was queued
+    std::map<int64_t, std::unique_ptr<Request>> requests_;  // outstanding
+    std::deque<Request*> pending_;
+    std::deque<Request*> prepared_;
+    std::deque<ASRCompletion> completions_;
+    size_t loading_ = 0;
+    size_t waiting_ = 0;                        // outstanding requests without RequestDone
+    int64_t last_id_ = 0;
+    bool stop_ = false;
+
+    std::vector<std::thread> loaders_;
+    std::thread runner_;
+};
+
+RequestQueue::RequestQueue(ASRInterface* asr, int num_threads):
+    impl_(std::make_unique<RequestQueue::Impl>(asr, num_threads)) {
+
+}
+
+RequestQueue::~RequestQueue() {
+
+}
+
+bool RequestQueue::start() {
+    return impl_->start();
+}
+
+int64_t RequestQueue::submit(RequestLoader load, const std::string& language, RequestDone done, void* user_data) {
+    return impl_->submit(std::move(load), language, std::move(done), user_data);
+}
+
+bool RequestQueue::cancel(int64_t id) {
+    return impl_->cancel(id);
+}
+
+bool RequestQueue::wait(ASRCompletion& completion, int timeout_ms) {
+    return impl_->wait(completion, timeout_ms);
+}
@@ -0,0 +1,70 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asr/asr_interface.hpp"
+
+// Outcome of one submitted request
+struct ASRCompletion {
+    int64_t id = 0;
+    int status = 0;         // AX_ASR_STATUS_E
+    std::string text;
+    void* user_data = nullptr;
+};
+
+// Fill audio at the model's sample_rate(), called from a loader thread.
+// Returns an AX_ASR_STATUS_E.
+typedef std::function<int(std::vector<float>& audio)> RequestLoader;
+// Called from whichever thread finished the request, must not destroy
+// the queue
+typedef std::function<void(const ASRCompletion& completion)> RequestDone;
+
+// Recognizes requests in the background.
+//
+// Loader threads take requests in submission order, decode them and run
+// ASRInterface::prepare(), a bounded number of requests ahead of the NPU.
+// A single runner thread owns the model's NPU side and hands prepared
+// requests, as they become ready, to ASRInterface::run_prepared(), several
+// at a time for models that pack them. Each request ends with exactly one
+// completion: through its own RequestDone if it has one, otherwise queued
+// for wait().
+class RequestQueue {
+public:
+    // num_threads: loader threads, 0 picks one per core up to 4
+    RequestQueue(ASRInterface* asr, int num_threads = 0);
+    // Cancels every outstanding request, see cancel(), and waits for the
+    // ones in progress
+    ~RequestQueue();
+
+    bool start();
+
+    // Returns the request id, ids start from 1, or 0 while shutting down
+    int64_t submit(RequestLoader load, const std::string& language, RequestDone done, void* user_data);
+
+    // A request not loaded yet completes right away as
+    // AX_ASR_ERR_CANCELLED, one already loading or running does when it
+    // is done and its text is dropped. False if id is not outstanding.
+    bool cancel(int64_t id);
+
+    // Pop the oldest queued completion, waiting up to timeout_ms (< 0
+    // forever). False on timeout, or at once if no outstanding request
+    // would end up in the queue.
+    bool wait(ASRCompletion& completion, int timeout_ms);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
@@ -15,31 +15,46 @@
 #include <vector>
 #include <limits>
 #include <memory>
+#include <deque>
+#include <cstdlib>
+#include <cstdint>
+#include <dirent.h>
+#include <cstring>
+#include <cctype>
+#include <future>
+#include <condition_variable>
 
 #include "asr/sensevoice.hpp"
+#include "asr/asr_registry.hpp"
 #include "api/ax_asr_api.h"
 #include "ax_model_runner/ax_model_runner.hpp"
 #include "utils/nlohmann/json.hpp"
 #include "utils/librosa/librosa.h"
 #include "utils/logger.h"
-#include "utils/resample.h"
-#include "utils/librosa/eigen3/Eigen/Core"
-#include "kaldi-native-fbank/csrc/online-feature.h"
+#include "utils/timer.hpp"
+#include "asr/lfr_frontend.hpp"
+#include "asr/endpoint.hpp"
+#include "asr/ctc_decoder.hpp"
+#include "utils/energy_vad.hpp"
+#include "utils/simd.hpp"
+
+// Features of one batch item, the audio is released once they exist
+struct SensevoicePrepared : public ASRPrepared {
+    std::vector<float> features;
+    int feat_len = 0;
+    bool vad = false;
+    std::vector<utils::VadSegment> segments;
+};
 
 // pImpl
 class Sensevoice::Impl {
     friend class Sensevoice;
+    friend class SensevoiceStream;
 public:
     bool init(AX_ASR_TYPE_E asr_type, const std::string& model_path) {
         std::string spec_model_path = model_path + "/sensevoice.axmodel";
         std::string token_path = model_path + "/tokens.txt";
 
-        int ret = encoder_.load_model(spec_model_path.c_str());
-        if (0 != ret) {
-            ALOGE("Load model %s failed!", spec_model_path.c_str());
-            return false;
-        }
-
         sample_rate_ = 16000;
         n_mels_ = 80;
         query_num_ = 4;
@@ -48,18 +63,30 @@ public:
         lfr_window_size_ = 7;
         lfr_window_shift_ = 6;
 
-        auto input_shape = encoder_.get_input_shape(0);
+        if (!load_encoder_(spec_model_path))
+            return false;
+
+        auto& full = encoders_.back();
+        auto input_shape = full.runner->get_input_shape(0);
         max_seq_len_ = input_shape[1];
         feature_dim_ = input_shape[2];
 
-        mask_.resize(max_seq_len_ + query_num_);
-        sub_feat_.resize(max_seq_len_ * feature_dim_);
-
-        auto output_shape = encoder_.get_output_shape(0);
+        auto output_shape = full.runner->get_output_shape(0);
         vocab_size_ = output_shape[2];
         ctc_logits_.resize(output_shape[1] * vocab_size_);
 
-        init_fbank_();
+        load_encoder_buckets_(model_path);
+        for (auto& enc : encoders_) {
+            if (!enc.feat_input)
+                sub_feat_.resize((size_t)max_seq_len_ * feature_dim_);
+        }
+        route_encoder_buckets_();
+
+        init_frontend_();
+        init_silence_frame_();
+
+        // A segment plus LFR rounding on both ends must fit in one encoder run
+        vad_config_.max_segment_ms = (max_seq_len_ - 2) * lfr_window_shift_ * 10;
 
         if (!load_tokens_(token_path)) {
             ALOGE("Load tokens from %s failed!", token_path.c_str());
@@ -70,111 +97,396 @@ public:
     }
 
     void uninit(void) {
-        encoder_.unload_model();
+        for (auto& enc : encoders_) {
+            enc.runner->unload_model();
+        }
+        encoders_.clear();
     }
 
     bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) {
-        // Re-init fbank to clear previous audio data (OnlineFbank accumulates data)
-        init_fbank_();
-        
-        // convert to uint16
-        std::vector<float> buf(audio_data.size());
-        for (int32_t i = 0; i != audio_data.size(); ++i) {
-            buf[i] = audio_data[i] * 32768;
+        std::vector<float> audio;
+        utils::resample(audio_data.data(), audio_data.size(), sample_rate, sample_rate_, audio);
+        return run_native(audio, language, text_result);
+    }
+
+    bool run_native(std::vector<float>& audio, const std::string& language, std::string& text_result) {
+        std::vector<CtcToken> asr_res;
+        if (!recognize_(audio, language_token_(language), asr_res, false))
+            return false;
+
+        tokens_to_text_(asr_res, text_result);
+        return true;
+    }
+
+    bool run_detailed(const std::vector<float>& audio_data, int sample_rate, const std::string& language, ASRResult& result) {
+        std::vector<float> audio;
+        utils::resample(audio_data.data(), audio_data.size(), sample_rate, sample_rate_, audio);
+        return run_native_detailed(audio, language, result);
+    }
+
+    bool run_native_detailed(std::vector<float>& audio, const std::string& language, ASRResult& result) {
+        std::vector<CtcToken> asr_res;
+        if (!recognize_(audio, language_token_(language), asr_res, true, &result.language))
+            return false;
+
+        tokens_to_text_(asr_res, result.text);
+        tokens_to_timestamps_(asr_res, result);
+        result.confidence = mean_prob_(asr_res);
+        return true;
+    }
+
+    // Same result as run() on the whole file, but audio, features and
+    // logits only ever exist for one window. With VAD the file is read
+    // twice: once for the frame energies that decide the segments, once
+    // for the features of those segments. Each range is passed to
+    // on_segment as soon as it is decoded, without VAD the first one comes
+    // after one window of audio whatever the file length.
+    bool run_reader(utils::AudioReader& reader, const std::string& language, std::string& text_result,
+                    const ASRSegmentCallback& on_segment) {
+        int language_token = language_token_(language);
+        const int sample_rate = reader.get_sample_rate();
+        const double frame_ms = lfr_window_shift_ * 10;
+
+        LfrFrontendConfig frontend_config;
+        bool vad_enabled;
+        utils::EnergyVadConfig vad_config;
+        copy_params_(frontend_config, vad_enabled, vad_config);
+
+        std::vector<float> block;
+        std::vector<utils::VadSegment> segments;
+        int num_samples = 0;
+        if (vad_enabled) {
+            utils::EnergyVad vad(vad_config);
+            vad.begin(sample_rate);
+            while (reader.read(block)) {
+                vad.accept_waveform(block.data(), block.size());
+                num_samples += block.size();
+            }
+            if (reader.failed() || !reader.rewind())
+                return false;
+            segments = vad.finish();
         }
-        // resample 
-        auto resample_data = utils::resample(buf, sample_rate, sample_rate_);
 
-        int language_token = lid_dict_[language];
+        LfrFrontend frontend(frontend_config);
 
+        // features holds LFR frames [base, base + size / feature_dim_)
         std::vector<float> features;
-        int feat_len;
-        preprocess_(resample_data, false, features, feat_len);
+        int base = 0;
+        bool finished = false;
+        size_t next = 0;            // next VAD segment or fixed slice
+        int total_samples = 0;
+        std::vector<CtcToken> asr_res;
+
+        while (true) {
+            if (!finished) {
+                if (reader.read(block)) {
+                    total_samples += block.size();
+                    frontend.accept_waveform_inplace(block.data(), block.size(), sample_rate);
+                } else {
+                    if (reader.failed())
+                        return false;
+                    frontend.input_finished();
+                    finished = true;
+                }
+                frontend.pop_frames(features);
+            }
+            const int available = base + features.size() / feature_dim_;
+
+            // Decode every range whose frames are all there, the same
+            // ranges decode_speech_() or decode_() use on the whole file.
+            // keep_from is where the first pending range starts.
+            int keep_from = available;
+            bool done = false;
+            while (true) {
+                int start, end;
+                if (vad_enabled) {
+                    if (next >= segments.size()) {
+                        done = true;
+                        break;
+                    }
+                    start = (int)(segments[next].start * 1000.0 / sample_rate / frame_ms);
+                    end = (int)std::ceil(segments[next].end * 1000.0 / sample_rate / frame_ms);
+                } else {
+                    int i = next;
+                    start = i == 0 ? 0 : i * max_seq_len_ - padding_;
+                    end = (i + 1) * max_seq_len_ - (i == 0 ? 0 : padding_);
+                    // Slice i exists only if it starts inside the audio
+                    if ((int64_t)i * max_seq_len_ >= available) {
+                        done = finished;
+                        keep_from = start;
+                        break;
+                    }
+                }
+
+                if (end > available && !finished) {
+                    keep_from = start;
+                    break;
+                }
+
+                end = std::min(end, available);
+                size_t decoded = asr_res.size();
+                if (end > start && !decode_(features.data() + (size_t)(start - base) * feature_dim_, end - start,
+                                            language_token, asr_res, start))
+                    return false;
+                if (on_segment && asr_res.size() > decoded) {
+                    ASRFinalResult segment;
+                    tokens_to_text_(std::vector<CtcToken>(asr_res.begin() + decoded, asr_res.end()), segment.text);
+                    segment.start_ms = (int)(start * frame_ms);
+                    segment.end_ms = (int)(end * frame_ms);
+                    if (!segment.text.empty())
+                        on_segment(segment);
+                }
+                next++;
+            }
 
-        int slice_len = max_seq_len_;
-        int slice_num = static_cast<int>(std::ceil(feat_len * 1.0f / slice_len));
-        ALOGD("feat_len=%d slice_len=%d slice_num=%d", feat_len, slice_len, slice_num);
-        
-        std::vector<int> asr_res;
-        int slice_start = 0;
-        int slice_end = 0;
-        int actual_seq_len = 0;
-        int ret = -1;
+            // Frames before the next range are never needed again
+            keep_from = std::min(std::max(keep_from, base), available);
+            features.erase(features.begin(), features.begin() + (size_t)(keep_from - base) * feature_dim_);
+            base = keep_from;
 
-        for (int i = 0; i < slice_num; i++) {
-            if (i == 0) {
-                slice_start = 0;
-                slice_end = std::min(slice_len, feat_len);
-            } else {
-                slice_start = i * slice_len - padding_;
-                slice_end = std::min((i + 1) * slice_len - padding_, feat_len);
-            }
+            if (done)
+                break;
+        }
 
-            ALOGD("Slice %d: start=%d end=%d", i, slice_start, slice_end);
+        ALOGD("run_reader: %d frames, %zu segments", base, segments.size());
+        if (num_samples == 0 && total_samples == 0) {
+            ALOGE("No audio in file");
+            return false;
+        }
+        tokens_to_text_(asr_res, text_result);
+        return true;
+    }
 
-            actual_seq_len = slice_end - slice_start;
-            std::fill(sub_feat_.begin(), sub_feat_.end(), 0.0f);
-            memcpy(
-                sub_feat_.data(),
-                features.data() + slice_start * feature_dim_,
-                actual_seq_len * feature_dim_ * sizeof(float)
-            );
+    // VAD and features on a pipeline thread, with a frontend of its own so
+    // that several items are extracted at once
+    std::unique_ptr<ASRPrepared> prepare(std::vector<float>& audio) {
+        LfrFrontendConfig frontend_config;
+        bool vad_enabled;
+        utils::EnergyVadConfig vad_config;
+        copy_params_(frontend_config, vad_enabled, vad_config);
+
+        auto item = std::make_unique<SensevoicePrepared>();
+        item->vad = vad_enabled;
+        if (vad_enabled)
+            find_speech_(vad_config, audio.data(), audio.size(), sample_rate_, item->segments);
+
+        LfrFrontend frontend(frontend_config);
+        frontend.accept_waveform_inplace(audio.data(), audio.size(), sample_rate_);
+        frontend.input_finished();
+        item->feat_len = frontend.pop_frames(item->features);
+
+        std::vector<float>().swap(audio);
+        return item;
+    }
 
-            sequence_mask_(actual_seq_len);
+    // Short utterances are packed into shared encoder windows, separated by
+    // silence frames, and the CTC output is split back by frame range.
+    // Utterances that do not fit in one window are decoded on their own,
+    // with VAD if it is enabled.
+    bool run_prepared(std::vector<std::unique_ptr<ASRPrepared>>& items, const std::string& language,
+                      std::vector<std::string>& text_results) {
+        int language_token = language_token_(language);
+        const int count = items.size();
+        text_results.assign(count, std::string());
+
+        std::vector<std::vector<float>> features(count);
+        std::vector<int> feat_lens(count);
+        for (int i = 0; i < count; i++) {
+            auto& item = static_cast<SensevoicePrepared&>(*items[i]);
+            features[i].swap(item.features);
+            feat_lens[i] = item.feat_len;
+        }
 
-            encoder_.set_input(0, sub_feat_.data());
-            encoder_.set_input(1, mask_.data());
-            encoder_.set_input(2, &language_token);
+        std::vector<int> pack;
+        int pack_len = 0;
+        for (int i = 0; i <= count; i++) {
+            bool flush = (i == count);
+            if (!flush) {
+                if (feat_lens[i] <= 0)
+                    continue;
+                if (feat_lens[i] > max_seq_len_) {
+                    auto& item = static_cast<SensevoicePrepared&>(*items[i]);
+                    std::vector<CtcToken> asr_res;
+                    if (!decode_utterance_(item.vad ? &item.segments : nullptr, sample_rate_, features[i], feat_lens[i],
+                                           language_token, asr_res))
+                        return false;
+                    tokens_to_text_(asr_res, text_results[i]);
+                    continue;
+                }
+                int need = pack.empty() ? feat_lens[i] : pack_len + pack_gap_frames_ + feat_lens[i];
+                flush = need > max_seq_len_;
+            }
 
-            ret = encoder_.run();
-            if (0 != ret) {
-                ALOGE("Run encoder failed! ret=0x%x", ret);
-                return false;
+            if (flush && !pack.empty()) {
+                if (!decode_packed_(pack, features, feat_lens, language_token, text_results))
+                    return false;
+                pack.clear();
+                pack_len = 0;
             }
 
-            encoder_.get_output(0, ctc_logits_.data());
-            encoder_.get_output(1, &encoder_out_lens_);
+            if (i < count) {
+                pack_len = pack.empty() ? feat_lens[i] : pack_len + pack_gap_frames_ + feat_lens[i];
+                pack.push_back(i);
+            }
+        }
+        return true;
+    }
 
-            auto token_int = postprocess_(ctc_logits_, encoder_out_lens_);
-            asr_res.insert(asr_res.end(), token_int.begin(), token_int.end());
+    bool set_param(const std::string& key, const std::string& value) {
+        if (key == "dither") {
+            LfrDitherMode mode;
+            if (value == "random")
+                mode = LFR_DITHER_RANDOM;
+            else if (value == "deterministic")
+                mode = LFR_DITHER_DETERMINISTIC;
+            else if (value == "none")
+                mode = LFR_DITHER_NONE;
+            else {
+                ALOGE("Invalid value %s for %s", value.c_str(), key.c_str());
+                return false;
+            }
+            // Applies to run() and to streams created from now on
+            std::lock_guard<std::mutex> lock(frontend_mutex_);
+            dither_mode_ = mode;
+            init_frontend_();
+            return true;
         }
 
-        text_result.clear();
-        text_result.reserve(256);
-        ALOGD("asr_res.size() = %u", asr_res.size());
-        for (auto i : asr_res) {
-            text_result.append(tokens_[i]);
+        char* end = nullptr;
+        float v = strtof(value.c_str(), &end);
+        if (value.empty() || *end != '\0') {
+            ALOGE("Invalid value %s for %s", value.c_str(), key.c_str());
+            return false;
         }
 
+        std::lock_guard<std::mutex> lock(frontend_mutex_);
+        if (key == "vad") {
+            vad_enabled_ = v != 0;
+        } else if (key == "vad_threshold_db") {
+            vad_config_.threshold_db = v;
+        } else if (key == "vad_min_silence_ms") {
+            vad_config_.min_silence_ms = (int)v;
+        } else if (key == "vad_speech_pad_ms") {
+            vad_config_.speech_pad_ms = (int)v;
+        } else {
+            ALOGE("Unknown param %s", key.c_str());
+            return false;
+        }
         return true;
     }
 
 private:
-    void init_fbank_(void) {
-        knf::FbankOptions opts;
-        opts.frame_opts.dither = 1.0f;
-        opts.frame_opts.snip_edges = true;
-        opts.frame_opts.samp_freq = sample_rate_;
-        opts.frame_opts.frame_shift_ms = 10;
-        opts.frame_opts.frame_length_ms = 25;
-        opts.frame_opts.remove_dc_offset = true;
-        opts.frame_opts.window_type = "hamming";
-        opts.frame_opts.remove_dc_offset = true;
-
-        opts.mel_opts.num_bins = n_mels_;
-
-        opts.mel_opts.high_freq = 0;
-        opts.mel_opts.low_freq = 20;
-        opts.mel_opts.is_librosa = false;
-
-        fbank_ = std::make_unique<knf::OnlineFbank>(opts);
-
-        neg_mean_ = std::vector<float>{
-            -8.311879, -8.600912, -9.615928, -10.43595, -11.21292, -11.88333, -12.36243, -12.63706, -12.8818, -12.83066, -12.89103, -12.95666, -13.19763, -13.40598, -13.49113, -13.5546, -13.55639, -13.51915, -13.68284, -13.53289, -13.42107, -13.65519, -13.50713, -13.75251, -13.76715, -13.87408, -13.73109, -13.70412, -13.56073, -13.53488, -13.54895, -13.56228, -13.59408, -13.62047, -13.64198, -13.66109, -13.62669, -13.58297, -13.57387, -13.4739, -13.53063, -13.48348, -13.61047, -13.64716, -13.71546, -13.79184, -13.90614, -14.03098, -14.18205, -14.35881, -14.48419, -14.60172, -14.70591, -14.83362, -14.92122, -15.00622, -15.05122, -15.03119, -14.99028, -14.92302, -14.86927, -14.82691, -14.7972, -14.76909, -14.71356, -14.61277, -14.51696, -14.42252, -14.36405, -14.30451, -14.23161, -14.19851, -14.16633, -14.15649, -14.10504, -13.99518, -13.79562, -13.3996, -12.7767, -11.71208, -8.311879, -8.600912, -9.615928, -10.43595, -11.21292, -11.88333, -12.36243, -12.63706, -12.8818, -12.83066, -12.89103, -12.95666, -13.19763, -13.40598, -13.49113, -13.5546, -13.55639, -13.51915, -13.68284, -13.53289, -13.42107, -13.65519, -13.50713, -13.75251, -13.76715, -13.87408, -13.73109, -13.70412, -13.56073, -13.53488, -13.54895, -13.56228, -13.59408, -13.62047, -13.64198, -13.66109, -13.62669, -13.58297, -13.57387, -13.4739, -13.53063, -13.48348, -13.61047, -13.64716, -13.71546, -13.79184, -13.90614, -14.03098, -14.18205, -14.35881, -14.48419, -14.60172, -14.70591, -14.83362, -14.92122, -15.00622, -15.05122, -15.03119, -14.99028, -14.92302, -14.86927, -14.82691, -14.7972, -14.76909, -14.71356, -14.61277, -14.51696, -14.42252, -14.36405, -14.30451, -14.23161, -14.19851, -14.16633, -14.15649, -14.10504, -13.99518, -13.79562, -13.3996, -12.7767, -11.71208, -8.311879, -8.600912, -9.615928, -10.43595, -11.21292, -11.88333, -12.36243, -12.63706, -12.8818, -12.83066, -12.89103, -12.95666, -13.19763, -13.40598, -13.49113, -13.5546, -13.55639, -13.51915, -13.68284, -13.53289, -13.42107, -13.65519, -13.50713, -13.75251, -13.76715, -13.87408, -13.73109, -13.70412, -13.56073, -13.53488, -13.54895, -13.56228, -13.59408, -13.62047, -13.64198, -13.66109, -13.62669, -13.58297, -13.57387, -13.4739, -13.53063, -13.48348, -13.61047, -13.64716, -13.71546, -13.79184, -13.90614, -14.03098, -14.18205, -14.35881, -14.48419, -14.60172, -14.70591, -14.83362, -14.92122, -15.00622, -15.05122, -15.03119, -14.99028, -14.92302, -14.86927, -14.82691, -14.7972, -14.76909, -14.71356, -14.61277, -14.51696, -14.42252, -14.36405, -14.30451, -14.23161, -14.19851, -14.16633, -14.15649, -14.10504, -13.99518, -13.79562, -13.3996, -12.7767, -11.71208, -8.311879, -8.600912, -9.615928, -10.43595, -11.21292, -11.88333, -12.36243, -12.63706, -12.8818, -12.83066, -12.89103, -12.95666, -13.19763, -13.40598, -13.49113, -13.5546, -13.55639, -13.51915, -13.68284, -13.53289, -13.42107, -13.65519, -13.50713, -13.75251, -13.76715, -13.87408, -13.73109, -13.70412, -13.56073, -13.53488, -13.54895, -13.56228, -13.59408, -13.62047, -13.64198, -13.66109, -13.62669, -13.58297, -13.57387, -13.4739, -13.53063, -13.48348, -13.61047, -13.64716, -13.71546, -13.79184, -13.90614, -14.03098, -14.18205, -14.35881, -14.48419, -14.60172, -14.70591, -14.83362, -14.92122, -15.00622, -15.05122, -15.03119, -14.99028, -14.92302, -14.86927, -14.82691, -14.7972, -14.76909, -14.71356, -14.61277, -14.51696, -14.42252, -14.36405, -14.30451, -14.23161, -14.19851, -14.16633, -14.15649, -14.10504, -13.99518, -13.79562, -13.3996, -12.7767, -11.71208, -8.311879, -8.600912, -9.615928, -10.43595, -11.21292, -11.88333, -12.36243, -12.63706, -12.8818, -12.83066, -12.89103, -12.95666, -13.19763, -13.40598, -13.49113, -13.5546, -13.55639, -13.51915, -13.68284, -13.53289, -13.42107, -13.65519, -13.50713, -13.75251, -13.76715, -13.87408, -13.73109, -13.70412, -13.56073, -13.53488, -13.54895, -13.56228, -13.59408, -13.62047, -13.64198, -13.66109, -13.62669, -13.58297, -13.57387, -13.4739, -13.53063, -13.48348, -13.61047, -13.64716, -13.71546, -13.79184, -13.90614, -14.03098, -14.18205, -14.35881, -14.48419, -14.60172, -14.70591, -14.83362, -14.92122, -15.00622, -15.05122, -15.03119, -14.99028, -14.92302, -14.86927, -14.82691, -14.7972, -14.76909, -14.71356, -14.61277, -14.51696, -14.42252, -14.36405, -14.30451, -14.23161, -14.19851, -14.16633, -14.15649, -14.10504, -13.99518, -13.79562, -13.3996, -12.7767, -11.71208, -8.311879, -8.600912, -9.615928, -10.43595, -11.21292, -11.88333, -12.36243, -12.63706, -12.8818, -12.83066, -12.89103, -12.95666, -13.19763, -13.40598, -13.49113, -13.5546, -13.55639, -13.51915, -13.68284, -13.53289, -13.42107, -13.65519, -13.50713, -13.75251, -13.76715, -13.87408, -13.73109, -13.70412, -13.56073, -13.53488, -13.54895, -13.56228, -13.59408, -13.62047, -13.64198, -13.66109, -13.62669, -13.58297, -13.57387, -13.4739, -13.53063, -13.48348, -13.61047, -13.64716, -13.71546, -13.79184, -13.90614, -14.03098, -14.18205, -14.35881, -14.48419, -14.60172, -14.70591, -14.83362, -14.92122, -15.00622, -15.05122, -15.03119, -14.99028, -14.92302, -14.86927, -14.82691, -14.7972, -14.76909, -14.71356, -14.61277, -14.51696, -14.42252, -14.36405, -14.30451, -14.23161, -14.19851, -14.16633, -14.15649, -14.10504, -13.99518, -13.79562, -13.3996, -12.7767, -11.71208, -8.311879, -8.600912, -9.615928, -10.43595, -11.21292, -11.88333, -12.36243, -12.63706, -12.8818, -12.83066, -12.89103, -12.95666, -13.19763, -13.40598, -13.49113, -13.5546, -13.55639, -13.51915, -13.68284, -13.53289, -13.42107, -13.65519, -13.50713, -13.75251, -13.76715, -13.87408, -13.73109, -13.70412, -13.56073, -13.53488, -13.54895, -13.56228, -13.59408, -13.62047, -13.64198, -13.66109, -13.62669, -13.58297, -13.57387, -13.4739, -13.53063, -13.48348, -13.61047, -13.64716, -13.71546, -13.79184, -13.90614, -14.03098, -14.18205, -14.35881, -14.48419, -14.60172, -14.70591, -14.83362, -14.92122, -15.00622, -15.05122, -15.03119, -14.99028, -14.92302, -14.86927, -14.82691, -14.7972, -14.76909, -14.71356, -14.61277, -14.51696, -14.42252, -14.36405, -14.30451, -14.23161, -14.19851, -14.16633, -14.15649, -14.10504, -13.99518, -13.79562, -13.3996, -12.7767, -11.71208
-        };
-        inv_stddev_ = std::vector<float>{
-            0.155775, 0.154484, 0.1527379, 0.1518718, 0.1506028, 0.1489256, 0.147067, 0.1447061, 0.1436307, 0.1443568, 0.1451849, 0.1455157, 0.1452821, 0.1445717, 0.1439195, 0.1435867, 0.1436018, 0.1438781, 0.1442086, 0.1448844, 0.1454756, 0.145663, 0.146268, 0.1467386, 0.1472724, 0.147664, 0.1480913, 0.1483739, 0.1488841, 0.1493636, 0.1497088, 0.1500379, 0.1502916, 0.1505389, 0.1506787, 0.1507102, 0.1505992, 0.1505445, 0.1505938, 0.1508133, 0.1509569, 0.1512396, 0.1514625, 0.1516195, 0.1516156, 0.1515561, 0.1514966, 0.1513976, 0.1512612, 0.151076, 0.1510596, 0.1510431, 0.151077, 0.1511168, 0.1511917, 0.151023, 0.1508045, 0.1505885, 0.1503493, 0.1502373, 0.1501726, 0.1500762, 0.1500065, 0.1499782, 0.150057, 0.1502658, 0.150469, 0.1505335, 0.1505505, 0.1505328, 0.1504275, 0.1502438, 0.1499674, 0.1497118, 0.1494661, 0.1493102, 0.1493681, 0.1495501, 0.1499738, 0.1509654, 0.155775, 0.154484, 0.1527379, 0.1518718, 0.1506028, 0.1489256, 0.147067, 0.1447061, 0.1436307, 0.1443568, 0.1451849, 0.1455157, 0.1452821, 0.1445717, 0.1439195, 0.1435867, 0.1436018, 0.1438781, 0.1442086, 0.1448844, 0.1454756, 0.145663, 0.146268, 0.1467386, 0.1472724, 0.147664, 0.1480913, 0.1483739, 0.1488841, 0.1493636, 0.1497088, 0.1500379, 0.1502916, 0.1505389, 0.1506787, 0.1507102, 0.1505992, 0.1505445, 0.1505938, 0.1508133, 0.1509569, 0.1512396, 0.1514625, 0.1516195, 0.1516156, 0.1515561, 0.1514966, 0.1513976, 0.1512612, 0.151076, 0.1510596, 0.1510431, 0.151077, 0.1511168, 0.1511917, 0.151023, 0.1508045, 0.1505885, 0.1503493, 0.1502373, 0.1501726, 0.1500762, 0.1500065, 0.1499782, 0.150057, 0.1502658, 0.150469, 0.1505335, 0.1505505, 0.1505328, 0.1504275, 0.1502438, 0.1499674, 0.1497118, 0.1494661, 0.1493102, 0.1493681, 0.1495501, 0.1499738, 0.1509654, 0.155775, 0.154484, 0.1527379, 0.1518718, 0.1506028, 0.1489256, 0.147067, 0.1447061, 0.1436307, 0.1443568, 0.1451849, 0.1455157, 0.1452821, 0.1445717, 0.1439195, 0.1435867, 0.1436018, 0.1438781, 0.1442086, 0.1448844, 0.1454756, 0.145663, 0.146268, 0.1467386, 0.1472724, 0.147664, 0.1480913, 0.1483739, 0.1488841, 0.1493636, 0.1497088, 0.1500379, 0.1502916, 0.1505389, 0.1506787, 0.1507102, 0.1505992, 0.1505445, 0.1505938, 0.1508133, 0.1509569, 0.1512396, 0.1514625, 0.1516195, 0.1516156, 0.1515561, 0.1514966, 0.1513976, 0.1512612, 0.151076, 0.1510596, 0.1510431, 0.151077, 0.1511168, 0.1511917, 0.151023, 0.1508045, 0.1505885, 0.1503493, 0.1502373, 0.1501726, 0.1500762, 0.1500065, 0.1499782, 0.150057, 0.1502658, 0.150469, 0.1505335, 0.1505505, 0.1505328, 0.1504275, 0.1502438, 0.1499674, 0.1497118, 0.1494661, 0.1493102, 0.1493681, 0.1495501, 0.1499738, 0.1509654, 0.155775, 0.154484, 0.1527379, 0.1518718, 0.1506028, 0.1489256, 0.147067, 0.1447061, 0.1436307, 0.1443568, 0.1451849, 0.1455157, 0.1452821, 0.1445717, 0.1439195, 0.1435867, 0.1436018, 0.1438781, 0.1442086, 0.1448844, 0.1454756, 0.145663, 0.146268, 0.1467386, 0.1472724, 0.147664, 0.1480913, 0.1483739, 0.1488841, 0.1493636, 0.1497088, 0.1500379, 0.1502916, 0.1505389, 0.1506787, 0.1507102, 0.1505992, 0.1505445, 0.1505938, 0.1508133, 0.1509569, 0.1512396, 0.1514625, 0.1516195, 0.1516156, 0.1515561, 0.1514966, 0.1513976, 0.1512612, 0.151076, 0.1510596, 0.1510431, 0.151077, 0.1511168, 0.1511917, 0.151023, 0.1508045, 0.1505885, 0.1503493, 0.1502373, 0.1501726, 0.1500762, 0.1500065, 0.1499782, 0.150057, 0.1502658, 0.150469, 0.1505335, 0.1505505, 0.1505328, 0.1504275, 0.1502438, 0.1499674, 0.1497118, 0.1494661, 0.1493102, 0.1493681, 0.1495501, 0.1499738, 0.1509654, 0.155775, 0.154484, 0.1527379, 0.1518718, 0.1506028, 0.1489256, 0.147067, 0.1447061, 0.1436307, 0.1443568, 0.1451849, 0.1455157, 0.1452821, 0.1445717, 0.1439195, 0.1435867, 0.1436018, 0.1438781, 0.1442086, 0.1448844, 0.1454756, 0.145663, 0.146268, 0.1467386, 0.1472724, 0.147664, 0.1480913, 0.1483739, 0.1488841, 0.1493636, 0.1497088, 0.1500379, 0.1502916, 0.1505389, 0.1506787, 0.1507102, 0.1505992, 0.1505445, 0.1505938, 0.1508133, 0.1509569, 0.1512396, 0.1514625, 0.1516195, 0.1516156, 0.1515561, 0.1514966, 0.1513976, 0.1512612, 0.151076, 0.1510596, 0.1510431, 0.151077, 0.1511168, 0.1511917, 0.151023, 0.1508045, 0.1505885, 0.1503493, 0.1502373, 0.1501726, 0.1500762, 0.1500065, 0.1499782, 0.150057, 0.1502658, 0.150469, 0.1505335, 0.1505505, 0.1505328, 0.1504275, 0.1502438, 0.1499674, 0.1497118, 0.1494661, 0.1493102, 0.1493681, 0.1495501, 0.1499738, 0.1509654, 0.155775, 0.154484, 0.1527379, 0.1518718, 0.1506028, 0.1489256, 0.147067, 0.1447061, 0.1436307, 0.1443568, 0.1451849, 0.1455157, 0.1452821, 0.1445717, 0.1439195, 0.1435867, 0.1436018, 0.1438781, 0.1442086, 0.1448844, 0.1454756, 0.145663, 0.146268, 0.1467386, 0.1472724, 0.147664, 0.1480913, 0.1483739, 0.1488841, 0.1493636, 0.1497088, 0.1500379, 0.1502916, 0.1505389, 0.1506787, 0.1507102, 0.1505992, 0.1505445, 0.1505938, 0.1508133, 0.1509569, 0.1512396, 0.1514625, 0.1516195, 0.1516156, 0.1515561, 0.1514966, 0.1513976, 0.1512612, 0.151076, 0.1510596, 0.1510431, 0.151077, 0.1511168, 0.1511917, 0.151023, 0.1508045, 0.1505885, 0.1503493, 0.1502373, 0.1501726, 0.1500762, 0.1500065, 0.1499782, 0.150057, 0.1502658, 0.150469, 0.1505335, 0.1505505, 0.1505328, 0.1504275, 0.1502438, 0.1499674, 0.1497118, 0.1494661, 0.1493102, 0.1493681, 0.1495501, 0.1499738, 0.1509654, 0.155775, 0.154484, 0.1527379, 0.1518718, 0.1506028, 0.1489256, 0.147067, 0.1447061, 0.1436307, 0.1443568, 0.1451849, 0.1455157, 0.1452821, 0.1445717, 0.1439195, 0.1435867, 0.1436018, 0.1438781, 0.1442086, 0.1448844, 0.1454756, 0.145663, 0.146268, 0.1467386, 0.1472724, 0.147664, 0.1480913, 0.1483739, 0.1488841, 0.1493636, 0.1497088, 0.1500379, 0.1502916, 0.1505389, 0.1506787, 0.1507102, 0.1505992, 0.1505445, 0.1505938, 0.1508133, 0.1509569, 0.1512396, 0.1514625, 0.1516195, 0.1516156, 0.1515561, 0.1514966, 0.1513976, 0.1512612, 0.151076, 0.1510596, 0.1510431, 0.151077, 0.1511168, 0.1511917, 0.151023, 0.1508045, 0.1505885, 0.1503493, 0.1502373, 0.1501726, 0.1500762, 0.1500065, 0.1499782, 0.150057, 0.1502658, 0.150469, 0.1505335, 0.1505505, 0.1505328, 0.1504275, 0.1502438, 0.1499674, 0.1497118, 0.1494661, 0.1493102, 0.1493681, 0.1495501, 0.1499738, 0.1509654
-        };
+    // One compiled encoder. sensevoice.axmodel is the full window, optional
+    // sensevoice_<len>.axmodel files are the same network exported with a
+    // shorter sequence length, which is cheaper for short inputs.
+    struct EncoderBucket {
+        std::unique_ptr<AxModelRunner> runner;
+        int max_seq_len;
+        float* feat_input;          // CPU writable input, nullptr if staged in sub_feat_
+        std::vector<int> mask;
+        float latency_ms;
+    };
+
+    bool load_encoder_(const std::string& path) {
+        EncoderBucket enc;
+        enc.runner = std::make_unique<AxModelRunner>();
+        int ret = enc.runner->load_model(path.c_str());
+        if (0 != ret) {
+            ALOGE("Load model %s failed!", path.c_str());
+            return false;
+        }
+        enc.max_seq_len = enc.runner->get_input_shape(0)[1];
+        enc.feat_input = static_cast<float*>(enc.runner->get_input_host_ptr(0));
+        enc.mask.resize(enc.max_seq_len + query_num_);
+        enc.latency_ms = 0;
+        encoders_.push_back(std::move(enc));
+        return true;
+    }
+
+    // Shorter encoders next to the full one, kept sorted by length with the
+    // full window last
+    void load_encoder_buckets_(const std::string& model_path) {
+        DIR* dir = opendir(model_path.c_str());
+        if (!dir)
+            return;
+
+        const std::string prefix = "sensevoice_";
+        const std::string suffix = ".axmodel";
+        std::vector<std::string> names;
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > prefix.size() + suffix.size() && name.compare(0, prefix.size(), prefix) == 0 &&
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+                names.push_back(name);
+        }
+        closedir(dir);
+
+        for (auto& name : names) {
+            if (!load_encoder_(model_path + "/" + name))
+                continue;
+
+            auto& enc = encoders_.back();
+            auto input_shape = enc.runner->get_input_shape(0);
+            auto output_shape = enc.runner->get_output_shape(0);
+            if (enc.max_seq_len >= max_seq_len_ || input_shape[2] != feature_dim_ || output_shape[2] != vocab_size_) {
+                ALOGW("Skip encoder %s, it does not match sensevoice.axmodel", name.c_str());
+                enc.runner->unload_model();
+                encoders_.pop_back();
+            }
+        }
+
+        std::sort(encoders_.begin(), encoders_.end(), [](const EncoderBucket& a, const EncoderBucket& b) {
+            return a.max_seq_len < b.max_seq_len;
+        });
+    }
+
+    // Time every encoder once and send each input length to the fastest
+    // encoder that can hold it. A shorter export is not always faster, so
+    // the boundaries come from the measurement rather than from the sizes.
+    void route_encoder_buckets_(void) {
+        bucket_of_len_.assign(max_seq_len_ + 1, encoders_.size() - 1);
+        if (encoders_.size() < 2)
+            return;
+
+        std::vector<float> zeros((size_t)max_seq_len_ * feature_dim_, 0.0f);
+        int language_token = 0;
+        for (auto& enc : encoders_) {
+            write_slice_(feat_input_begin_(enc), zeros.data(), std::make_pair(0, enc.max_seq_len), enc.max_seq_len);
+            feat_input_end_(enc);
+            sequence_mask_(enc, enc.max_seq_len);
+            enc.runner->set_input(1, enc.mask.data());
+            enc.runner->set_input(2, &language_token);
+
+            // First run warms up caches, keep the best of the rest
+            enc.latency_ms = std::numeric_limits<float>::max();
+            for (int i = 0; i < 3; i++) {
+                Timer timer;
+                timer.start();
+                enc.runner->run();
+                timer.stop();
+                if (i > 0)
+                    enc.latency_ms = std::min(enc.latency_ms, timer.elapsed<std::chrono::milliseconds>());
+            }
+            ALOGI("Encoder bucket: max_seq_len=%d latency=%.2fms", enc.max_seq_len, enc.latency_ms);
+        }
+
+        for (int len = 0; len <= max_seq_len_; len++) {
+            int best = encoders_.size() - 1;
+            for (int b = 0; b < (int)encoders_.size(); b++) {
+                if (encoders_[b].max_seq_len >= len && encoders_[b].latency_ms < encoders_[best].latency_ms)
+                    best = b;
+            }
+            bucket_of_len_[len] = best;
+        }
+    }
+
+    // Encoder to run seq_len frames on
+    inline EncoderBucket& encoder_for_(int seq_len) {
+        return encoders_[bucket_of_len_[std::min(std::max(seq_len, 0), max_seq_len_)]];
+    }
+
+    void init_frontend_(void) {
+        frontend_config_ = funasr_frontend_config(dither_mode_);
     }
 
     bool load_tokens_(const std::string& token_path) {
@@ -192,136 +504,474 @@ private:
         return true;
     }
 
-    void preprocess_(const std::vector<float>& audio_data, bool normalize, std::vector<float>& features, int& num_frames) {
-        fbank_->AcceptWaveform(sample_rate_, audio_data.data(), audio_data.size());
-        fbank_->InputFinished();
+    int language_token_(const std::string& language) const {
+        // find() instead of operator[], run() may be called concurrently
+        auto lid = lid_dict_.find(language);
+        return lid != lid_dict_.end() ? lid->second : 0;
+    }
 
-        int32_t n = fbank_->NumFramesReady();
+    // The single buffer path of run_native() and run_detailed(): audio is
+    // mono at sample_rate_, VAD reads it before the frontend scales it in place.
+    // language, if set, receives the detected language, see postprocess_().
+    bool recognize_(std::vector<float>& audio, int language_token, std::vector<CtcToken>& asr_res, bool with_prob,
+                    std::string* language = nullptr) {
+        LfrFrontendConfig frontend_config;
+        bool vad_enabled;
+        utils::EnergyVadConfig vad_config;
+        copy_params_(frontend_config, vad_enabled, vad_config);
+
+        std::vector<utils::VadSegment> segments;
+        if (vad_enabled)
+            find_speech_(vad_config, audio.data(), audio.size(), sample_rate_, segments);
+
+        // A frontend of its own, so concurrent requests extract features
+        // while this one holds the encoder
+        LfrFrontend frontend(frontend_config);
+        frontend.accept_waveform_inplace(audio.data(), audio.size(), sample_rate_);
+        frontend.input_finished();
+
+        int feat_len = frontend.num_frames_ready();
+        if (!vad_enabled && feat_len > 0 && feat_len <= max_seq_len_) {
+            // One slice: frames go straight into the encoder input
+            std::lock_guard<std::mutex> lock(encoder_mutex_);
+
+            auto& enc = encoder_for_(feat_len);
+            float* feat = feat_input_begin_(enc);
+            frontend.pop_frames(feat, feat_len);
+            std::fill(feat + (size_t)feat_len * feature_dim_, feat + (size_t)enc.max_seq_len * feature_dim_, 0.0f);
+            feat_input_end_(enc);
+            if (!run_encoder_(enc, feat_len, language_token, ctc_logits_.data(), &encoder_out_lens_))
+                return false;
 
-        features.resize(n * n_mels_);
+            postprocess_(ctc_logits_, encoder_out_lens_, 0, asr_res, with_prob, language);
+            return true;
+        }
 
-        ALOGD("preprocess: normalize: %d", normalize);
-        ALOGD("preprocess: feature dim: %d %d", n, n_mels_);
+        // VAD segments and overlapping slices index the whole utterance
+        std::vector<float> features;
+        feat_len = frontend.pop_frames(features);
+        return decode_utterance_(vad_enabled ? &segments : nullptr, sample_rate_, features, feat_len, language_token, asr_res,
+                                 with_prob, language);
+    }
 
-        float *p = features.data();
+    LfrFrontendConfig frontend_config_copy_(void) {
+        std::lock_guard<std::mutex> lock(frontend_mutex_);
+        return frontend_config_;
+    }
 
-        for (int32_t i = 0; i < n; ++i) {
-            const float *f = fbank_->GetFrame(i);
-            std::copy(f, f + n_mels_, p);
-            p += n_mels_;
-        }
+    // Settings set_param() may change, copied once per request so a run
+    // sees one consistent set
+    void copy_params_(LfrFrontendConfig& frontend_config, bool& vad_enabled, utils::EnergyVadConfig& vad_config) {
+        std::lock_guard<std::mutex> lock(frontend_mutex_);
+        frontend_config = frontend_config_;
+        vad_enabled = vad_enabled_;
+        vad_config = vad_config_;
+    }
 
-        if (normalize)
-            normalize_features_(features.data(), n, n_mels_);
+    // Speech segments of audio, for runs with VAD enabled
+    void find_speech_(const utils::EnergyVadConfig& vad_config, const float* audio, size_t num_samples, int sample_rate,
+                      std::vector<utils::VadSegment>& segments) {
+        utils::EnergyVad vad(vad_config);
+        segments = vad.detect(audio, num_samples, sample_rate);
+    }
 
-        features = apply_lfr_(features);
-        apply_cmvn_(&features);
+    // speech: segments from find_speech_(), nullptr decodes the whole utterance
+    bool decode_utterance_(const std::vector<utils::VadSegment>* speech, int sample_rate, const std::vector<float>& features,
+                           int feat_len, int language_token, std::vector<CtcToken>& asr_res, bool with_prob = false,
+                           std::string* language = nullptr) {
+        if (speech)
+            return decode_speech_(*speech, sample_rate, features.data(), feat_len, language_token, asr_res, with_prob,
+                                  language);
+        return decode_(features.data(), feat_len, language_token, asr_res, 0, with_prob, language);
+    }
 
-        feature_dim_ = n_mels_ * lfr_window_size_;
-        num_frames = features.size() / feature_dim_;
-        ALOGD("preprocess: final feature dim: %d %d", num_frames, feature_dim_);
+    // Features of silence, used to separate packed utterances
+    void init_silence_frame_(void) {
+        LfrFrontend frontend(frontend_config_);
+        std::vector<float> zeros(sample_rate_ / 2, 0.0f);
+        frontend.accept_waveform(zeros.data(), zeros.size(), sample_rate_);
+        frontend.input_finished();
+
+        std::vector<float> frames;
+        int n = frontend.pop_frames(frames);
+        silence_frame_.assign(feature_dim_, 0.0f);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < feature_dim_; j++) {
+                silence_frame_[j] += frames[i * feature_dim_ + j] / n;
+            }
+        }
     }
 
-    void normalize_features_(float *p, int32_t num_frames,
-                                      int32_t feature_dim) {
-        using RowMajorMat =
-            Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    // One encoder run over the utterances in pack, laid out as
+    // [utt0][gap][utt1][gap]...[uttN] with gap = silence frames
+    bool decode_packed_(const std::vector<int>& pack, const std::vector<std::vector<float>>& features,
+                        const std::vector<int>& feat_lens, int language_token, std::vector<std::string>& text_results) {
+        std::vector<int> offsets(pack.size());
+        std::vector<CtcToken> asr_res;
+        {
+            int total = 0;
+            for (size_t k = 0; k < pack.size(); k++) {
+                total += (k > 0 ? pack_gap_frames_ : 0) + feat_lens[pack[k]];
+            }
 
-        Eigen::Map<RowMajorMat> x(p, num_frames, feature_dim);
+            std::lock_guard<std::mutex> lock(encoder_mutex_);
+
+            auto& enc = encoder_for_(total);
+            float* feat = feat_input_begin_(enc);
+            int pos = 0;
+            for (size_t k = 0; k < pack.size(); k++) {
+                if (k > 0) {
+                    for (int g = 0; g < pack_gap_frames_; g++, pos++) {
+                        memcpy(feat + (size_t)pos * feature_dim_, silence_frame_.data(), feature_dim_ * sizeof(float));
+                    }
+                }
+                offsets[k] = pos;
+                int len = feat_lens[pack[k]];
+                memcpy(feat + (size_t)pos * feature_dim_, features[pack[k]].data(), (size_t)len * feature_dim_ * sizeof(float));
+                pos += len;
+            }
+            std::fill(feat + (size_t)pos * feature_dim_, feat + (size_t)enc.max_seq_len * feature_dim_, 0.0f);
+            feat_input_end_(enc);
+            ALOGD("Packed %zu utterances into %d/%d frames", pack.size(), pos, enc.max_seq_len);
 
-        Eigen::RowVectorXf mean = x.colwise().mean();
-        Eigen::RowVectorXf var =
-            (x.array().square().colwise().mean() - mean.array().square())
-                .max(0.0f);  // avoid negative due to FP error
+            if (!run_encoder_(enc, pos, language_token, ctc_logits_.data(), &encoder_out_lens_))
+                return false;
+            postprocess_(ctc_logits_, encoder_out_lens_, 0, asr_res);
+        }
 
-        Eigen::RowVectorXf inv_std = (var.array().sqrt() + 1e-5f).inverse();
+        // A token may be emitted a little after its audio, so each utterance
+        // also owns the first half of the gap that follows it
+        size_t t = 0;
+        std::vector<CtcToken> utt_res;
+        for (size_t k = 0; k < pack.size(); k++) {
+            int begin = offsets[k];
+            int end = offsets[k] + feat_lens[pack[k]] + pack_gap_frames_ / 2;
+
+            utt_res.clear();
+            for (; t < asr_res.size() && asr_res[t].start < end; t++) {
+                if (asr_res[t].start >= begin)
+                    utt_res.push_back(asr_res[t]);
+            }
+            tokens_to_text_(utt_res, text_results[pack[k]]);
+        }
+        return true;
+    }
 
-        x.array() =
-            (x.array().rowwise() - mean.array()).rowwise() * inv_std.array();
+    // Encode only the speech found by VAD, one encoder run per segment
+    bool decode_speech_(const std::vector<utils::VadSegment>& segments, int sample_rate,
+                        const float* features, int num_frames, int language_token, std::vector<CtcToken>& asr_res,
+                        bool with_prob, std::string* language = nullptr) {
+        // LFR frame i starts at i * frame_ms
+        const double frame_ms = lfr_window_shift_ * 10;
+        int speech_frames = 0;
+        for (auto& seg : segments) {
+            int start = (int)(seg.start * 1000.0 / sample_rate / frame_ms);
+            int end = (int)std::ceil(seg.end * 1000.0 / sample_rate / frame_ms);
+            end = std::min(end, num_frames);
+            if (end <= start)
+                continue;
+
+            speech_frames += end - start;
+            if (!decode_(features + (size_t)start * feature_dim_, end - start, language_token, asr_res, start, with_prob,
+                         language))
+                return false;
+            // The first segment decides the language
+            language = nullptr;
+        }
+        ALOGD("VAD: %zu segments, %d/%d frames encoded", segments.size(), speech_frames, num_frames);
+        return true;
     }
 
-    std::vector<float> apply_lfr_(const std::vector<float> &in) const {
-        int32_t in_feat_dim = n_mels_;
+    // Run the encoder over num_frames LFR frames, in max_seq_len_ slices,
+    // and append the CTC tokens to asr_res. features is frame frame_offset
+    // of the utterance, token frames are relative to the utterance start.
+    // with_prob also fills in CtcToken::prob, language the language
+    // detected in the first slice.
+    // Safe to call from several threads, the encoder is held exclusively
+    // per slice.
+    bool decode_(const float* features, int num_frames, int language_token, std::vector<CtcToken>& asr_res,
+                 int frame_offset = 0, bool with_prob = false, std::string* language = nullptr) {
+        int slice_len = max_seq_len_;
+        int slice_num = static_cast<int>(std::ceil(num_frames * 1.0f / slice_len));
+        ALOGD("feat_len=%d slice_len=%d slice_num=%d", num_frames, slice_len, slice_num);
+
+        // [start, end) of every slice, consecutive slices overlap by padding_
+        std::vector<std::pair<int, int>> slices;
+        for (int i = 0; i < slice_num; i++) {
+            int slice_start = i == 0 ? 0 : i * slice_len - padding_;
+            int slice_end = std::min((i + 1) * slice_len - (i == 0 ? 0 : padding_), num_frames);
+            if (slice_start >= num_frames)
+                break;
+            slices.emplace_back(slice_start, slice_end);
+        }
+
+        if (slices.size() > 1)
+            return decode_pipelined_(features, slices, language_token, asr_res, frame_offset, with_prob, language);
+
+        for (auto& slice : slices) {
+            ALOGD("Slice: start=%d end=%d", slice.first, slice.second);
 
-        int32_t in_num_frames = in.size() / in_feat_dim;
-        int32_t out_num_frames =
-            (in_num_frames - lfr_window_size_) / lfr_window_shift_ + 1;
-        int32_t out_feat_dim = in_feat_dim * lfr_window_size_;
+            std::lock_guard<std::mutex> lock(encoder_mutex_);
 
-        std::vector<float> out(out_num_frames * out_feat_dim);
+            auto& enc = encoder_for_(slice.second - slice.first);
+            write_slice_(feat_input_begin_(enc), features, slice, enc.max_seq_len);
+            feat_input_end_(enc);
+            if (!run_encoder_(enc, slice.second - slice.first, language_token, ctc_logits_.data(), &encoder_out_lens_))
+                return false;
 
-        const float *p_in = in.data();
-        float *p_out = out.data();
+            postprocess_(ctc_logits_, encoder_out_lens_, frame_offset + slice.first, asr_res, with_prob, language);
+        }
+        return true;
+    }
 
-        for (int32_t i = 0; i != out_num_frames; ++i) {
-            std::copy(p_in, p_in + out_feat_dim, p_out);
+    // Long audio: while slice i is on the NPU, one CPU task of this call
+    // decodes the CTC output of slice i-1. The encoder is only held for
+    // each slice's run, so other requests get the NPU in between. Logits
+    // alternate between two buffers owned by the call, and nothing shared
+    // outlives the lock.
+    bool decode_pipelined_(const float* features, const std::vector<std::pair<int, int>>& slices,
+                           int language_token, std::vector<CtcToken>& asr_res, int frame_offset, bool with_prob,
+                           std::string* language) {
+        const int slice_num = slices.size();
+        std::vector<float> logits[2];
+        int out_lens[2] = {0, 0};
+
+        // Slices [consumed, produced) wait for the CPU task
+        std::mutex mutex;
+        std::condition_variable cv;
+        int produced = 0, consumed = 0;
+        bool finished = false;
+
+        auto cpu_stage = std::async(std::launch::async, [&] {
+            for (int i = 0; ; i++) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return produced > i || finished; });
+                    if (produced <= i)
+                        return;
+                }
+                postprocess_(logits[i & 1], out_lens[i & 1], frame_offset + slices[i].first, asr_res, with_prob,
+                             i == 0 ? language : nullptr);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    consumed = i + 1;
+                }
+                cv.notify_all();
+            }
+        });
+
+        bool ok = true;
+        for (int i = 0; i < slice_num && ok; i++) {
+            ALOGD("Slice %d: start=%d end=%d", i, slices[i].first, slices[i].second);
+            {
+                // Buffer i & 1 is free again once slice i-2 is decoded
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return consumed >= i - 1; });
+            }
+            std::vector<float>& out = logits[i & 1];
+            if (out.empty())
+                out.resize(ctc_logits_.size());
+
+            // Only the last slice can be short enough for a smaller encoder
+            const int seq_len = slices[i].second - slices[i].first;
+            {
+                std::lock_guard<std::mutex> lock(encoder_mutex_);
+
+                auto& enc = encoder_for_(seq_len);
+                write_slice_(feat_input_begin_(enc), features, slices[i], enc.max_seq_len);
+                feat_input_end_(enc);
+                ok = run_encoder_(enc, seq_len, language_token, out.data(), &out_lens[i & 1]);
+            }
+            if (ok) {
+                std::lock_guard<std::mutex> lock(mutex);
+                produced = i + 1;
+            }
+            cv.notify_all();
+        }
 
-            p_out += out_feat_dim;
-            p_in += lfr_window_shift_ * in_feat_dim;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
         }
+        cv.notify_all();
+        cpu_stage.wait();
+        return ok;
+    }
 
-        return out;
+    // Copy one slice of features into a buffer of seq_len frames, zero the rest
+    void write_slice_(float* feat, const float* features, const std::pair<int, int>& slice, int seq_len) {
+        size_t len = (size_t)(slice.second - slice.first) * feature_dim_;
+        memcpy(feat, features + (size_t)slice.first * feature_dim_, len * sizeof(float));
+        std::fill(feat + len, feat + (size_t)seq_len * feature_dim_, 0.0f);
     }
 
-    void apply_cmvn_(std::vector<float> *v) const {
-        int32_t dim = static_cast<int32_t>(neg_mean_.size());
-        int32_t num_frames = static_cast<int32_t>(v->size()) / dim;
-        Eigen::Map<
-            Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
-            mat(v->data(), num_frames, dim);
-        Eigen::Map<const Eigen::RowVectorXf> neg_mean_vec(neg_mean_.data(), dim);
+    // Encoder run on the features already in place, CTC output goes to
+    // logits and out_len. Call with encoder_mutex_ held.
+    bool run_encoder_(EncoderBucket& enc, int actual_seq_len, int language_token, float* logits, int* out_len) {
+        sequence_mask_(enc, actual_seq_len);
 
-        Eigen::Map<const Eigen::RowVectorXf> inv_stddev_vec(inv_stddev_.data(), dim);
-        mat.array() = (mat.array().rowwise() + neg_mean_vec.array()).rowwise() *
-                    inv_stddev_vec.array();
+        enc.runner->set_input(1, enc.mask.data());
+        enc.runner->set_input(2, &language_token);
+
+        int ret = enc.runner->run();
+        if (0 != ret) {
+            ALOGE("Run encoder failed! ret=0x%x", ret);
+            return false;
+        }
+
+        enc.runner->get_output(0, logits);
+        enc.runner->get_output(1, out_len);
+        return true;
     }
 
-    void sequence_mask_(int actual_seq_len) {
-        std::fill(mask_.begin(), mask_.end(), 0);
-        std::fill(mask_.begin(), mask_.begin() + actual_seq_len, 1);
+    void tokens_to_text_(const std::vector<CtcToken>& asr_res, std::string& text_result) {
+        text_result.clear();
+        text_result.reserve(256);
+        ALOGD("asr_res.size() = %zu", asr_res.size());
+        for (auto& token : asr_res) {
+            if (token.id >= 0 && token.id < (int)tokens_.size())
+                text_result.append(tokens_[token.id]);
+        }
     }
 
-    std::vector<int> postprocess_(const std::vector<float>& ctc_logits, int encoder_out_lens) {
-        ALOGD("postprocess: encoder_out_lens=%d", encoder_out_lens);
+    // Token timestamps straight from the CTC frames. Words follow the
+    // sentencepiece convention: a piece starting with U+2581 opens a new
+    // word, other latin pieces continue the current one, every CJK
+    // character is a word of its own and punctuation sticks to the word
+    // before it without moving its end time.
+    void tokens_to_timestamps_(const std::vector<CtcToken>& asr_res, ASRResult& result) {
+        static const char kWordBoundary[] = "\xe2\x96\x81";
+        const size_t boundary_len = sizeof(kWordBoundary) - 1;
+        const int frame_ms = lfr_window_shift_ * 10;
+
+        result.tokens.clear();
+        result.words.clear();
+        result.tokens.reserve(asr_res.size());
+
+        bool word_open = false;
+        for (auto& token : asr_res) {
+            if (token.id < 0 || token.id >= (int)tokens_.size())
+                continue;
+
+            ASRTimestamp ts;
+            ts.text = tokens_[token.id];
+            ts.start_ms = token.start * frame_ms;
+            ts.end_ms = token.end * frame_ms;
+            result.tokens.push_back(ts);
+
+            bool boundary = ts.text.compare(0, boundary_len, kWordBoundary) == 0;
+            if (boundary)
+                ts.text.erase(0, boundary_len);
+            if (ts.text.empty()) {
+                word_open = false;
+                continue;
+            }
+
+            if (is_punctuation_(ts.text)) {
+                if (!result.words.empty())
+                    result.words.back().text += ts.text;
+                word_open = false;
+                continue;
+            }
 
-        std::vector<int> token_int;
-        if (encoder_out_lens <= 4)
-            return token_int;
-            
-        std::vector<int> yseq(encoder_out_lens - 4);
-        for (int i = 4; i < encoder_out_lens; i++) {
-            auto max_it = std::max_element(
-                ctc_logits.begin() + i * vocab_size_, 
-                ctc_logits.begin() + (i + 1) * vocab_size_);
-            yseq[i - 4] = std::distance(ctc_logits.begin() + i * vocab_size_, max_it);
-        }
-
-        ALOGD("before unique_consecutive: yseq.size() = %u", yseq.size());
-        unique_consecutive_(yseq);
-        ALOGD("after unique_consecutive: yseq.size() = %u", yseq.size());
-
-        token_int.reserve(encoder_out_lens - 4);
-        for (auto i : yseq) {
-            if (i != 0) {
-                token_int.push_back(i);
+            bool latin = (unsigned char)ts.text[0] < 0x80;
+            if (word_open && latin && !boundary) {
+                result.words.back().text += ts.text;
+                result.words.back().end_ms = ts.end_ms;
+            } else {
+                result.words.push_back(ts);
             }
+            word_open = (unsigned char)ts.text.back() < 0x80;
+        }
+    }
+
+    static bool is_punctuation_(const std::string& piece) {
+        static const char* kCjkPunct[] = {
+            "\xef\xbc\x8c", "\xe3\x80\x82", "\xef\xbc\x9f", "\xef\xbc\x81",    // ，。？！
+            "\xe3\x80\x81", "\xef\xbc\x9b", "\xef\xbc\x9a",                   // 、；：
+        };
+        for (auto p : kCjkPunct) {
+            if (piece == p)
+                return true;
         }
-        return token_int;
+        for (unsigned char c : piece) {
+            if (c >= 0x80 || !ispunct(c))
+                return false;
+        }
+        return true;
+    }
+
+    // Features are written straight into the encoder input when the runner
+    // exposes it to the CPU, otherwise staged in sub_feat_ and copied.
+    // Call with encoder_mutex_ held.
+    inline float* feat_input_begin_(EncoderBucket& enc) {
+        return enc.feat_input ? enc.feat_input : sub_feat_.data();
+    }
+
+    inline void feat_input_end_(EncoderBucket& enc) {
+        if (!enc.feat_input)
+            enc.runner->set_input(0, sub_feat_.data());
+    }
+
+    void sequence_mask_(EncoderBucket& enc, int actual_seq_len) {
+        std::fill(enc.mask.begin(), enc.mask.end(), 0);
+        std::fill(enc.mask.begin(), enc.mask.begin() + actual_seq_len, 1);
+    }
+
+    // Greedy CTC over the output frames, the query frames are skipped so
+    // output frame i belongs to input frame frame_offset + i. The first
+    // query frame is the language query, language, if set, receives the
+    // code it picked ("zh", "en", ...) or stays empty.
+    void postprocess_(const std::vector<float>& ctc_logits, int encoder_out_lens, int frame_offset,
+                      std::vector<CtcToken>& asr_res, bool with_prob = false, std::string* language = nullptr) {
+        ALOGD("postprocess: encoder_out_lens=%d", encoder_out_lens);
+        if (language && encoder_out_lens > 0)
+            detect_language_(ctc_logits.data(), *language);
+        if (encoder_out_lens <= query_num_)
+            return;
+
+        ctc_decoder_.decode(ctc_logits.data() + (size_t)query_num_ * vocab_size_, encoder_out_lens - query_num_,
+                            vocab_size_, frame_offset, asr_res, with_prob);
+    }
+
+    // Language tokens are "<|zh|>", "<|en|>", ...
+    void detect_language_(const float* row, std::string& language) const {
+        int id = utils::argmax_f32(row, vocab_size_);
+        if (id < 0 || id >= (int)tokens_.size())
+            return;
+        const std::string& token = tokens_[id];
+        if (token.size() < 5 || token.compare(0, 2, "<|") != 0 || token.compare(token.size() - 2, 2, "|>") != 0)
+            return;
+        std::string code = token.substr(2, token.size() - 4);
+        if (code != "auto" && lid_dict_.count(code))
+            language = code;
     }
 
-    void unique_consecutive_(std::vector<int>& arr) {
-        auto new_end = std::unique(arr.begin(), arr.end());
-        arr.erase(new_end, arr.end());
+    // Mean posterior of tokens decoded with_prob, 1 when nothing was heard
+    // since there is nothing to doubt
+    static float mean_prob_(const std::vector<CtcToken>& asr_res) {
+        if (asr_res.empty())
+            return 1.0f;
+        float sum = 0.0f;
+        for (auto& token : asr_res) {
+            sum += token.prob;
+        }
+        return sum / asr_res.size();
     }
 
 private:
-    AxModelRunner encoder_;    
+    // Sorted by max_seq_len, the full window last
+    std::vector<EncoderBucket> encoders_;
+    // Index into encoders_ for every input length up to max_seq_len_
+    std::vector<int> bucket_of_len_;
+    // Guards encoders_ and the buffers around them, shared by run() and all streams
+    std::mutex encoder_mutex_;
     int sample_rate_;
     int n_mels_;
-    std::unique_ptr<knf::OnlineFbank> fbank_;
+    // Every request and stream builds its own frontend from this
+    LfrFrontendConfig frontend_config_;
+    std::mutex frontend_mutex_;
     int lfr_window_size_, lfr_window_shift_;
-    std::vector<float> neg_mean_, inv_stddev_;
-    std::vector<int> mask_;
     std::vector<float> sub_feat_;
     int max_seq_len_, feature_dim_;
     std::map<std::string, int> lid_dict_{
@@ -334,110 +984,166 @@ private:
     };
     int query_num_;
     int padding_;
+    LfrDitherMode dither_mode_ = LFR_DITHER_DETERMINISTIC;
+    bool vad_enabled_ = true;
+    int pack_gap_frames_ = 8;
+    std::vector<float> silence_frame_;
+    utils::EnergyVadConfig vad_config_;
     int vocab_size_;
+    CtcGreedyDecoder ctc_decoder_;
+    // CTC output of single runs, pipelined runs have buffers of their own.
+    // Guarded by encoder_mutex_.
     std::vector<float> ctc_logits_;
     int encoder_out_lens_;
     std::vector<std::string> tokens_;
+};
 
-    // ---- Streaming state ----
-    std::vector<float> stream_features_;   // accumulated fbank features
-    int stream_total_frames_ = 0;          // total frames accumulated
-    std::string stream_partial_text_;      // latest partial result
-    std::mutex stream_mutex_;
+// Streaming session, owns its frontend and features and borrows the encoder
+class SensevoiceStream : public ASRStream {
+public:
+    explicit SensevoiceStream(Sensevoice::Impl& model):
+        model_(model),
+        frontend_(model.frontend_config_copy_()) {
 
-    void stream_init(void) {
-        std::lock_guard<std::mutex> lock(stream_mutex_);
-        init_fbank_();
-        stream_features_.clear();
-        stream_total_frames_ = 0;
-        stream_partial_text_.clear();
     }
 
-    void stream_feed(const std::vector<float>& pcm_chunk, int sample_rate) {
-        if (pcm_chunk.empty()) return;
+    using ASRStream::feed;
+    void feed(const float* pcm, size_t num_samples, int sample_rate) {
+        if (num_samples == 0) return;
 
-        // Resample to 16kHz, convert to int16
-        auto resampled = utils::resample(pcm_chunk, sample_rate, sample_rate_);
-        std::vector<float> buf_int16(resampled.size());
-        for (size_t i = 0; i < resampled.size(); ++i)
-            buf_int16[i] = resampled[i] * 32768.0f;
+        std::lock_guard<std::mutex> lock(mutex_);
 
-        // Feed to fbank (accumulating)
-        std::vector<float> chunk_feats;
-        int chunk_feat_len = 0;
-        preprocess_(buf_int16, true, chunk_feats, chunk_feat_len);
-
-        if (chunk_feat_len <= 0) return;
+        // Only the new audio goes through resample/fbank/LFR, the frontend
+        // keeps whatever it could not consume yet for the next chunk.
+        frontend_.accept_waveform(pcm, num_samples, sample_rate);
+        endpoint_.accept_waveform(pcm, num_samples, sample_rate);
+        decode_features_();
+    }
 
-        std::lock_guard<std::mutex> lock(stream_mutex_);
-        stream_features_.insert(stream_features_.end(), chunk_feats.begin(), chunk_feats.end());
-        stream_total_frames_ += chunk_feat_len;
+    void feed_s16(const int16_t* pcm, size_t num_samples, int sample_rate) {
+        if (num_samples == 0) return;
 
-        // Run CTC inference on accumulated features (sliding window)
-        run_stream_inference_();
+        std::lock_guard<std::mutex> lock(mutex_);
+        frontend_.accept_waveform_s16(pcm, num_samples, sample_rate);
+        endpoint_.accept_waveform(pcm, num_samples, sample_rate);
+        decode_features_();
     }
 
-    void run_stream_inference_(void) {
-        if (stream_total_frames_ == 0) return;
+    void set_endpoint(const AX_ASR_ENDPOINT_CONFIG_T& config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        endpoint_.set_config(config);
+        endpoint_.reset();
+    }
 
-        int slice_len = max_seq_len_;
-        int total = stream_total_frames_;
-        int slice_num = std::max(1, (int)std::ceil(total * 1.0f / slice_len));
+    using ASRStream::pop_final;
+    bool pop_final(ASRFinalResult& final_result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (finals_.empty()) return false;
+        final_result = std::move(finals_.front());
+        finals_.pop_front();
+        return true;
+    }
 
-        std::vector<int> asr_res;
+    bool result(std::string& partial_text) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (partial_text_.empty()) return false;
+        partial_text = partial_text_;
+        return true;
+    }
 
-        for (int i = 0; i < slice_num; i++) {
-            int slice_start, slice_end;
-            if (i == 0) {
-                slice_start = 0;
-                slice_end = std::min(slice_len, total);
-            } else {
-                slice_start = i * slice_len - padding_;
-                slice_end = std::min((i + 1) * slice_len - padding_, total);
-            }
-            if (slice_start >= total) break;
+    void reset(void) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frontend_.reset();
+        features_.clear();
+        total_frames_ = 0;
+        utterance_start_ = 0;
+        asr_res_.clear();
+        partial_text_.clear();
+        language_.clear();
+        finals_.clear();
+        endpoint_.reset();
+    }
 
-            int actual_seq_len = slice_end - slice_start;
-            std::fill(sub_feat_.begin(), sub_feat_.end(), 0.0f);
-            memcpy(sub_feat_.data(),
-                   stream_features_.data() + slice_start * feature_dim_,
-                   actual_seq_len * feature_dim_ * sizeof(float));
+private:
+    // Decode what the new chunk added to the frontend, under mutex_
+    void decode_features_(void) {
+        int chunk_feat_len = frontend_.pop_frames(features_);
+        if (chunk_feat_len <= 0) return;
 
-            sequence_mask_(actual_seq_len);
+        total_frames_ += chunk_feat_len;
 
-            int lang_token = 0; // auto
-            encoder_.set_input(0, sub_feat_.data());
-            encoder_.set_input(1, mask_.data());
-            encoder_.set_input(2, &lang_token);
+        // Run CTC inference on accumulated features (sliding window)
+        asr_res_.clear();
+        int lang_token = 0; // auto
+        // Posteriors are only needed for the confidence of finals
+        if (!model_.decode_(features_.data(), total_frames_, lang_token, asr_res_, 0, endpoint_.enabled(), &language_))
+            return;
 
-            int ret = encoder_.run();
-            if (0 != ret) return;
+        model_.tokens_to_text_(asr_res_, partial_text_);
 
-            encoder_.get_output(0, ctc_logits_.data());
-            encoder_.get_output(1, &encoder_out_lens_);
+        check_endpoint_();
+    }
 
-            auto token_int = postprocess_(ctc_logits_, encoder_out_lens_);
-            asr_res.insert(asr_res.end(), token_int.begin(), token_int.end());
+    void check_endpoint_(void) {
+        if (!endpoint_.enabled())
+            return;
+
+        // Frames of the first and last non-blank CTC output, -1 if none.
+        // Slices overlap, so tokens are not strictly ordered by frame.
+        int first = -1, last = -1;
+        for (auto& token : asr_res_) {
+            if (first < 0 || token.start < first)
+                first = token.start;
+            last = std::max(last, token.end - 1);
         }
 
-        stream_partial_text_.clear();
-        stream_partial_text_.reserve(256);
-        for (auto i : asr_res) {
-            if (i >= 0 && i < (int)tokens_.size())
-                stream_partial_text_.append(tokens_[i]);
+        const int frame_ms = model_.lfr_window_shift_ * 10;
+        int speech_ms = first < 0 ? 0 : (last - first + 1) * frame_ms;
+        int trailing_ms = (total_frames_ - 1 - last) * frame_ms;
+
+        auto decision = endpoint_.detect(total_frames_ * frame_ms, speech_ms, trailing_ms);
+        if (decision == EndpointDetector::ENDPOINT_NONE)
+            return;
+
+        if (decision == EndpointDetector::ENDPOINT_FINALIZE) {
+            ALOGD("Endpoint: utterance %dms speech %dms trailing %dms", total_frames_ * frame_ms, speech_ms, trailing_ms);
+            if (finals_.size() >= MAX_PENDING_FINALS) {
+                ALOGW("Final results not consumed, drop the oldest one");
+                finals_.pop_front();
+            }
+            ASRFinalResult final_result;
+            final_result.text = partial_text_;
+            final_result.start_ms = utterance_start_ * frame_ms;
+            final_result.end_ms = (utterance_start_ + total_frames_) * frame_ms;
+            final_result.confidence = Sensevoice::Impl::mean_prob_(asr_res_);
+            final_result.language = language_;
+            finals_.push_back(std::move(final_result));
         }
-    }
 
-    bool stream_result(std::string& partial_text) {
-        std::lock_guard<std::mutex> lock(stream_mutex_);
-        if (stream_partial_text_.empty()) return false;
-        partial_text = stream_partial_text_;
-        return true;
+        // Start the next utterance, the frontend keeps its state since the
+        // audio itself is continuous
+        features_.clear();
+        utterance_start_ += total_frames_;
+        total_frames_ = 0;
+        partial_text_.clear();
+        language_.clear();
+        endpoint_.reset();
     }
 
-    void stream_reset(void) {
-        stream_init();
-    }
+private:
+    static constexpr size_t MAX_PENDING_FINALS = 64;
+
+    Sensevoice::Impl& model_;
+    LfrFrontend frontend_;                 // carries resampler/fbank/LFR state across chunks
+    std::vector<float> features_;          // accumulated LFR + CMVN features of the current utterance
+    int total_frames_ = 0;                 // frames of the current utterance
+    int utterance_start_ = 0;              // frames before the current utterance since reset()
+    std::vector<CtcToken> asr_res_;        // tokens of the latest decode
+    std::string partial_text_;             // latest partial result
+    std::string language_;                 // language of the latest decode, empty if not detected
+    EndpointDetector endpoint_;
+    std::deque<ASRFinalResult> finals_;    // finalized utterances not yet popped
+    std::mutex mutex_;
 };
 
 Sensevoice::Sensevoice():
@@ -461,18 +1167,42 @@ bool Sensevoice::run(const std::vector<float>& audio_data, int sample_rate, cons
     return impl_->run(audio_data, sample_rate, language, text_result);
 }
 
-void Sensevoice::stream_init() {
-    impl_->stream_init();
+bool Sensevoice::run_native(std::vector<float>& audio, const std::string& language, std::string& text_result) {
+    return impl_->run_native(audio, language, text_result);
+}
+
+bool Sensevoice::run_reader(utils::AudioReader& reader, const std::string& language, std::string& text_result,
+                            const ASRSegmentCallback& on_segment) {
+    return impl_->run_reader(reader, language, text_result, on_segment);
+}
+
+bool Sensevoice::run_native_detailed(std::vector<float>& audio, const std::string& language, ASRResult& result) {
+    return impl_->run_native_detailed(audio, language, result);
+}
+
+bool Sensevoice::run_detailed(const std::vector<float>& audio_data, int sample_rate, const std::string& language,
+                              ASRResult& result) {
+    return impl_->run_detailed(audio_data, sample_rate, language, result);
+}
+
+std::unique_ptr<ASRPrepared> Sensevoice::prepare(std::vector<float>& audio) {
+    return impl_->prepare(audio);
 }
 
-void Sensevoice::stream_feed(const std::vector<float>& pcm_chunk, int sample_rate) {
-    impl_->stream_feed(pcm_chunk, sample_rate);
+bool Sensevoice::run_prepared(std::vector<std::unique_ptr<ASRPrepared>>& items, const std::string& language,
+                              std::vector<std::string>& text_results) {
+    return impl_->run_prepared(items, language, text_results);
 }
 
-bool Sensevoice::stream_result(std::string& partial_text) {
-    return impl_->stream_result(partial_text);
+bool Sensevoice::set_param(const std::string& key, const std::string& value) {
+    return impl_->set_param(key, value);
 }
 
-void Sensevoice::stream_reset() {
-    impl_->stream_reset();
-}
\ No newline at end of file
+std::unique_ptr<ASRStream> Sensevoice::create_stream() {
+    return std::make_unique<SensevoiceStream>(*impl_);
+}
+
+void register_sensevoice_models(ASRRegistry& registry) {
+    registry.add({"sensevoice", "sensevoice", AX_SENSEVOICE, "sensevoice", {"sensevoice.axmodel", "tokens.txt"},
+                  [] { return static_cast<ASRInterface*>(new Sensevoice()); }});
+}
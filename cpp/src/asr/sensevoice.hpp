@@ -22,12 +22,21 @@ public:
     bool init(AX_ASR_TYPE_E asr_type, const std::string& model_path);
     void uninit(void);
     bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result);
-    void stream_init();
-    void stream_feed(const std::vector<float>& pcm_chunk, int sample_rate);
-    bool stream_result(std::string& partial_text);
-    void stream_reset();
+    bool run_native(std::vector<float>& audio, const std::string& language, std::string& text_result);
+    bool run_reader(utils::AudioReader& reader, const std::string& language, std::string& text_result,
+                    const ASRSegmentCallback& on_segment);
+    bool run_detailed(const std::vector<float>& audio_data, int sample_rate, const std::string& language, ASRResult& result);
+    bool run_native_detailed(std::vector<float>& audio, const std::string& language, ASRResult& result);
+    std::unique_ptr<ASRPrepared> prepare(std::vector<float>& audio);
+    bool run_prepared(std::vector<std::unique_ptr<ASRPrepared>>& items, const std::string& language,
+                      std::vector<std::string>& text_results);
+    // Enough short utterances to fill several packed encoder windows
+    int max_batch_items()   { return 32; }
+    bool set_param(const std::string& key, const std::string& value);
+    std::unique_ptr<ASRStream> create_stream();
 
 private:    
+    friend class SensevoiceStream;
     class Impl;
     std::unique_ptr<Impl> impl_;    
 };
\ No newline at end of file
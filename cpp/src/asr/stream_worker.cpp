@@ -0,0 +1,173 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <chrono>
+
+#include "asr/stream_worker.hpp"
+#include "utils/logger.h"
+
+#define STREAM_DEFAULT_INTERVAL_MS      200
+#define STREAM_DEFAULT_MAX_BUFFER_MS    10000
+// Ring is sized for the highest input rate we expect from capture devices
+#define STREAM_MAX_SAMPLE_RATE          48000
+
+// Length of the common prefix of a and b, cut back to a UTF-8 character boundary
+static size_t utf8_common_prefix(const std::string& a, const std::string& b) {
+    size_t n = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i < n && a[i] == b[i]) i++;
+    while (i > 0 && i < b.size() && (static_cast<unsigned char>(b[i]) & 0xC0) == 0x80) i--;
+    return i;
+}
+
+static AX_ASR_STREAM_ASYNC_CONFIG_T with_defaults(const AX_ASR_STREAM_ASYNC_CONFIG_T& config) {
+    AX_ASR_STREAM_ASYNC_CONFIG_T c = config;
+    if (c.interval_ms <= 0)
+        c.interval_ms = STREAM_DEFAULT_INTERVAL_MS;
+    if (c.max_buffer_ms <= 0)
+        c.max_buffer_ms = STREAM_DEFAULT_MAX_BUFFER_MS;
+    return c;
+}
+
+StreamWorker::StreamWorker(ASRStream* stream, const AX_ASR_STREAM_ASYNC_CONFIG_T& config):
+    stream_(stream),
+    config_(with_defaults(config)),
+    ring_((size_t)config_.max_buffer_ms * STREAM_MAX_SAMPLE_RATE / 1000) {
+
+}
+
+StreamWorker::~StreamWorker() {
+    stop();
+}
+
+bool StreamWorker::start() {
+    if (thread_.joinable()) {
+        ALOGE("Stream worker already started");
+        return false;
+    }
+
+    stop_ = false;
+    hypothesis_.clear();
+    stable_.clear();
+    thread_ = std::thread(&StreamWorker::loop_, this);
+    return true;
+}
+
+void StreamWorker::stop() {
+    if (!thread_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+bool StreamWorker::check_rate_(int sample_rate) {
+    int expected = 0;
+    if (!sample_rate_.compare_exchange_strong(expected, sample_rate) && expected != sample_rate) {
+        ALOGE("sample_rate changed from %d to %d within one stream", expected, sample_rate);
+        return false;
+    }
+    return true;
+}
+
+int StreamWorker::push(const float* pcm, int num_samples, int sample_rate) {
+    if (!check_rate_(sample_rate))
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+
+    if (!ring_.push(pcm, num_samples)) {
+        ALOGW("Stream buffer full, drop %d samples", num_samples);
+        return AX_ASR_ERR_QUEUE_FULL;
+    }
+    return AX_ASR_SUCCESS;
+}
+
+int StreamWorker::push_s16(const int16_t* pcm, int num_samples, int sample_rate) {
+    if (!check_rate_(sample_rate))
+        return AX_ASR_ERR_INVALID_ARGUMENT;
+
+    if (!ring_.push(pcm, num_samples, [](int16_t s) { return s * (1.0f / 32768.0f); })) {
+        ALOGW("Stream buffer full, drop %d samples", num_samples);
+        return AX_ASR_ERR_QUEUE_FULL;
+    }
+    return AX_ASR_SUCCESS;
+}
+
+void StreamWorker::loop_() {
+    const auto interval = std::chrono::milliseconds(config_.interval_ms);
+    auto next_tick = std::chrono::steady_clock::now() + interval;
+
+    while (true) {
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_until(lock, next_tick, [this] { return stop_; });
+            stopping = stop_;
+        }
+
+        next_tick += interval;
+        auto now = std::chrono::steady_clock::now();
+        if (next_tick < now)
+            next_tick = now + interval;
+
+        // Coalesce whatever arrived since the last tick into one chunk
+        chunk_.clear();
+        ring_.pop(chunk_);
+        if (!chunk_.empty()) {
+            stream_->feed(chunk_, sample_rate_.load());
+            // Utterances closed by endpoint detection during this feed
+            while (stream_->pop_final(final_text_)) {
+                emit_(final_text_, std::string(), true);
+                hypothesis_.clear();
+                stable_.clear();
+            }
+            publish_(false);
+        }
+
+        if (stopping) {
+            publish_(true);
+            break;
+        }
+    }
+}
+
+void StreamWorker::publish_(bool is_final) {
+    std::string current;
+    if (!stream_->result(current))
+        current.clear();
+
+    if (is_final) {
+        stable_ = current;
+    } else {
+        if (current == hypothesis_)
+            return;
+        // A prefix that survived two consecutive hypotheses is considered stable
+        size_t n = utf8_common_prefix(hypothesis_, current);
+        if (current.compare(0, stable_.size(), stable_) != 0 || n > stable_.size())
+            stable_ = current.substr(0, n);
+    }
+    hypothesis_ = current;
+
+    emit_(stable_, current.substr(stable_.size()), is_final);
+}
+
+void StreamWorker::emit_(const std::string& stable, const std::string& unstable, bool is_final) {
+    if (!config_.callback)
+        return;
+
+    AX_ASR_STREAM_RESULT_T result;
+    result.stable_text = stable.c_str();
+    result.unstable_text = unstable.c_str();
+    result.is_final = is_final ? 1 : 0;
+    config_.callback(&result, config_.user_data);
+}
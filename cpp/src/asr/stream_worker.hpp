@@ -0,0 +1,67 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "api/ax_asr_api.h"
+#include "asr/asr_interface.hpp"
+#include "utils/spsc_ring.hpp"
+
+// Runs streaming inference of one ASRStream on a background thread.
+//
+// push() only copies audio into a lock-free ring, so capture threads never
+// wait for the NPU. The worker wakes up every interval_ms, feeds everything
+// queued since the last tick as a single chunk and reports the hypothesis
+// through the registered callback.
+class StreamWorker {
+public:
+    StreamWorker(ASRStream* stream, const AX_ASR_STREAM_ASYNC_CONFIG_T& config);
+    ~StreamWorker();
+
+    bool start();
+    // Process remaining audio, emit a final result and join the worker
+    void stop();
+
+    // Called from the capture thread
+    int push(const float* pcm, int num_samples, int sample_rate);
+    // 16 bit PCM, converted while it is copied into the ring
+    int push_s16(const int16_t* pcm, int num_samples, int sample_rate);
+
+private:
+    bool check_rate_(int sample_rate);
+    void loop_();
+    void publish_(bool is_final);
+    void emit_(const std::string& stable, const std::string& unstable, bool is_final);
+
+private:
+    ASRStream* stream_;
+    AX_ASR_STREAM_ASYNC_CONFIG_T config_;
+
+    utils::SpscRing<float> ring_;
+    std::atomic<int> sample_rate_{0};
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+
+    std::vector<float> chunk_;
+    std::string hypothesis_;
+    std::string stable_;
+    std::string final_text_;
+};
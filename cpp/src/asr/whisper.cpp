@@ -16,6 +16,7 @@
 #include <memory>
 
 #include "asr/whisper.hpp"
+#include "asr/asr_registry.hpp"
 #include "api/ax_asr_api.h"
 #include "ax_model_runner/ax_model_runner.hpp"
 #include "utils/nlohmann/json.hpp"
@@ -143,7 +144,13 @@ public:
     }
 
     bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) {
-        preprocess_(audio_data, sample_rate, config_.n_mels);
+        std::vector<float> audio;
+        utils::resample(audio_data.data(), audio_data.size(), sample_rate, config_.sample_rate, audio);
+        return run_native(audio, language, text_result);
+    }
+
+    bool run_native(std::vector<float>& audio, const std::string& language, std::string& text_result) {
+        preprocess_(audio, config_.n_mels);
         ALOGD("preprocess finish");
 
         feature_.sot_seq[1] = get_lang_token_(language);
@@ -199,6 +206,10 @@ public:
         return true;
     }
 
+    bool has_language(const std::string& lang) const {
+        return lang_token_map_.find(lang) != lang_token_map_.end();
+    }
+
 private:
     bool load_models_(const std::string& encoder_path, const std::string& decoder_path) {
         int ret = -1;
@@ -283,10 +294,9 @@ private:
         feature_.logits.resize(config_.n_vocab);
     }
 
-    void preprocess_(const std::vector<float>& audio_data, int sample_rate, int n_mels) {
-        std::vector<float> resampled_data = utils::resample(audio_data, sample_rate, config_.sample_rate);
-
-        auto mel = librosa::Feature::melspectrogram(resampled_data, WHISPER_SAMPLE_RATE, WHISPER_N_FFT, WHISPER_HOP_LENGTH, "hann", true, "reflect", 2.0f, n_mels, 0.0f, WHISPER_SAMPLE_RATE / 2.0f);
+    // audio: mono at config_.sample_rate
+    void preprocess_(std::vector<float>& audio, int n_mels) {
+        auto mel = librosa::Feature::melspectrogram(audio, WHISPER_SAMPLE_RATE, WHISPER_N_FFT, WHISPER_HOP_LENGTH, "hann", true, "reflect", 2.0f, n_mels, 0.0f, WHISPER_SAMPLE_RATE / 2.0f);
         int n_frames = mel[0].size();
 
         // clamping and normalization
@@ -420,4 +430,24 @@ void Whisper::uninit(void) {
 
 bool Whisper::run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) {
     return impl_->run(audio_data, sample_rate, language, text_result);
-}
\ No newline at end of file
+}
+
+bool Whisper::run_native(std::vector<float>& audio, const std::string& language, std::string& text_result) {
+    return impl_->run_native(audio, language, text_result);
+}
+
+bool Whisper::has_language(const std::string& language) {
+    return impl_->has_language(language);
+}
+
+void register_whisper_models(ASRRegistry& registry) {
+    const std::pair<AX_ASR_TYPE_E, std::string> sizes[] = {
+        {AX_WHISPER_TINY, "tiny"}, {AX_WHISPER_BASE, "base"}, {AX_WHISPER_SMALL, "small"}, {AX_WHISPER_TURBO, "turbo"},
+    };
+    for (auto& size : sizes) {
+        const std::string& s = size.second;
+        registry.add({"whisper_" + s, "whisper_" + s, size.first, "whisper/" + s,
+                      {s + "-encoder.axmodel", s + "-decoder.axmodel", s + "-tokens.txt", s + "_config.json"},
+                      [] { return static_cast<ASRInterface*>(new Whisper()); }});
+    }
+}
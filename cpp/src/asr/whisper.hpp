@@ -22,6 +22,10 @@ public:
     bool init(AX_ASR_TYPE_E asr_type, const std::string& model_path);
     void uninit(void);
     bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result);
+    bool run_native(std::vector<float>& audio, const std::string& language, std::string& text_result);
+
+    // Whether the model has a token for this language code
+    bool has_language(const std::string& language);
 
 private:    
     class Impl;
@@ -0,0 +1,604 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+
+#include "asr/zipformer.hpp"
+#include "asr/asr_registry.hpp"
+#include "asr/endpoint.hpp"
+#include "asr/lfr_frontend.hpp"
+#include "ax_model_runner/ax_model_runner.hpp"
+#include "utils/nlohmann/json.hpp"
+#include "utils/logger.h"
+
+using json = nlohmann::json;
+
+#define ZIPFORMER_DEFAULT_BEAM_SIZE     4
+#define ZIPFORMER_MAX_BEAM_SIZE         16
+
+// One path of the modified beam search
+struct TransducerHyp {
+    std::vector<int> ys;            // context_size blanks, then the emitted tokens
+    std::vector<int> frames;        // encoder frame of every emitted token
+    float log_prob = 0.0f;
+    std::vector<float> dec_out;     // decoder output for the last context_size ys, empty until computed
+};
+
+// pImpl
+class Zipformer::Impl {
+    friend class Zipformer;
+    friend class ZipformerStream;
+public:
+    bool init(AX_ASR_TYPE_E /*asr_type*/, const std::string& model_path) {
+        if (!load_config_(model_path + "/config.json"))
+            return false;
+
+        if (!load_models_(model_path + "/encoder.axmodel", model_path + "/decoder.axmodel",
+                          model_path + "/joiner.axmodel"))
+            return false;
+
+        // encoder: x [1, T, n_mels] -> encoder_out [1, T', C], states pass through
+        auto input_shape = encoder_.get_input_shape(0);
+        chunk_frames_ = input_shape[1];
+        n_mels_ = input_shape[2];
+        auto output_shape = encoder_.get_output_shape(0);
+        out_frames_ = output_shape[1];
+        enc_dim_ = output_shape[2];
+        if (chunk_shift_ <= 0 || chunk_shift_ > chunk_frames_)
+            chunk_shift_ = chunk_frames_;
+        frame_ms_ = 10.0f * chunk_shift_ / out_frames_;
+
+        int num_states = encoder_.get_input_num() - 1;
+        if (encoder_.get_output_num() != num_states + 1) {
+            ALOGE("Encoder has %d state inputs but %d state outputs", num_states, encoder_.get_output_num() - 1);
+            return false;
+        }
+        state_bytes_.resize(num_states);
+        for (int i = 0; i < num_states; i++) {
+            state_bytes_[i] = encoder_.get_input_size(i + 1);
+            if (encoder_.get_output_size(i + 1) != state_bytes_[i]) {
+                ALOGE("Encoder state %s: input %d bytes, output %d bytes", encoder_.get_input_name(i + 1),
+                      state_bytes_[i], encoder_.get_output_size(i + 1));
+                return false;
+            }
+        }
+
+        // decoder: y [1, context_size] int64 or int32 -> decoder_out [1, C]
+        context_int64_ = decoder_.get_input_size(0) == context_size_ * (int)sizeof(int64_t);
+        dec_dim_ = decoder_.get_output_size(0) / sizeof(float);
+
+        // joiner: encoder_out [1, C], decoder_out [1, C] -> logit [1, vocab_size]
+        vocab_size_ = joiner_.get_output_size(0) / sizeof(float);
+        if (joiner_.get_input_size(0) != enc_dim_ * (int)sizeof(float) ||
+            joiner_.get_input_size(1) != dec_dim_ * (int)sizeof(float)) {
+            ALOGE("Joiner inputs do not match encoder_out %d and decoder_out %d", enc_dim_, dec_dim_);
+            return false;
+        }
+        logits_.resize(vocab_size_);
+
+        if (!load_tokens_(model_path + "/tokens.txt")) {
+            ALOGE("Load tokens from %s/tokens.txt failed!", model_path.c_str());
+            return false;
+        }
+
+        frontend_config_ = icefall_frontend_config(n_mels_);
+
+        ALOGI("Zipformer: chunk %d/%d frames -> %d encoder frames (%.0fms), %d states, vocab %d",
+              chunk_shift_, chunk_frames_, out_frames_, frame_ms_, num_states, vocab_size_);
+        return true;
+    }
+
+    void uninit(void) {
+        encoder_.unload_model();
+        decoder_.unload_model();
+        joiner_.unload_model();
+    }
+
+    bool set_param(const std::string& key, const std::string& value) {
+        char* end = nullptr;
+        long v = strtol(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0') {
+            ALOGE("Invalid value %s for %s", value.c_str(), key.c_str());
+            return false;
+        }
+
+        if (key == "beam_size") {
+            if (v < 1 || v > ZIPFORMER_MAX_BEAM_SIZE) {
+                ALOGE("beam_size must be in [1, %d]", ZIPFORMER_MAX_BEAM_SIZE);
+                return false;
+            }
+            // 1 is greedy search
+            beam_size_ = (int)v;
+        } else {
+            ALOGE("Unknown param %s", key.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool load_config_(const std::string& config_path) {
+        std::ifstream fs(config_path);
+        if (!fs.is_open()) {
+            ALOGE("Cannot open config file: %s", config_path.c_str());
+            return false;
+        }
+        json config = json::parse(fs, nullptr, false);
+        fs.close();
+        if (config.is_discarded()) {
+            ALOGE("Parse %s failed", config_path.c_str());
+            return false;
+        }
+
+        // Frames the encoder moves forward per chunk, the rest of its input is right context
+        chunk_shift_ = config.value("decode_chunk_len", 0);
+        context_size_ = config.value("context_size", 2);
+        blank_id_ = config.value("blank_id", 0);
+        return context_size_ > 0;
+    }
+
+    bool load_models_(const std::string& encoder_path, const std::string& decoder_path, const std::string& joiner_path) {
+        int ret = encoder_.load_model(encoder_path.c_str());
+        if (0 != ret) {
+            ALOGE("Load encoder failed! ret=0x%x", ret);
+            return false;
+        }
+
+        ret = decoder_.load_model(decoder_path.c_str());
+        if (0 != ret) {
+            ALOGE("Load decoder failed! ret=0x%x", ret);
+            return false;
+        }
+
+        ret = joiner_.load_model(joiner_path.c_str());
+        if (0 != ret) {
+            ALOGE("Load joiner failed! ret=0x%x", ret);
+            return false;
+        }
+        return true;
+    }
+
+    // sherpa format, "<token> <id>" per line
+    bool load_tokens_(const std::string& token_path) {
+        std::ifstream fs(token_path);
+        if (!fs.is_open()) {
+            ALOGE("Cannot open token file: %s", token_path.c_str());
+            return false;
+        }
+
+        std::string line;
+        tokens_.reserve(vocab_size_);
+        while (std::getline(fs, line)) {
+            size_t i = line.rfind(' ');
+            tokens_.push_back(line.substr(0, i));
+        }
+        return true;
+    }
+
+    // Encode one chunk of chunk_frames_ fbank frames, states are read and
+    // updated in place. Call with model_mutex_ held.
+    bool run_encoder_(const float* chunk, std::vector<std::vector<uint8_t>>& states, std::vector<float>& enc_out) {
+        encoder_.set_input(0, (void*)chunk);
+        for (size_t i = 0; i < states.size(); i++) {
+            encoder_.set_input(i + 1, states[i].data());
+        }
+
+        int ret = encoder_.run();
+        if (0 != ret) {
+            ALOGE("Run encoder failed! ret=0x%x", ret);
+            return false;
+        }
+
+        enc_out.resize((size_t)out_frames_ * enc_dim_);
+        encoder_.get_output(0, enc_out.data());
+        for (size_t i = 0; i < states.size(); i++) {
+            encoder_.get_output(i + 1, states[i].data());
+        }
+        return true;
+    }
+
+    // Call with model_mutex_ held
+    bool run_decoder_(const int* context, std::vector<float>& dec_out) {
+        int ret;
+        if (context_int64_) {
+            context_int64_buf_.assign(context, context + context_size_);
+            decoder_.set_input(0, context_int64_buf_.data());
+            ret = decoder_.run();
+        } else {
+            decoder_.set_input(0, (void*)context);
+            ret = decoder_.run();
+        }
+        if (0 != ret) {
+            ALOGE("Run decoder failed! ret=0x%x", ret);
+            return false;
+        }
+
+        dec_out.resize(dec_dim_);
+        decoder_.get_output(0, dec_out.data());
+        return true;
+    }
+
+    // Log probabilities over the vocabulary go to logits_. Call with model_mutex_ held.
+    bool run_joiner_(const float* enc_frame, const float* dec_out) {
+        joiner_.set_input(0, (void*)enc_frame);
+        joiner_.set_input(1, (void*)dec_out);
+        int ret = joiner_.run();
+        if (0 != ret) {
+            ALOGE("Run joiner failed! ret=0x%x", ret);
+            return false;
+        }
+        joiner_.get_output(0, logits_.data());
+
+        float max_value = *std::max_element(logits_.begin(), logits_.end());
+        float sum = 0.0f;
+        for (auto x : logits_) {
+            sum += expf(x - max_value);
+        }
+        float log_sum = max_value + logf(sum);
+        for (auto& x : logits_) {
+            x -= log_sum;
+        }
+        return true;
+    }
+
+    // Modified beam search, at most one token per encoder frame. Hyps that
+    // end up with the same tokens are merged. frame_offset is the stream
+    // frame of enc_out[0]. Call with model_mutex_ held.
+    bool search_(const std::vector<float>& enc_out, int frame_offset, std::vector<TransducerHyp>& hyps) {
+        const int beam_size = beam_size_;
+        std::vector<TransducerHyp> next;
+        for (int t = 0; t < out_frames_; t++) {
+            const float* enc_frame = enc_out.data() + (size_t)t * enc_dim_;
+
+            scores_.resize(hyps.size() * vocab_size_);
+            for (size_t h = 0; h < hyps.size(); h++) {
+                auto& hyp = hyps[h];
+                if (hyp.dec_out.empty() && !run_decoder_(hyp.ys.data() + hyp.ys.size() - context_size_, hyp.dec_out))
+                    return false;
+                if (!run_joiner_(enc_frame, hyp.dec_out.data()))
+                    return false;
+
+                float* score = scores_.data() + h * vocab_size_;
+                for (int v = 0; v < vocab_size_; v++) {
+                    score[v] = hyp.log_prob + logits_[v];
+                }
+            }
+
+            int k = std::min<int>(beam_size, scores_.size());
+            top_.resize(scores_.size());
+            std::iota(top_.begin(), top_.end(), 0);
+            std::partial_sort(top_.begin(), top_.begin() + k, top_.end(),
+                              [this](int a, int b) { return scores_[a] > scores_[b]; });
+
+            next.clear();
+            for (int i = 0; i < k; i++) {
+                int h = top_[i] / vocab_size_;
+                int v = top_[i] % vocab_size_;
+
+                TransducerHyp hyp = hyps[h];
+                hyp.log_prob = scores_[top_[i]];
+                if (v != blank_id_) {
+                    hyp.ys.push_back(v);
+                    hyp.frames.push_back(frame_offset + t);
+                    hyp.dec_out.clear();
+                }
+
+                auto same = std::find_if(next.begin(), next.end(),
+                                         [&hyp](const TransducerHyp& other) { return other.ys == hyp.ys; });
+                if (same == next.end()) {
+                    next.push_back(std::move(hyp));
+                } else {
+                    // log(exp(a) + exp(b))
+                    float a = std::max(same->log_prob, hyp.log_prob);
+                    float b = std::min(same->log_prob, hyp.log_prob);
+                    same->log_prob = a + log1pf(expf(b - a));
+                }
+            }
+            hyps.swap(next);
+        }
+        return true;
+    }
+
+    void init_hyps_(std::vector<TransducerHyp>& hyps) const {
+        hyps.assign(1, TransducerHyp());
+        hyps[0].ys.assign(context_size_, blank_id_);
+    }
+
+    const TransducerHyp& best_hyp_(const std::vector<TransducerHyp>& hyps) const {
+        return *std::max_element(hyps.begin(), hyps.end(), [](const TransducerHyp& a, const TransducerHyp& b) {
+            return a.log_prob < b.log_prob;
+        });
+    }
+
+    // U+2581 marks the start of a word
+    void hyp_to_text_(const TransducerHyp& hyp, std::string& text_result) const {
+        static const char kWordBoundary[] = "\xe2\x96\x81";
+        const size_t boundary_len = sizeof(kWordBoundary) - 1;
+
+        text_result.clear();
+        for (size_t i = context_size_; i < hyp.ys.size(); i++) {
+            int id = hyp.ys[i];
+            if (id < 0 || id >= (int)tokens_.size())
+                continue;
+            const std::string& token = tokens_[id];
+            if (token.compare(0, boundary_len, kWordBoundary) == 0) {
+                if (!text_result.empty())
+                    text_result.push_back(' ');
+                text_result.append(token, boundary_len, std::string::npos);
+            } else {
+                text_result.append(token);
+            }
+        }
+    }
+
+private:
+    AxModelRunner encoder_;
+    AxModelRunner decoder_;
+    AxModelRunner joiner_;
+    // Guards the three runners and the search buffers, shared by all streams
+    std::mutex model_mutex_;
+
+    LfrFrontendConfig frontend_config_;
+    int n_mels_;
+    int chunk_frames_;              // fbank frames per encoder run
+    int chunk_shift_;               // fbank frames consumed per encoder run
+    int out_frames_;                // encoder frames per run
+    float frame_ms_;                // duration of one encoder frame
+    int enc_dim_, dec_dim_;
+    std::vector<int> state_bytes_;
+    int context_size_;
+    bool context_int64_;
+    int blank_id_;
+    int vocab_size_;
+    int beam_size_ = ZIPFORMER_DEFAULT_BEAM_SIZE;
+    std::vector<std::string> tokens_;
+
+    std::vector<int64_t> context_int64_buf_;
+    std::vector<float> logits_;
+    std::vector<float> scores_;
+    std::vector<int> top_;
+};
+
+// Streaming session: its own fbank, unconsumed frames, encoder states and
+// search paths, the models are borrowed from Zipformer::Impl
+class ZipformerStream : public ASRStream {
+public:
+    explicit ZipformerStream(Zipformer::Impl& model):
+        model_(model),
+        frontend_(model.frontend_config_) {
+        reset_state_();
+    }
+
+    using ASRStream::feed;
+    void feed(const float* pcm, size_t num_samples, int sample_rate) {
+        if (num_samples == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        frontend_.accept_waveform(pcm, num_samples, sample_rate);
+        endpoint_.accept_waveform(pcm, num_samples, sample_rate);
+        frontend_.pop_frames(features_);
+        decode_chunks_();
+    }
+
+    void feed_s16(const int16_t* pcm, size_t num_samples, int sample_rate) {
+        if (num_samples == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        frontend_.accept_waveform_s16(pcm, num_samples, sample_rate);
+        endpoint_.accept_waveform(pcm, num_samples, sample_rate);
+        frontend_.pop_frames(features_);
+        decode_chunks_();
+    }
+
+    // feed() for a buffer the caller is done with, the frontend scales it
+    // in place once endpoint detection has read it
+    void feed_inplace(float* pcm, int num_samples, int sample_rate) {
+        if (num_samples <= 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        endpoint_.accept_waveform(pcm, num_samples, sample_rate);
+        frontend_.accept_waveform_inplace(pcm, num_samples, sample_rate);
+        frontend_.pop_frames(features_);
+        decode_chunks_();
+    }
+
+    // End of audio: pad with silence so the right context of the last
+    // chunk is available, and decode what is left
+    void input_finished(void) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<float> tail_padding((size_t)model_.chunk_frames_ * 160, 0.0f);
+        frontend_.accept_waveform(tail_padding.data(), tail_padding.size(), 16000);
+        frontend_.input_finished();
+        frontend_.pop_frames(features_);
+        decode_chunks_();
+    }
+
+    // Whether an encoder, decoder or joiner run failed since reset()
+    bool failed(void) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return failed_;
+    }
+
+    bool result(std::string& partial_text) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (partial_text_.empty()) return false;
+        partial_text = partial_text_;
+        return true;
+    }
+
+    void set_endpoint(const AX_ASR_ENDPOINT_CONFIG_T& config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        endpoint_.set_config(config);
+        endpoint_.reset();
+    }
+
+    using ASRStream::pop_final;
+    bool pop_final(ASRFinalResult& final_result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (finals_.empty()) return false;
+        final_result = std::move(finals_.front());
+        finals_.pop_front();
+        return true;
+    }
+
+    void reset(void) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frontend_.reset();
+        reset_state_();
+        finals_.clear();
+        endpoint_.reset();
+    }
+
+private:
+    void reset_state_(void) {
+        features_.clear();
+        states_.resize(model_.state_bytes_.size());
+        for (size_t i = 0; i < states_.size(); i++) {
+            states_[i].assign(model_.state_bytes_[i], 0);
+        }
+        model_.init_hyps_(hyps_);
+        decoded_frames_ = 0;
+        utterance_start_ = 0;
+        partial_text_.clear();
+        failed_ = false;
+    }
+
+    // Run the encoder over every complete chunk, consecutive chunks overlap
+    // by chunk_frames_ - chunk_shift_ frames of right context
+    void decode_chunks_(void) {
+        const int n_mels = model_.n_mels_;
+        int num_frames = features_.size() / n_mels;
+        int consumed = 0;
+        while (num_frames - consumed >= model_.chunk_frames_) {
+            {
+                std::lock_guard<std::mutex> lock(model_.model_mutex_);
+                if (!model_.run_encoder_(features_.data() + (size_t)consumed * n_mels, states_, enc_out_) ||
+                    !model_.search_(enc_out_, decoded_frames_, hyps_)) {
+                    failed_ = true;
+                    break;
+                }
+            }
+            consumed += model_.chunk_shift_;
+            decoded_frames_ += model_.out_frames_;
+
+            model_.hyp_to_text_(model_.best_hyp_(hyps_), partial_text_);
+            check_endpoint_();
+        }
+        features_.erase(features_.begin(), features_.begin() + (size_t)consumed * n_mels);
+    }
+
+    void check_endpoint_(void) {
+        if (!endpoint_.enabled())
+            return;
+
+        const auto& best = model_.best_hyp_(hyps_);
+        const float frame_ms = model_.frame_ms_;
+        int last = best.frames.empty() ? utterance_start_ - 1 : best.frames.back();
+        int utterance_ms = (int)((decoded_frames_ - utterance_start_) * frame_ms);
+        int speech_ms = best.frames.empty() ? 0 : (int)((best.frames.back() - best.frames.front() + 1) * frame_ms);
+        int trailing_ms = (int)((decoded_frames_ - 1 - last) * frame_ms);
+
+        auto decision = endpoint_.detect(utterance_ms, speech_ms, trailing_ms);
+        if (decision == EndpointDetector::ENDPOINT_NONE)
+            return;
+
+        if (decision == EndpointDetector::ENDPOINT_FINALIZE) {
+            ALOGD("Endpoint: utterance %dms speech %dms trailing %dms", utterance_ms, speech_ms, trailing_ms);
+            if (finals_.size() >= MAX_PENDING_FINALS) {
+                ALOGW("Final results not consumed, drop the oldest one");
+                finals_.pop_front();
+            }
+            ASRFinalResult final_result;
+            final_result.text = partial_text_;
+            final_result.start_ms = (int)(utterance_start_ * frame_ms);
+            final_result.end_ms = (int)(decoded_frames_ * frame_ms);
+            finals_.push_back(std::move(final_result));
+        }
+
+        // The encoder states carry on, the audio itself is continuous
+        model_.init_hyps_(hyps_);
+        utterance_start_ = decoded_frames_;
+        partial_text_.clear();
+        endpoint_.reset();
+    }
+
+private:
+    static constexpr size_t MAX_PENDING_FINALS = 64;
+
+    Zipformer::Impl& model_;
+    LfrFrontend frontend_;
+    std::vector<float> features_;                   // fbank frames not consumed by the encoder yet
+    std::vector<std::vector<uint8_t>> states_;      // encoder caches, raw bytes of every state input
+    std::vector<float> enc_out_;
+    std::vector<TransducerHyp> hyps_;
+    int decoded_frames_ = 0;                        // encoder frames since reset()
+    int utterance_start_ = 0;                       // encoder frame where the current utterance began
+    std::string partial_text_;
+    bool failed_ = false;
+    EndpointDetector endpoint_;
+    std::deque<ASRFinalResult> finals_;
+    std::mutex mutex_;
+};
+
+Zipformer::Zipformer():
+    impl_(std::make_unique<Zipformer::Impl>()) {
+
+}
+
+Zipformer::~Zipformer() {
+    uninit();
+}
+
+bool Zipformer::init(AX_ASR_TYPE_E asr_type, const std::string& model_path) {
+    return impl_->init(asr_type, model_path);
+}
+
+void Zipformer::uninit(void) {
+    impl_->uninit();
+}
+
+// Offline recognition is the stream fed at once
+bool Zipformer::run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result) {
+    std::vector<float> audio;
+    utils::resample(audio_data.data(), audio_data.size(), sample_rate, this->sample_rate(), audio);
+    return run_native(audio, language, text_result);
+}
+
+bool Zipformer::run_native(std::vector<float>& audio, const std::string& /*language*/, std::string& text_result) {
+    ZipformerStream stream(*impl_);
+    stream.feed_inplace(audio.data(), audio.size(), sample_rate());
+    stream.input_finished();
+    if (stream.failed())
+        return false;
+    if (!stream.result(text_result))
+        text_result.clear();
+    return true;
+}
+
+bool Zipformer::set_param(const std::string& key, const std::string& value) {
+    return impl_->set_param(key, value);
+}
+
+std::unique_ptr<ASRStream> Zipformer::create_stream() {
+    return std::make_unique<ZipformerStream>(*impl_);
+}
+
+void register_zipformer_models(ASRRegistry& registry) {
+    registry.add({"zipformer", "zipformer", AX_ZIPFORMER, "zipformer",
+                  {"encoder.axmodel", "decoder.axmodel", "joiner.axmodel", "tokens.txt", "config.json"},
+                  [] { return static_cast<ASRInterface*>(new Zipformer()); }});
+}
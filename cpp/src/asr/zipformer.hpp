@@ -0,0 +1,41 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <memory>
+
+#include "asr/asr_interface.hpp"
+
+// Streaming transducer (Zipformer encoder, stateless decoder, joiner).
+//
+// model_path holds encoder.axmodel, decoder.axmodel, joiner.axmodel,
+// tokens.txt and config.json. The encoder takes one chunk of fbank frames
+// as input 0 and its cached attention/conv states as inputs 1..N, and
+// returns the encoder frames as output 0 and the next states as outputs
+// 1..N in the same order. The states live in each stream, so every chunk
+// costs the same no matter how long the stream has been running.
+class Zipformer : public ASRInterface {
+public:
+    Zipformer();
+    ~Zipformer();
+
+    int sample_rate()   { return 16000; }
+    bool init(AX_ASR_TYPE_E asr_type, const std::string& model_path);
+    void uninit(void);
+    bool run(const std::vector<float>& audio_data, int sample_rate, const std::string& language, std::string& text_result);
+    bool run_native(std::vector<float>& audio, const std::string& language, std::string& text_result);
+    bool set_param(const std::string& key, const std::string& value);
+    std::unique_ptr<ASRStream> create_stream();
+
+private:
+    friend class ZipformerStream;
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
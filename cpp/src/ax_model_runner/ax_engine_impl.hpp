@@ -206,6 +206,11 @@ public:
         return m_io.pInputs[index].pVirAddr;
     }
 
+    // CMM is mapped into the process, run() flushes cached inputs
+    inline void* get_input_host_ptr(int index) {
+        return m_io.pInputs[index].pVirAddr;
+    }
+
     void* get_output_ptr(int index) {
         if (m_strategy == AX_IO_BUFFER_STRATEGY_CACHED)
             _cache_io_flush(m_io.pOutputs[index]);
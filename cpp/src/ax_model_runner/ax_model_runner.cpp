@@ -72,6 +72,10 @@ void* AxModelRunner::get_input_ptr(int index) {
     return impl_->get_input_ptr(index);
 }
 
+void* AxModelRunner::get_input_host_ptr(int index) {
+    return impl_->get_input_host_ptr(index);
+}
+
 void* AxModelRunner::get_output_ptr(int index) {
     return impl_->get_output_ptr(index);
 }
@@ -42,6 +42,9 @@ public:
     int get_output_num(void);
 
     void* get_input_ptr(int index);
+    // Input buffer the CPU can write into directly before run(), nullptr if
+    // inputs live in device memory and must go through set_input()
+    void* get_input_host_ptr(int index);
     void* get_output_ptr(int index);
 
     uint64_t get_input_phy_addr(int index);
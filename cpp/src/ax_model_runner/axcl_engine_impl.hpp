@@ -276,6 +276,11 @@ public:
         return inputs_[index];
     }
 
+    // Inputs are device memory on the PCIe card
+    inline void* get_input_host_ptr(int /*index*/) {
+        return nullptr;
+    }
+
     void* get_output_ptr(int index) {
         if (m_strategy == AX_IO_BUFFER_STRATEGY_CACHED)
             axclrtMemFlush(outputs_[index], outputs_size_[index]);
@@ -85,6 +85,11 @@ public:
      */
     bool load (std::string filePath);
     
+    /** Loads an audio file from data in memory
+     * @Returns true if the file was successfully loaded
+     */
+    bool loadFromMemory (std::vector<uint8_t>& fileData);
+    
     /** Saves an audio file to a given file path.
      * @Returns true if the file was successfully saved
      */
@@ -480,6 +485,13 @@ bool AudioFile<T>::load (std::string filePath)
 		return false;
 	}
     
+    return loadFromMemory (fileData);
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::loadFromMemory (std::vector<uint8_t>& fileData)
+{
     // get audio file format
     audioFileFormat = determineAudioFileFormat (fileData);
     
@@ -10,6 +10,7 @@
 #include "utils/AudioLoader.hpp"
 
 #include "utils/AudioFile.h"
+#include "utils/AudioReader.hpp"
 #include "utils/resample.h"
 #include "utils/logger.h"
 #define MINIMP3_IMPLEMENTATION
@@ -31,44 +32,52 @@ static std::string getFileExt(const std::string& file_path) {
 
 namespace utils {
 
+// Everything the reader has, converted and resampled
+static bool read_all(AudioReader& reader, std::vector<float>& samples, int& sample_rate) {
+    if (!reader.read_all(samples)) {
+        return false;
+    }
+    sample_rate = reader.get_sample_rate();
+    return true;
+}
+
 class AudioLoader::WavImpl {
 public:
     WavImpl() = default;
     ~WavImpl() = default;
 
+    // PCM 16 bit and float are converted and mixed down in one pass from
+    // the mapped file, AudioFile is kept for what AudioReader rejects
     bool load(const std::string& audio_path, int target_sr) {
+        AudioReader reader;
+        if (reader.open(audio_path, target_sr)) {
+            return read_all(reader, samples, sample_rate_);
+        }
+
+        ALOGD("Load %s with AudioFile", audio_path.c_str());
         if (!audio_file_.load(audio_path)) {
             return false;
         }
+        return convert_(target_sr);
+    }
 
-        // mono
-        if (audio_file_.isStereo()) {
-            for (int i = 0; i < audio_file_.getNumSamplesPerChannel(); i++) {
-                audio_file_.samples[0][i] = (audio_file_.samples[0][i] + audio_file_.samples[1][i]) / 2;
-            }
+    bool load_from_memory(const void* data, size_t size, int target_sr) {
+        AudioReader reader;
+        if (reader.open_memory(data, size, "wav", target_sr)) {
+            return read_all(reader, samples, sample_rate_);
         }
 
-        ALOGD("Audio info: format=wav, sample_rate=%d, num_samples=%d, num_channels=%d", audio_file_.getSampleRate(), audio_file_.getNumSamplesPerChannel(), audio_file_.getNumChannels());
-
-        // resample
-        if (target_sr > 0) {
-            samples = utils::resample(audio_file_.samples[0], audio_file_.getSampleRate(), target_sr);
-            sample_rate_ = target_sr;
-        } else {
-            sample_rate_ = audio_file_.getSampleRate();
+        std::vector<uint8_t> file_data(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+        if (!audio_file_.loadFromMemory(file_data)) {
+            return false;
         }
-
-        return true;
+        return convert_(target_sr);
     }
 
     inline int get_channels() const {
         return 1;
     }
 
-    inline int get_num_samples() const {
-        return (int)samples.size();
-    }
-
     inline int get_sample_rate() const {
         return sample_rate_;
     }
@@ -81,59 +90,64 @@ public:
     std::vector<float> samples;
 
 private:
-    AudioFile<float> audio_file_;    
-    int sample_rate_;
-};
-
-
-class AudioLoader::Mp3Impl {
-public:
-    Mp3Impl() = default;
-    ~Mp3Impl() = default;
-
-    bool load(const std::string& audio_path, int target_sr) {
-        mp3dec_init(&mp3d_);
-
-        mp3dec_file_info_t info;
-        if (mp3dec_load(&mp3d_, audio_path.c_str(), &info, NULL, NULL))
-        {
-            ALOGE("Load mp3 from %s failed!", audio_path.c_str());
-            return false;
-        }
-
-        ALOGD("Audio info: format=mp3, sample_rate=%d, num_samples=%d, num_channels=%d", 
-            info.hz, info.samples, info.channels);
-
+    bool convert_(int target_sr) {
         // mono
-        if (info.channels == 1) {
-            samples = std::vector<float>(info.buffer, info.buffer + info.samples);
-        } else {
-            samples.resize(info.samples / info.channels);
-            for (int i = 0; i < samples.size(); i++) {
-                samples[i] = (info.buffer[i * 2] + info.buffer[i * 2 + 1]) / 2.0f;
+        if (audio_file_.isStereo()) {
+            for (int i = 0; i < audio_file_.getNumSamplesPerChannel(); i++) {
+                audio_file_.samples[0][i] = (audio_file_.samples[0][i] + audio_file_.samples[1][i]) / 2;
             }
         }
 
+        ALOGD("Audio info: format=wav, sample_rate=%d, num_samples=%d, num_channels=%d", audio_file_.getSampleRate(), audio_file_.getNumSamplesPerChannel(), audio_file_.getNumChannels());
+
         // resample
         if (target_sr > 0) {
-            samples = utils::resample(samples, info.hz, target_sr);
+            samples = utils::resample(audio_file_.samples[0], audio_file_.getSampleRate(), target_sr);
             sample_rate_ = target_sr;
         } else {
-            sample_rate_ = info.hz;
+            samples = std::move(audio_file_.samples[0]);
+            sample_rate_ = audio_file_.getSampleRate();
         }
 
-        // free
-        free((void*)info.buffer);
-
         return true;
     }
 
-    inline int get_channels() const {
-        return 1;
+private:
+    AudioFile<float> audio_file_;    
+    int sample_rate_;
+};
+
+
+// mp3, flac and ogg/opus
+class AudioLoader::CodecImpl {
+public:
+    CodecImpl() = default;
+    ~CodecImpl() = default;
+
+    // Decoded, mixed down and resampled block by block, so only the
+    // output is ever held rather than the whole interleaved file plus a
+    // mono and a resampled copy
+    bool load(const std::string& audio_path, AUDIO_FORMAT format, int target_sr) {
+        AudioReader reader;
+        if (!reader.open(audio_path, target_sr)) {
+            return false;
+        }
+        format_ = format;
+        return read_all(reader, samples, sample_rate_);
     }
 
-    inline int get_num_samples() const {
-        return (int)samples.size();
+    bool load_from_memory(const void* data, size_t size, const std::string& format, int target_sr) {
+        AudioReader reader;
+        if (!reader.open_memory(data, size, format, target_sr)) {
+            return false;
+        }
+        format_ = format == "mp3" ? AudioLoader::AUDIO_FORMAT_MP3 :
+                  format == "flac" ? AudioLoader::AUDIO_FORMAT_FLAC : AudioLoader::AUDIO_FORMAT_OPUS;
+        return read_all(reader, samples, sample_rate_);
+    }
+
+    inline int get_channels() const {
+        return 1;
     }
 
     inline int get_sample_rate() const {
@@ -141,7 +155,7 @@ public:
     }
 
     inline AUDIO_FORMAT get_audio_format() const {
-        return AudioLoader::AUDIO_FORMAT_MP3;
+        return format_;
     }
 
 public:
@@ -149,19 +163,19 @@ public:
 
 private:
     int sample_rate_;
-    mp3dec_t mp3d_;
+    AUDIO_FORMAT format_ = AudioLoader::AUDIO_FORMAT_MP3;
 };
 
 
 AudioLoader::AudioLoader():
     wav_impl_(std::make_unique<AudioLoader::WavImpl>()),
-    mp3_impl_(std::make_unique<AudioLoader::Mp3Impl>()) {
+    codec_impl_(std::make_unique<AudioLoader::CodecImpl>()) {
 
 }
 
 AudioLoader::~AudioLoader() {
     wav_impl_.reset();
-    mp3_impl_.reset();
+    codec_impl_.reset();
 }
 
 bool AudioLoader::load(const std::string& audio_path, int target_sr) {
@@ -180,16 +194,17 @@ bool AudioLoader::load(const std::string& audio_path, int target_sr) {
         }
 
         audio_format_ = wav_impl_->get_audio_format();
-        samples = wav_impl_->samples;
-    } else if (ext.compare("mp3") == 0) {
-        ret = mp3_impl_->load(audio_path, target_sr);
+        samples = std::move(wav_impl_->samples);
+    } else if (ext == "mp3" || ext == "flac" || ext == "opus" || ext == "ogg") {
+        AUDIO_FORMAT format = ext == "mp3" ? AUDIO_FORMAT_MP3 : ext == "flac" ? AUDIO_FORMAT_FLAC : AUDIO_FORMAT_OPUS;
+        ret = codec_impl_->load(audio_path, format, target_sr);
         if (!ret) {
-            ALOGE("Load mp3 %s failed!", audio_path.c_str());
+            ALOGE("Load %s %s failed!", ext.c_str(), audio_path.c_str());
             return false;
         }
 
-        audio_format_ = mp3_impl_->get_audio_format();
-        samples = mp3_impl_->samples;
+        audio_format_ = codec_impl_->get_audio_format();
+        samples = std::move(codec_impl_->samples);
     } else {
         ALOGE("Unknown format of %s", audio_path.c_str());
         return false;
@@ -198,27 +213,55 @@ bool AudioLoader::load(const std::string& audio_path, int target_sr) {
     return true;
 }
 
+bool AudioLoader::load_from_memory(const void* data, size_t size, const std::string& format, int target_sr) {
+    if (!data || size == 0) {
+        ALOGE("Empty audio buffer");
+        return false;
+    }
+
+    std::string fmt = format.empty() ? guess_audio_format(data, size) : format;
+    if (fmt == "wav") {
+        if (!wav_impl_->load_from_memory(data, size, target_sr)) {
+            ALOGE("Load wav from memory failed!");
+            return false;
+        }
+
+        audio_format_ = wav_impl_->get_audio_format();
+        samples = std::move(wav_impl_->samples);
+    } else if (fmt == "mp3" || fmt == "flac" || fmt == "opus" || fmt == "ogg") {
+        if (!codec_impl_->load_from_memory(data, size, fmt, target_sr)) {
+            ALOGE("Load %s from memory failed!", fmt.c_str());
+            return false;
+        }
+
+        audio_format_ = codec_impl_->get_audio_format();
+        samples = std::move(codec_impl_->samples);
+    } else {
+        ALOGE("Unknown format %s of audio buffer", fmt.c_str());
+        return false;
+    }
+
+    return true;
+}
+
 int AudioLoader::get_channels() {
     if (audio_format_ == AUDIO_FORMAT_WAV) {
         return wav_impl_->get_channels();
     } else {
-        return mp3_impl_->get_channels();
+        return codec_impl_->get_channels();
     }
 }
 
+// The impls hand their samples over to the loader
 int AudioLoader::get_num_samples() {
-    if (audio_format_ == AUDIO_FORMAT_WAV) {
-        return wav_impl_->get_num_samples();
-    } else {
-        return mp3_impl_->get_num_samples();
-    }
+    return (int)samples.size();
 }
 
 int AudioLoader::get_sample_rate() {
     if (audio_format_ == AUDIO_FORMAT_WAV) {
         return wav_impl_->get_sample_rate();
     } else {
-        return mp3_impl_->get_sample_rate();
+        return codec_impl_->get_sample_rate();
     }
 }
 
@@ -23,11 +23,15 @@ public:
 
     enum AUDIO_FORMAT {
         AUDIO_FORMAT_WAV = 0,
-        AUDIO_FORMAT_MP3
+        AUDIO_FORMAT_MP3,
+        AUDIO_FORMAT_FLAC,
+        AUDIO_FORMAT_OPUS
     };
 
-    // if target_sr <= 0, it doesn't resample
+    // wav, mp3, flac or ogg/opus, if target_sr <= 0, it doesn't resample
     bool load(const std::string& audio_path, int target_sr = 16000);
+    // Encoded file in memory, an empty format is guessed from the data
+    bool load_from_memory(const void* data, size_t size, const std::string& format, int target_sr = 16000);
 
     int get_channels();
     int get_num_samples();
@@ -44,9 +48,9 @@ private:
     AUDIO_FORMAT audio_format_;
 
     class WavImpl;
-    class Mp3Impl;
+    class CodecImpl;
     std::unique_ptr<WavImpl> wav_impl_;
-    std::unique_ptr<Mp3Impl> mp3_impl_;
+    std::unique_ptr<CodecImpl> codec_impl_;
 };
 
 } // namespace utils
\ No newline at end of file
@@ -0,0 +1,584 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/AudioReader.hpp"
+#include "utils/flac_decoder.hpp"
+#include "utils/opus_file_decoder.hpp"
+#include "utils/parallel_mp3.hpp"
+#include "utils/pcm_convert.hpp"
+#include "utils/resample.h"
+#include "utils/logger.h"
+// minimp3 itself is compiled in AudioLoader.cpp
+#define MINIMP3_FLOAT_OUTPUT
+#include "minimp3.h"
+#include "minimp3_ext.h"
+
+// Input frames decoded per read()
+#define READER_BLOCK_FRAMES     16384
+// Shorter mp3s are decoded serially, a few seconds of audio is not worth
+// the index scan and the threads
+#define PARALLEL_MP3_MIN_BYTES  (1 << 20)
+#define PARALLEL_MP3_MAX_THREADS 4
+
+namespace utils {
+
+std::string guess_audio_format(const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    if (size >= 12 && memcmp(p, "RIFF", 4) == 0 && memcmp(p + 8, "WAVE", 4) == 0)
+        return "wav";
+    if (size >= 4 && memcmp(p, "fLaC", 4) == 0)
+        return "flac";
+    // First page of an Ogg stream starts with the codec's header packet
+    if (size >= 36 && memcmp(p, "OggS", 4) == 0 && memcmp(p + 28, "OpusHead", 8) == 0)
+        return "opus";
+    // ID3 tag or a frame sync; flac may carry an ID3 tag too
+    if (size >= 10 && memcmp(p, "ID3", 3) == 0) {
+        size_t tag_size = 10 + (((p[6] & 0x7F) << 21) | ((p[7] & 0x7F) << 14) | ((p[8] & 0x7F) << 7) | (p[9] & 0x7F));
+        if (tag_size + 4 <= size && memcmp(p + tag_size, "fLaC", 4) == 0)
+            return "flac";
+        return "mp3";
+    }
+    if (size >= 2 && p[0] == 0xFF && (p[1] & 0xE0) == 0xE0)
+        return "mp3";
+    return "";
+}
+
+class AudioReader::Impl {
+public:
+    ~Impl() {
+        close();
+    }
+
+    bool open(const std::string& audio_path, int target_sr) {
+        close();
+        path_ = audio_path;
+        mem_data_ = nullptr;
+        mem_size_ = 0;
+        target_sr_ = target_sr;
+
+        size_t dot = audio_path.rfind('.');
+        std::string ext = dot == std::string::npos ? "" : audio_path.substr(dot + 1);
+        bool ok = false;
+        if (ext == "wav") {
+            // Samples are converted straight from the mapped file
+            if (!map_file_(0))
+                ALOGE("Cannot open %s", path_.c_str());
+            ok = map_ && open_wav_((const uint8_t*)map_, map_size_);
+        } else if (ext == "mp3") {
+            // Byte seeking, sample seeking would build a frame index of the whole file
+            if (decode_threads_used_() > 1 && map_file_(PARALLEL_MP3_MIN_BYTES) &&
+                !open_parallel_mp3_((const uint8_t*)map_, map_size_)) {
+                munmap(map_, map_size_);
+                map_ = nullptr;
+                map_size_ = 0;
+            }
+            ok = par_mp3_ || open_mp3_(mp3dec_ex_open(&mp3_, path_.c_str(), MP3D_SEEK_TO_BYTE));
+        } else if (ext == "flac" || ext == "opus" || ext == "ogg") {
+            // Decoded frame by frame from the mapped file
+            if (!map_file_(0))
+                ALOGE("Cannot open %s", path_.c_str());
+            ok = map_ && (ext == "flac" ? open_flac_((const uint8_t*)map_, map_size_)
+                                        : open_opus_((const uint8_t*)map_, map_size_));
+        } else {
+            ALOGE("Unknown format of %s", audio_path.c_str());
+        }
+        return start_(ok);
+    }
+
+    bool open_memory(const void* data, size_t size, const std::string& format, int target_sr) {
+        close();
+        path_ = "<memory>";
+        mem_data_ = static_cast<const uint8_t*>(data);
+        mem_size_ = size;
+        target_sr_ = target_sr;
+
+        if (!data || size == 0) {
+            ALOGE("Empty audio buffer");
+            return false;
+        }
+
+        std::string fmt = format.empty() ? guess_audio_format(data, size) : format;
+        bool ok = false;
+        if (fmt == "wav") {
+            // Read in place, no copy of the buffer
+            ok = open_wav_(mem_data_, size);
+        } else if (fmt == "mp3") {
+            ok = open_parallel_mp3_(mem_data_, size) ||
+                 open_mp3_(mp3dec_ex_open_buf(&mp3_, mem_data_, size, MP3D_SEEK_TO_BYTE));
+        } else if (fmt == "flac") {
+            ok = open_flac_(mem_data_, size);
+        } else if (fmt == "opus" || fmt == "ogg") {
+            ok = open_opus_(mem_data_, size);
+        } else {
+            ALOGE("Unknown format %s of audio buffer", fmt.c_str());
+        }
+        return start_(ok);
+    }
+
+    void close(void) {
+        wav_data_ = nullptr;
+        if (mp3_open_) {
+            mp3dec_ex_close(&mp3_);
+            mp3_open_ = false;
+        }
+        if (par_mp3_) {
+            par_mp3_->close();
+            par_mp3_.reset();
+        }
+        flac_.reset();
+        opus_.reset();
+        if (map_) {
+            munmap(map_, map_size_);
+            map_ = nullptr;
+            map_size_ = 0;
+        }
+        resampler_.reset();
+    }
+
+    bool rewind(void) {
+        if (path_.empty())
+            return false;
+        if (mem_data_)
+            return open_memory(mem_data_, mem_size_, format_, target_sr_);
+        std::string path = path_;
+        return open(path, target_sr_);
+    }
+
+    bool read(std::vector<float>& out) {
+        out.clear();
+        if (finished_ || failed_ || (!wav_data_ && !mp3_open_ && !par_mp3_ && !flac_ && !opus_))
+            return false;
+
+        int n;
+        if (wav_data_)
+            n = read_wav_(mono_);
+        else if (flac_ || opus_)
+            n = read_packets_(mono_);
+        else
+            n = read_mp3_(mono_);
+        if (n < 0) {
+            failed_ = true;
+            return false;
+        }
+
+        // A short block is the end of the file, the resampler tail is
+        // flushed with it
+        bool last = n < READER_BLOCK_FRAMES;
+        if (resampler_)
+            resampler_->Resample(mono_.data(), n, last, &out);
+        else
+            out.assign(mono_.begin(), mono_.begin() + n);
+
+        if (last)
+            finished_ = true;
+        return n > 0 || !out.empty();
+    }
+
+    bool read_all(std::vector<float>& out) {
+        out.clear();
+        if (finished_ || failed_ || !wav_data_) {
+            std::vector<float> block;
+            while (read(block)) {
+                out.insert(out.end(), block.begin(), block.end());
+            }
+            return !failed_;
+        }
+
+        // A wav is converted in one pass, straight into out if it keeps its
+        // rate; resampling it whole gives the same samples as block by block
+        finished_ = true;
+        std::vector<float>& mono = resampler_ ? mono_ : out;
+        mono.resize(data_left_);
+        size_t n = convert_wav_(mono.data(), mono.size());
+        if (resampler_)
+            resampler_->Resample(mono.data(), n, true, &out);
+        return true;
+    }
+
+    inline bool failed() const {
+        return failed_;
+    }
+
+    inline int get_sample_rate() const {
+        return target_sr_ > 0 ? target_sr_ : file_sr_;
+    }
+
+    inline void set_decode_threads(int num_threads) {
+        decode_threads_ = num_threads;
+    }
+
+private:
+    // Common tail of open() and open_memory()
+    bool start_(bool opened) {
+        if (!opened) {
+            close();
+            return false;
+        }
+
+        format_ = wav_data_ ? "wav" : flac_ ? "flac" : opus_ ? "opus" : "mp3";
+        ALOGD("Audio reader: %s sample_rate=%d channels=%d", path_.c_str(), file_sr_, channels_);
+        if (target_sr_ > 0 && target_sr_ != file_sr_) {
+            // Same filter as utils::resample()
+            float lowpass_cutoff = 0.99f * 0.5f * std::min(file_sr_, target_sr_);
+            resampler_ = std::make_unique<LinearResample>(file_sr_, target_sr_, lowpass_cutoff, 6);
+        }
+        finished_ = false;
+        failed_ = false;
+        return true;
+    }
+
+    // RIFF/WAVE with PCM 8/16/24/32 bit or 32 bit float, converted the same
+    // way as AudioFile. Only the header is parsed, the samples are read from
+    // data when they are needed.
+    bool open_wav_(const uint8_t* data, size_t size) {
+        if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+            ALOGE("%s is not a valid wav file", path_.c_str());
+            return false;
+        }
+
+        bool has_format = false;
+        size_t pos = 12;
+        while (pos + 8 <= size) {
+            const uint8_t* chunk = data + pos;
+            uint32_t chunk_size = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | ((uint32_t)chunk[7] << 24);
+            pos += 8;
+            if (memcmp(chunk, "fmt ", 4) == 0) {
+                if (chunk_size < 16 || pos + 16 > size)
+                    break;
+                const uint8_t* fmt = data + pos;
+                audio_format_ = fmt[0] | (fmt[1] << 8);
+                channels_ = fmt[2] | (fmt[3] << 8);
+                file_sr_ = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | (fmt[7] << 24);
+                bit_depth_ = fmt[14] | (fmt[15] << 8);
+                has_format = true;
+            } else if (memcmp(chunk, "data", 4) == 0) {
+                if (!has_format)
+                    break;
+                if ((audio_format_ != 1 && audio_format_ != 3 && audio_format_ != 0xFFFE) ||
+                    channels_ < 1 || file_sr_ <= 0 ||
+                    (bit_depth_ != 8 && bit_depth_ != 16 && bit_depth_ != 24 && bit_depth_ != 32)) {
+                    ALOGE("Unsupported wav format %d, %d channels, %d bits", audio_format_, channels_, bit_depth_);
+                    return false;
+                }
+                // A truncated file keeps the samples it has
+                size_t frame_bytes = (size_t)channels_ * bit_depth_ / 8;
+                wav_data_ = data + pos;
+                data_left_ = std::min<uint64_t>(chunk_size, size - pos) / frame_bytes;
+                return true;
+            }
+            // Chunks are word aligned
+            pos += (uint64_t)chunk_size + (chunk_size & 1);
+        }
+
+        ALOGE("Cannot find audio data in %s", path_.c_str());
+        return false;
+    }
+
+    // Convert up to max_frames into mono, returns the number converted
+    size_t convert_wav_(float* mono, size_t max_frames) {
+        const int bytes_per_sample = bit_depth_ / 8;
+        const size_t frame_bytes = (size_t)bytes_per_sample * channels_;
+        size_t frames = std::min<uint64_t>(max_frames, data_left_);
+
+        if (bit_depth_ == 16) {
+            s16_to_mono(wav_data_, frames, channels_, mono);
+        } else if (bit_depth_ == 32 && audio_format_ == 3) {
+            f32_to_mono(wav_data_, frames, channels_, mono);
+        } else {
+            for (size_t i = 0; i < frames; i++) {
+                const uint8_t* p = wav_data_ + i * frame_bytes;
+                float left = wav_sample_(p);
+                // AudioLoader mixes stereo and keeps the first channel otherwise
+                mono[i] = channels_ == 2 ? (left + wav_sample_(p + bytes_per_sample)) / 2 : left;
+            }
+        }
+        wav_data_ += frames * frame_bytes;
+        data_left_ -= frames;
+        return frames;
+    }
+
+    int read_wav_(std::vector<float>& mono) {
+        mono.resize(READER_BLOCK_FRAMES);
+        return (int)convert_wav_(mono.data(), READER_BLOCK_FRAMES);
+    }
+
+    inline float wav_sample_(const uint8_t* p) const {
+        switch (bit_depth_) {
+        case 8:
+            return static_cast<float>(p[0] - 128) / 128.0f;
+        case 16:
+            return static_cast<float>((int16_t)(p[0] | (p[1] << 8))) / 32768.0f;
+        case 24: {
+            int32_t v = (p[2] << 16) | (p[1] << 8) | p[0];
+            if (v & 0x800000)
+                v |= ~0xFFFFFF;
+            return (float)v / 8388608.0f;
+        }
+        default: {
+            int32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+            if (audio_format_ == 3) {
+                float f;
+                memcpy(&f, &v, sizeof(f));
+                return f;
+            }
+            return (float)v / static_cast<float>(std::numeric_limits<std::int32_t>::max());
+        }
+        }
+    }
+
+    bool open_flac_(const uint8_t* data, size_t size) {
+        auto decoder = std::make_unique<FlacDecoder>();
+        if (!decoder->open(data, size)) {
+            ALOGE("Load flac from %s failed!", path_.c_str());
+            return false;
+        }
+        channels_ = decoder->get_channels();
+        file_sr_ = decoder->get_sample_rate();
+        flac_ = std::move(decoder);
+        return true;
+    }
+
+    bool open_opus_(const uint8_t* data, size_t size) {
+        auto decoder = std::make_unique<OpusFileDecoder>();
+        if (!decoder->open(data, size)) {
+            ALOGE("Load ogg/opus from %s failed!", path_.c_str());
+            return false;
+        }
+        channels_ = decoder->get_channels();
+        file_sr_ = decoder->get_sample_rate();
+        opus_ = std::move(decoder);
+        return true;
+    }
+
+    // flac or opus, both fill the block unless the stream ends
+    int read_packets_(std::vector<float>& mono) {
+        mono.resize(READER_BLOCK_FRAMES);
+        if (flac_)
+            return flac_->read(mono.data(), READER_BLOCK_FRAMES);
+        return opus_->read(mono.data(), READER_BLOCK_FRAMES);
+    }
+
+    // ret of mp3dec_ex_open()/mp3dec_ex_open_buf()
+    bool open_mp3_(int ret) {
+        if (ret) {
+            ALOGE("Load mp3 from %s failed!", path_.c_str());
+            return false;
+        }
+        mp3_open_ = true;
+        channels_ = mp3_.info.channels;
+        file_sr_ = mp3_.info.hz;
+        return channels_ > 0 && file_sr_ > 0;
+    }
+
+    inline int decode_threads_used_(void) const {
+        if (decode_threads_ > 0)
+            return decode_threads_;
+        int cores = (int)std::thread::hardware_concurrency();
+        return std::max(1, std::min(cores, PARALLEL_MP3_MAX_THREADS));
+    }
+
+    // Map the whole file if it has at least min_size bytes
+    bool map_file_(size_t min_size) {
+        int fd = ::open(path_.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0 && (size_t)st.st_size >= min_size) {
+            void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                map_ = map;
+                map_size_ = st.st_size;
+            }
+        }
+        ::close(fd);
+        return map_ != nullptr;
+    }
+
+    // Falls back to mp3dec_ex if the stream cannot be split
+    bool open_parallel_mp3_(const uint8_t* data, size_t size) {
+        int num_threads = decode_threads_used_();
+        if (num_threads < 2 || size < PARALLEL_MP3_MIN_BYTES)
+            return false;
+
+        auto decoder = std::make_unique<ParallelMp3Decoder>();
+        if (!decoder->open(data, size, num_threads))
+            return false;
+        par_mp3_ = std::move(decoder);
+        channels_ = par_mp3_->get_channels();
+        file_sr_ = par_mp3_->get_sample_rate();
+        pending_.clear();
+        pending_pos_ = 0;
+        par_frames_ = 0;
+        return true;
+    }
+
+    // Fill mono with up to max_frames, short at the end of the stream or
+    // when the decoder failed
+    int read_parallel_mp3_(float* mono, int max_frames, bool& failed) {
+        int frames = 0;
+        failed = false;
+        while (frames < max_frames) {
+            if (pending_pos_ == pending_.size()) {
+                pending_pos_ = 0;
+                if (!par_mp3_->read(pending_)) {
+                    pending_.clear();
+                    failed = par_mp3_->failed();
+                    break;
+                }
+                continue;
+            }
+            size_t n = std::min<size_t>(max_frames - frames, pending_.size() - pending_pos_);
+            std::copy(pending_.begin() + pending_pos_, pending_.begin() + pending_pos_ + n, mono + frames);
+            pending_pos_ += n;
+            frames += n;
+        }
+        par_frames_ += frames;
+        return frames;
+    }
+
+    // A range the parallel decoder could not reproduce, carry on with
+    // mp3dec_ex from the same sample
+    bool fall_back_to_serial_(void) {
+        ALOGW("Parallel decode of %s failed at sample %llu, continue serially", path_.c_str(),
+              (unsigned long long)par_frames_);
+        par_mp3_.reset();
+        const uint8_t* data = map_ ? (const uint8_t*)map_ : mem_data_;
+        size_t size = map_ ? map_size_ : mem_size_;
+        if (!open_mp3_(mp3dec_ex_open_buf(&mp3_, data, size, MP3D_SEEK_TO_BYTE)))
+            return false;
+
+        std::vector<float> skipped(READER_BLOCK_FRAMES);
+        while (par_frames_ > 0) {
+            int n = read_serial_mp3_(skipped.data(), (int)std::min<uint64_t>(par_frames_, READER_BLOCK_FRAMES));
+            if (n <= 0)
+                return false;
+            par_frames_ -= n;
+        }
+        return true;
+    }
+
+    int read_serial_mp3_(float* mono, int max_frames) {
+        raw_mp3_.resize((size_t)max_frames * channels_);
+        size_t got = mp3dec_ex_read(&mp3_, raw_mp3_.data(), raw_mp3_.size());
+        if (got < raw_mp3_.size() && mp3_.last_error) {
+            ALOGE("Decode %s failed, error %d", path_.c_str(), mp3_.last_error);
+            return -1;
+        }
+
+        int frames = got / channels_;
+        for (int i = 0; i < frames; i++) {
+            mono[i] = channels_ == 1 ? raw_mp3_[i] : (raw_mp3_[i * 2] + raw_mp3_[i * 2 + 1]) / 2.0f;
+        }
+        return frames;
+    }
+
+    // Same blocks from both decoders, so the resampler sees the same input
+    int read_mp3_(std::vector<float>& mono) {
+        mono.resize(READER_BLOCK_FRAMES);
+        int frames = 0;
+        if (par_mp3_) {
+            bool failed = false;
+            frames = read_parallel_mp3_(mono.data(), READER_BLOCK_FRAMES, failed);
+            if (!failed)
+                return frames;
+            if (!fall_back_to_serial_())
+                return -1;
+        }
+
+        int n = read_serial_mp3_(mono.data() + frames, READER_BLOCK_FRAMES - frames);
+        return n < 0 ? -1 : frames + n;
+    }
+
+private:
+    std::string path_;                  // "<memory>" for open_memory()
+    std::string format_;
+    const uint8_t* mem_data_ = nullptr;
+    size_t mem_size_ = 0;
+    int target_sr_ = 0;
+    int file_sr_ = 0;
+    int channels_ = 0;
+    bool finished_ = false;
+    bool failed_ = false;
+    std::vector<float> mono_;
+    std::unique_ptr<LinearResample> resampler_;
+
+    const uint8_t* wav_data_ = nullptr;     // next frame in the mapped file or buffer
+    int audio_format_ = 0;
+    int bit_depth_ = 0;
+    uint64_t data_left_ = 0;
+
+    mp3dec_ex_t mp3_;
+    bool mp3_open_ = false;
+    std::vector<float> raw_mp3_;
+
+    int decode_threads_ = 0;
+    std::unique_ptr<ParallelMp3Decoder> par_mp3_;
+    std::vector<float> pending_;        // range from par_mp3_ not yet returned
+    size_t pending_pos_ = 0;
+    uint64_t par_frames_ = 0;           // samples taken from par_mp3_
+    std::unique_ptr<FlacDecoder> flac_;
+    std::unique_ptr<OpusFileDecoder> opus_;
+    void* map_ = nullptr;               // mmap of a wav, flac or opus file, or an mp3 for par_mp3_
+    size_t map_size_ = 0;
+};
+
+AudioReader::AudioReader():
+    impl_(std::make_unique<AudioReader::Impl>()) {
+
+}
+
+AudioReader::~AudioReader() = default;
+
+bool AudioReader::open(const std::string& audio_path, int target_sr) {
+    return impl_->open(audio_path, target_sr);
+}
+
+bool AudioReader::open_memory(const void* data, size_t size, const std::string& format, int target_sr) {
+    return impl_->open_memory(data, size, format, target_sr);
+}
+
+void AudioReader::close() {
+    impl_->close();
+}
+
+bool AudioReader::rewind() {
+    return impl_->rewind();
+}
+
+bool AudioReader::read(std::vector<float>& out) {
+    return impl_->read(out);
+}
+
+bool AudioReader::read_all(std::vector<float>& out) {
+    return impl_->read_all(out);
+}
+
+bool AudioReader::failed() const {
+    return impl_->failed();
+}
+
+int AudioReader::get_sample_rate() const {
+    return impl_->get_sample_rate();
+}
+
+void AudioReader::set_decode_threads(int num_threads) {
+    impl_->set_decode_threads(num_threads);
+}
+
+} // namespace utils
@@ -0,0 +1,67 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+
+namespace utils {
+
+// "wav", "mp3", "flac" or "opus" judged from the first bytes of a file,
+// empty if none of them
+std::string guess_audio_format(const void* data, size_t size);
+
+// Decode an audio file block by block, converted to mono and resampled.
+//
+// Only one block of audio is held at a time, so files of any length are read
+// with constant memory. The concatenated output of read() is the same as
+// AudioLoader::samples for the same file and target_sr.
+class AudioReader {
+public:
+    AudioReader();
+    ~AudioReader();
+
+    // wav, mp3, flac or ogg/opus (.opus or .ogg), if target_sr <= 0 it
+    // doesn't resample. Ogg/Opus needs a build with ENABLE_OPUS.
+    bool open(const std::string& audio_path, int target_sr = 16000);
+    // Encoded file already in memory, e.g. an upload. data must stay valid
+    // until close(). An empty format is guessed from the data.
+    bool open_memory(const void* data, size_t size, const std::string& format, int target_sr = 16000);
+    void close();
+
+    // Start again from the first sample
+    bool rewind();
+
+    // Replace out with the next block of samples, which may be empty when
+    // the resampler is still filling up. Returns false once the whole file
+    // has been returned, or on a read error, see failed().
+    bool read(std::vector<float>& out);
+
+    // Replace out with everything not read yet. A wav is converted in one
+    // pass without the block copies; the samples are the same as from read().
+    bool read_all(std::vector<float>& out);
+
+    // Whether read() stopped because of an error rather than end of file
+    bool failed() const;
+
+    // Rate of the samples returned by read()
+    int get_sample_rate() const;
+
+    // Threads decoding a long mp3, set before open(). 0 picks a number from
+    // the cores, 1 decodes on the calling thread. The output is the same.
+    void set_decode_threads(int num_threads);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace utils
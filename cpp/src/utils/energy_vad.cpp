@@ -0,0 +1,154 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "utils/energy_vad.hpp"
+
+namespace utils {
+
+// Noise floor is taken at this quantile of the frame energies
+#define VAD_NOISE_QUANTILE  0.1f
+
+EnergyVad::EnergyVad(const EnergyVadConfig& config):
+    config_(config) {
+    if (config_.frame_ms <= 0)
+        config_.frame_ms = 10;
+}
+
+std::vector<VadSegment> EnergyVad::detect(const float* pcm, int num_samples, int sample_rate) {
+    if (!pcm || num_samples <= 0 || sample_rate <= 0)
+        return std::vector<VadSegment>();
+
+    begin(sample_rate);
+    accept_waveform(pcm, num_samples);
+    return finish();
+}
+
+void EnergyVad::begin(int sample_rate) {
+    frame_len_ = std::max(1, sample_rate * config_.frame_ms / 1000);
+    num_samples_ = 0;
+    frame_power_ = 0.0f;
+    frame_fill_ = 0;
+    energy_db_.clear();
+}
+
+void EnergyVad::accept_waveform(const float* pcm, int num_samples) {
+    for (int i = 0; i < num_samples; i++) {
+        frame_power_ += pcm[i] * pcm[i];
+        if (++frame_fill_ == frame_len_) {
+            energy_db_.push_back(10.0f * log10f(frame_power_ / frame_fill_ + 1e-10f));
+            frame_power_ = 0.0f;
+            frame_fill_ = 0;
+        }
+    }
+    num_samples_ += num_samples;
+}
+
+std::vector<VadSegment> EnergyVad::finish() {
+    std::vector<VadSegment> segments;
+
+    // The last frame may be short
+    if (frame_fill_ > 0) {
+        energy_db_.push_back(10.0f * log10f(frame_power_ / frame_fill_ + 1e-10f));
+        frame_power_ = 0.0f;
+        frame_fill_ = 0;
+    }
+
+    const std::vector<float>& energy_db = energy_db_;
+    const int num_frames = energy_db.size();
+    const int frame_len = frame_len_;
+    const int num_samples = num_samples_;
+    if (num_frames == 0)
+        return segments;
+
+    std::vector<float> sorted(energy_db);
+    auto nth = sorted.begin() + (int)(VAD_NOISE_QUANTILE * (num_frames - 1));
+    std::nth_element(sorted.begin(), nth, sorted.end());
+    const float threshold = std::max(*nth + config_.threshold_db, config_.min_energy_dbfs);
+
+    // Runs of speech frames, [begin, end) in frames
+    std::vector<std::pair<int, int>> runs;
+    for (int i = 0; i < num_frames; ) {
+        if (energy_db[i] < threshold) {
+            i++;
+            continue;
+        }
+        int begin = i;
+        while (i < num_frames && energy_db[i] >= threshold) i++;
+        runs.emplace_back(begin, i);
+    }
+
+    const int min_silence = config_.min_silence_ms / config_.frame_ms;
+    const int min_speech = config_.min_speech_ms / config_.frame_ms;
+    const int pad = config_.speech_pad_ms / config_.frame_ms;
+
+    // Bridge short pauses
+    std::vector<std::pair<int, int>> merged;
+    for (auto& r : runs) {
+        if (!merged.empty() && r.first - merged.back().second < min_silence)
+            merged.back().second = r.second;
+        else
+            merged.push_back(r);
+    }
+
+    // Drop clicks, add context and merge what overlaps after padding
+    std::vector<std::pair<int, int>> padded;
+    for (auto& r : merged) {
+        if (r.second - r.first < min_speech)
+            continue;
+        int begin = std::max(0, r.first - pad);
+        int end = std::min(num_frames, r.second + pad);
+        if (!padded.empty() && begin <= padded.back().second)
+            padded.back().second = end;
+        else
+            padded.emplace_back(begin, end);
+    }
+
+    std::vector<std::pair<int, int>> limited;
+    const int max_frames = config_.max_segment_ms > 0 ? config_.max_segment_ms / config_.frame_ms : 0;
+    for (auto& r : padded) {
+        if (max_frames > 0)
+            split_long_(energy_db, r.first, r.second, max_frames, limited);
+        else
+            limited.push_back(r);
+    }
+
+    segments.reserve(limited.size());
+    for (auto& r : limited) {
+        VadSegment seg;
+        seg.start = r.first * frame_len;
+        seg.end = std::min(r.second * frame_len, num_samples);
+        segments.push_back(seg);
+    }
+    return segments;
+}
+
+void EnergyVad::split_long_(const std::vector<float>& energy_db, int begin, int end, int max_frames,
+                            std::vector<std::pair<int, int>>& out) const {
+    while (end - begin > max_frames) {
+        // Cut at the quietest frame of the second half of the allowed window,
+        // which is the most likely pause between words
+        int search_begin = begin + max_frames / 2;
+        int search_end = begin + max_frames;
+        int cut = search_begin;
+        for (int i = search_begin + 1; i < search_end; i++) {
+            if (energy_db[i] < energy_db[cut])
+                cut = i;
+        }
+        out.emplace_back(begin, cut);
+        begin = cut;
+    }
+    if (end > begin)
+        out.emplace_back(begin, end);
+}
+
+} // namespace utils
@@ -0,0 +1,70 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <vector>
+
+namespace utils {
+
+struct EnergyVadConfig {
+    int frame_ms = 10;
+    // A frame is speech if it is this much louder than the noise floor
+    float threshold_db = 12.0f;
+    // Frames below this level are never speech, whatever the noise floor
+    float min_energy_dbfs = -55.0f;
+    // Pauses shorter than this do not split speech
+    int min_silence_ms = 300;
+    // Speech runs shorter than this are dropped
+    int min_speech_ms = 120;
+    // Context kept around each speech run
+    int speech_pad_ms = 150;
+    // Longer speech is split at its quietest point, <= 0 means no limit
+    int max_segment_ms = 0;
+};
+
+struct VadSegment {
+    int start;      // first sample
+    int end;        // one past the last sample
+};
+
+// Offline energy based voice activity detection.
+//
+// The noise floor is estimated from the quiet end of the frame energy
+// distribution of the whole signal, so the threshold adapts to the
+// recording level instead of using a fixed absolute value.
+class EnergyVad {
+public:
+    explicit EnergyVad(const EnergyVadConfig& config = EnergyVadConfig());
+
+    // pcm: mono float PCM in [-1.0, 1.0]
+    std::vector<VadSegment> detect(const float* pcm, int num_samples, int sample_rate);
+
+    // Same as detect() for audio that arrives in chunks, only the frame
+    // energies (4 bytes per frame) are kept:
+    //   begin(sample_rate); accept_waveform(...) per chunk; finish()
+    void begin(int sample_rate);
+    void accept_waveform(const float* pcm, int num_samples);
+    std::vector<VadSegment> finish();
+
+private:
+    void split_long_(const std::vector<float>& energy_db, int begin, int end, int max_frames,
+                     std::vector<std::pair<int, int>>& out) const;
+
+private:
+    EnergyVadConfig config_;
+    int frame_len_ = 0;
+    int num_samples_ = 0;
+    // Partial frame carried to the next accept_waveform()
+    float frame_power_ = 0.0f;
+    int frame_fill_ = 0;
+    std::vector<float> energy_db_;
+};
+
+} // namespace utils
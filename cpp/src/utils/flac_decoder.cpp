@@ -0,0 +1,630 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "utils/flac_decoder.hpp"
+#include "utils/logger.h"
+
+#define FLAC_MAX_CHANNELS       8
+#define FLAC_MAX_LPC_ORDER      32
+// Smallest possible frame: header, one constant subframe, footer
+#define FLAC_MIN_FRAME_BYTES    10
+
+namespace utils {
+
+// Frame header codes, 0 means "from STREAMINFO", -1 is reserved or read
+// from the end of the header
+static const int kBlockSizes[16] = {-1, 192, 576, 1152, 2304, 4608, -1, -1,
+                                    256, 512, 1024, 2048, 4096, 8192, 16384, 32768};
+static const int kSampleRates[12] = {0, 88200, 176400, 192000, 8000, 16000, 22050, 24000, 32000, 44100, 48000, 96000};
+static const int kSampleSizes[8] = {0, 8, 12, -1, 16, 20, 24, 32};
+
+// CRC-8 of the frame header, polynomial x^8 + x^2 + x + 1
+static uint8_t crc8(const uint8_t* p, size_t n) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// CRC-16 of the whole frame, polynomial x^16 + x^15 + x^2 + 1
+static uint16_t crc16(const uint8_t* p, size_t n) {
+    static const std::vector<uint16_t> table = [] {
+        std::vector<uint16_t> t(256);
+        for (int i = 0; i < 256; i++) {
+            uint16_t crc = (uint16_t)(i << 8);
+            for (int b = 0; b < 8; b++) {
+                crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x8005) : (uint16_t)(crc << 1);
+            }
+            t[i] = crc;
+        }
+        return t;
+    }();
+
+    uint16_t crc = 0;
+    for (size_t i = 0; i < n; i++) {
+        crc = (uint16_t)((crc << 8) ^ table[(crc >> 8) ^ p[i]]);
+    }
+    return crc;
+}
+
+// MSB first bit reader with a 64 bit cache. Reading past the end gives
+// zeros and sets overrun(), the frame CRC catches the rest.
+class FlacBitReader {
+public:
+    FlacBitReader(const uint8_t* data, const uint8_t* end):
+        pos_(data), end_(end) {
+
+    }
+
+    // n <= 32
+    inline uint32_t read(int n) {
+        if (n == 0)
+            return 0;
+        if (bits_ < n) {
+            refill_();
+            if (bits_ < n) {
+                overrun_ = true;
+                return 0;
+            }
+        }
+        uint32_t v = (uint32_t)(cache_ >> (64 - n));
+        cache_ <<= n;
+        bits_ -= n;
+        return v;
+    }
+
+    inline int32_t read_signed(int n) {
+        if (n == 0)
+            return 0;
+        uint32_t v = read(n);
+        return (int32_t)(v << (32 - n)) >> (32 - n);
+    }
+
+    // Number of 0 bits before the next 1, which is consumed too
+    inline uint32_t read_unary() {
+        uint32_t q = 0;
+        while (true) {
+            if (bits_ == 0) {
+                refill_();
+                if (bits_ == 0) {
+                    overrun_ = true;
+                    return 0;
+                }
+            }
+            if (cache_ == 0) {
+                q += bits_;
+                bits_ = 0;
+                continue;
+            }
+            // Bits past bits_ are always 0, so the 1 is a valid one
+            int zeros = __builtin_clzll(cache_);
+            q += zeros;
+            cache_ = zeros == 63 ? 0 : cache_ << (zeros + 1);
+            bits_ -= zeros + 1;
+            return q;
+        }
+    }
+
+    // Skip to the next byte boundary
+    inline void align() {
+        int drop = bits_ & 7;
+        cache_ <<= drop;
+        bits_ -= drop;
+    }
+
+    // First byte not consumed, only valid when aligned
+    inline const uint8_t* byte_pos() const {
+        return pos_ - bits_ / 8;
+    }
+
+    inline bool overrun() const {
+        return overrun_;
+    }
+
+private:
+    inline void refill_() {
+        while (bits_ <= 56 && pos_ < end_) {
+            cache_ |= (uint64_t)*pos_++ << (56 - bits_);
+            bits_ += 8;
+        }
+    }
+
+private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+    uint64_t cache_ = 0;
+    int bits_ = 0;
+    bool overrun_ = false;
+};
+
+class FlacDecoder::Impl {
+public:
+    bool open(const uint8_t* data, size_t size) {
+        close();
+
+        size_t pos = 0;
+        // An ID3v2 tag in front is tolerated, as for mp3
+        if (size >= 10 && memcmp(data, "ID3", 3) == 0) {
+            size_t tag_size = ((data[6] & 0x7F) << 21) | ((data[7] & 0x7F) << 14) | ((data[8] & 0x7F) << 7) | (data[9] & 0x7F);
+            pos = 10 + tag_size + ((data[5] & 0x10) ? 10 : 0);
+        }
+        if (pos + 4 > size || memcmp(data + pos, "fLaC", 4) != 0) {
+            ALOGE("Not a flac stream");
+            return false;
+        }
+        pos += 4;
+
+        bool has_info = false;
+        bool last = false;
+        while (!last) {
+            if (pos + 4 > size) {
+                ALOGE("Truncated flac metadata");
+                return false;
+            }
+            last = (data[pos] & 0x80) != 0;
+            int type = data[pos] & 0x7F;
+            size_t length = (data[pos + 1] << 16) | (data[pos + 2] << 8) | data[pos + 3];
+            pos += 4;
+            if (pos + length > size) {
+                ALOGE("Truncated flac metadata");
+                return false;
+            }
+            if (type == 0 && length >= 34) {
+                const uint8_t* p = data + pos;
+                sample_rate_ = (p[10] << 12) | (p[11] << 4) | (p[12] >> 4);
+                channels_ = ((p[12] >> 1) & 7) + 1;
+                bits_per_sample_ = (((p[12] & 1) << 4) | (p[13] >> 4)) + 1;
+                total_samples_ = ((uint64_t)(p[13] & 0x0F) << 32) | ((uint64_t)p[14] << 24) |
+                                 ((uint64_t)p[15] << 16) | ((uint64_t)p[16] << 8) | p[17];
+                has_info = true;
+            }
+            pos += length;
+        }
+
+        if (!has_info || sample_rate_ <= 0) {
+            ALOGE("flac stream without STREAMINFO");
+            return false;
+        }
+        if (bits_per_sample_ < 4 || bits_per_sample_ > 24) {
+            ALOGE("Unsupported flac with %d bits per sample", bits_per_sample_);
+            return false;
+        }
+
+        data_ = data;
+        pos_ = pos;
+        size_ = size;
+        decoded_ = 0;
+        failed_ = false;
+        scale_ = 1.0f / (float)(1 << (bits_per_sample_ - 1));
+        channel_data_.assign(channels_, std::vector<int32_t>());
+        return true;
+    }
+
+    void close(void) {
+        data_ = nullptr;
+        pos_ = size_ = 0;
+        frame_len_ = frame_pos_ = 0;
+        channel_data_.clear();
+    }
+
+    int read(float* mono, int max_frames) {
+        if (!data_ || failed_)
+            return -1;
+
+        int frames = 0;
+        while (frames < max_frames) {
+            if (frame_pos_ == frame_len_) {
+                int ret = decode_frame_();
+                if (ret < 0) {
+                    failed_ = true;
+                    break;
+                }
+                if (ret == 0)
+                    break;
+                continue;
+            }
+            int n = std::min(max_frames - frames, frame_len_ - frame_pos_);
+            mix_(mono + frames, n);
+            frames += n;
+        }
+        // What was decoded before a bad frame is still returned
+        return frames == 0 && failed_ ? -1 : frames;
+    }
+
+    inline int get_sample_rate() const {
+        return sample_rate_;
+    }
+
+    inline int get_channels() const {
+        return channels_;
+    }
+
+    inline int get_bits_per_sample() const {
+        return bits_per_sample_;
+    }
+
+private:
+    struct FrameHeader {
+        int block_size;
+        int channel_assignment;     // 0-7 independent, 8 left/side, 9 side/right, 10 mid/side
+        int length;                 // bytes, CRC-8 included
+    };
+
+    // Same mixdown and scaling as a wav of the same bit depth
+    void mix_(float* mono, int n) {
+        const int32_t* left = channel_data_[0].data() + frame_pos_;
+        if (channels_ == 2) {
+            const int32_t* right = channel_data_[1].data() + frame_pos_;
+            for (int i = 0; i < n; i++) {
+                mono[i] = (left[i] * scale_ + right[i] * scale_) / 2;
+            }
+        } else {
+            for (int i = 0; i < n; i++) {
+                mono[i] = left[i] * scale_;
+            }
+        }
+        frame_pos_ += n;
+    }
+
+    // Returns the header length, 0 if p is not a valid frame header
+    int parse_header_(const uint8_t* p, size_t avail, FrameHeader& header) const {
+        if (avail < FLAC_MIN_FRAME_BYTES || p[0] != 0xFF || (p[1] & 0xFE) != 0xF8)
+            return 0;
+
+        int block_code = p[2] >> 4;
+        int rate_code = p[2] & 0x0F;
+        int assignment = p[3] >> 4;
+        int size_code = (p[3] >> 1) & 7;
+        if (block_code == 0 || rate_code == 15 || assignment > 10 || size_code == 3 || (p[3] & 1))
+            return 0;
+
+        // UTF-8 style frame or sample number, only its length matters
+        size_t i = 4;
+        int extra;
+        if (p[i] < 0x80)
+            extra = 0;
+        else if ((p[i] & 0xE0) == 0xC0)
+            extra = 1;
+        else if ((p[i] & 0xF0) == 0xE0)
+            extra = 2;
+        else if ((p[i] & 0xF8) == 0xF0)
+            extra = 3;
+        else if ((p[i] & 0xFC) == 0xF8)
+            extra = 4;
+        else if ((p[i] & 0xFE) == 0xFC)
+            extra = 5;
+        else if (p[i] == 0xFE)
+            extra = 6;
+        else
+            return 0;
+        i++;
+        if (i + extra + 5 > avail)
+            return 0;
+        for (int k = 0; k < extra; k++, i++) {
+            if ((p[i] & 0xC0) != 0x80)
+                return 0;
+        }
+
+        int block_size = kBlockSizes[block_code];
+        if (block_code == 6) {
+            block_size = p[i] + 1;
+            i += 1;
+        } else if (block_code == 7) {
+            block_size = ((p[i] << 8) | p[i + 1]) + 1;
+            i += 2;
+        }
+
+        int sample_rate = rate_code < 12 ? kSampleRates[rate_code] : 0;
+        if (rate_code == 12) {
+            sample_rate = p[i] * 1000;
+            i += 1;
+        } else if (rate_code == 13) {
+            sample_rate = (p[i] << 8) | p[i + 1];
+            i += 2;
+        } else if (rate_code == 14) {
+            sample_rate = ((p[i] << 8) | p[i + 1]) * 10;
+            i += 2;
+        }
+        if (i + 1 > avail || crc8(p, i) != p[i])
+            return 0;
+
+        // Parameters that change mid-stream are not supported, and a
+        // header that disagrees with STREAMINFO is most likely garbage
+        int channels = assignment < 8 ? assignment + 1 : 2;
+        int bits = kSampleSizes[size_code];
+        if ((sample_rate && sample_rate != sample_rate_) || (bits && bits != bits_per_sample_) || channels != channels_)
+            return 0;
+
+        header.block_size = block_size;
+        header.channel_assignment = assignment;
+        header.length = (int)i + 1;
+        return header.length;
+    }
+
+    // Returns the samples per channel of the next frame, 0 at the end of
+    // the stream, -1 on a corrupt frame
+    int decode_frame_(void) {
+        frame_pos_ = frame_len_ = 0;
+        if (total_samples_ && decoded_ >= total_samples_)
+            return 0;
+
+        // Frames follow each other, anything else in between (or trailing
+        // tags) is skipped up to the next valid header
+        FrameHeader header;
+        while (pos_ < size_ && !parse_header_(data_ + pos_, size_ - pos_, header)) {
+            pos_++;
+        }
+        if (pos_ >= size_)
+            return 0;
+
+        const uint8_t* frame = data_ + pos_;
+        FlacBitReader reader(frame + header.length, data_ + size_);
+        const int block_size = header.block_size;
+        for (int c = 0; c < channels_; c++) {
+            // The side channel has one more bit
+            int bits = bits_per_sample_;
+            if ((header.channel_assignment == 8 && c == 1) || (header.channel_assignment == 9 && c == 0) ||
+                (header.channel_assignment == 10 && c == 1))
+                bits++;
+
+            auto& samples = channel_data_[c];
+            samples.resize(block_size);
+            if (!decode_subframe_(reader, bits, block_size, samples.data()))
+                return frame_error_(reader);
+        }
+
+        reader.align();
+        const uint8_t* footer = reader.byte_pos();
+        if (reader.overrun() || footer + 2 > data_ + size_)
+            return frame_error_(reader);
+        if (crc16(frame, footer - frame) != ((footer[0] << 8) | footer[1])) {
+            ALOGE("flac frame CRC mismatch at byte %zu", pos_);
+            return -1;
+        }
+        pos_ = footer + 2 - data_;
+
+        decorrelate_(header.channel_assignment, block_size);
+        frame_len_ = block_size;
+        if (total_samples_ && decoded_ + frame_len_ > total_samples_)
+            frame_len_ = (int)(total_samples_ - decoded_);
+        decoded_ += frame_len_;
+        return frame_len_;
+    }
+
+    // A frame cut off by the end of the data ends the stream, like a
+    // truncated wav keeps the samples it has; anything else is corrupt
+    int frame_error_(const FlacBitReader& reader) {
+        if (reader.overrun() || pos_ + FLAC_MIN_FRAME_BYTES > size_) {
+            ALOGW("flac stream truncated at byte %zu", pos_);
+            pos_ = size_;
+            return 0;
+        }
+        ALOGE("Corrupt flac frame at byte %zu", pos_);
+        return -1;
+    }
+
+    void decorrelate_(int assignment, int n) {
+        if (assignment < 8)
+            return;
+        int32_t* a = channel_data_[0].data();
+        int32_t* b = channel_data_[1].data();
+        if (assignment == 8) {
+            // left, side
+            for (int i = 0; i < n; i++) {
+                b[i] = a[i] - b[i];
+            }
+        } else if (assignment == 9) {
+            // side, right
+            for (int i = 0; i < n; i++) {
+                a[i] += b[i];
+            }
+        } else {
+            // mid, side; the bit dropped from mid is the low bit of side
+            for (int i = 0; i < n; i++) {
+                int32_t side = b[i];
+                int32_t mid = (int32_t)((uint32_t)a[i] << 1) | (side & 1);
+                a[i] = (mid + side) >> 1;
+                b[i] = (mid - side) >> 1;
+            }
+        }
+    }
+
+    bool decode_subframe_(FlacBitReader& reader, int bits, int n, int32_t* out) {
+        if (reader.read(1) != 0)
+            return false;
+        int type = reader.read(6);
+        int wasted = 0;
+        if (reader.read(1)) {
+            wasted = reader.read_unary() + 1;
+            bits -= wasted;
+            if (bits <= 0)
+                return false;
+        }
+
+        if (type == 0) {
+            // CONSTANT
+            std::fill(out, out + n, reader.read_signed(bits));
+        } else if (type == 1) {
+            // VERBATIM
+            for (int i = 0; i < n; i++) {
+                out[i] = reader.read_signed(bits);
+            }
+        } else if (type >= 8 && type <= 12) {
+            // FIXED, order 0-4
+            int order = type - 8;
+            if (order > n)
+                return false;
+            for (int i = 0; i < order; i++) {
+                out[i] = reader.read_signed(bits);
+            }
+            if (!decode_residual_(reader, n, order, out))
+                return false;
+            restore_fixed_(order, n, out);
+        } else if (type >= 32) {
+            // LPC, order 1-32
+            int order = type - 31;
+            if (order > n)
+                return false;
+            for (int i = 0; i < order; i++) {
+                out[i] = reader.read_signed(bits);
+            }
+            int precision = reader.read(4) + 1;
+            int shift = reader.read_signed(5);
+            if (precision == 16 || shift < 0)
+                return false;
+            int32_t coefs[FLAC_MAX_LPC_ORDER];
+            for (int i = 0; i < order; i++) {
+                coefs[i] = reader.read_signed(precision);
+            }
+            if (!decode_residual_(reader, n, order, out))
+                return false;
+            restore_lpc_(coefs, order, shift, n, out);
+        } else {
+            return false;
+        }
+
+        if (wasted) {
+            for (int i = 0; i < n; i++) {
+                out[i] = (int32_t)((uint32_t)out[i] << wasted);
+            }
+        }
+        return !reader.overrun();
+    }
+
+    // Partitioned Rice residual of samples [order, n) of out
+    bool decode_residual_(FlacBitReader& reader, int n, int order, int32_t* out) {
+        int method = reader.read(2);
+        if (method > 1)
+            return false;
+        const int param_bits = method == 0 ? 4 : 5;
+        const int escape = method == 0 ? 15 : 31;
+
+        int partition_order = reader.read(4);
+        int partition_size = n >> partition_order;
+        if ((partition_size << partition_order) != n || partition_size < order)
+            return false;
+
+        int32_t* dst = out + order;
+        for (int p = 0; p < (1 << partition_order); p++) {
+            int count = partition_size - (p == 0 ? order : 0);
+            int k = reader.read(param_bits);
+            if (k == escape) {
+                int raw_bits = reader.read(5);
+                for (int i = 0; i < count; i++) {
+                    dst[i] = reader.read_signed(raw_bits);
+                }
+            } else {
+                for (int i = 0; i < count; i++) {
+                    // Quotient before remainder, the operands of | are unsequenced
+                    uint32_t q = reader.read_unary();
+                    uint32_t u = (q << k) | reader.read(k);
+                    dst[i] = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+                }
+            }
+            dst += count;
+            if (reader.overrun())
+                return false;
+        }
+        return true;
+    }
+
+    static void restore_fixed_(int order, int n, int32_t* x) {
+        switch (order) {
+        case 1:
+            for (int i = 1; i < n; i++)
+                x[i] += x[i - 1];
+            break;
+        case 2:
+            for (int i = 2; i < n; i++)
+                x[i] += 2 * x[i - 1] - x[i - 2];
+            break;
+        case 3:
+            for (int i = 3; i < n; i++)
+                x[i] += 3 * (x[i - 1] - x[i - 2]) + x[i - 3];
+            break;
+        case 4:
+            for (int i = 4; i < n; i++)
+                x[i] += 4 * (x[i - 1] + x[i - 3]) - 6 * x[i - 2] - x[i - 4];
+            break;
+        default:
+            break;
+        }
+    }
+
+    // coefs[0] weighs the most recent sample. 64 bit sums, 24 bit samples
+    // with 15 bit coefficients overflow 32 bits at high orders.
+    static void restore_lpc_(const int32_t* coefs, int order, int shift, int n, int32_t* x) {
+        for (int i = order; i < n; i++) {
+            int64_t sum = 0;
+            const int32_t* history = x + i - 1;
+            for (int j = 0; j < order; j++) {
+                sum += (int64_t)coefs[j] * history[-j];
+            }
+            x[i] += (int32_t)(sum >> shift);
+        }
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;                    // next frame
+    int sample_rate_ = 0;
+    int channels_ = 0;
+    int bits_per_sample_ = 0;
+    uint64_t total_samples_ = 0;        // per channel, 0 if unknown
+    uint64_t decoded_ = 0;
+    float scale_ = 1.0f;
+    bool failed_ = false;
+
+    // Current frame, [frame_pos_, frame_len_) not returned yet
+    std::vector<std::vector<int32_t>> channel_data_;
+    int frame_len_ = 0;
+    int frame_pos_ = 0;
+};
+
+FlacDecoder::FlacDecoder():
+    impl_(std::make_unique<FlacDecoder::Impl>()) {
+
+}
+
+FlacDecoder::~FlacDecoder() = default;
+
+bool FlacDecoder::open(const uint8_t* data, size_t size) {
+    return impl_->open(data, size);
+}
+
+void FlacDecoder::close() {
+    impl_->close();
+}
+
+int FlacDecoder::read(float* mono, int max_frames) {
+    return impl_->read(mono, max_frames);
+}
+
+int FlacDecoder::get_sample_rate() const {
+    return impl_->get_sample_rate();
+}
+
+int FlacDecoder::get_channels() const {
+    return impl_->get_channels();
+}
+
+int FlacDecoder::get_bits_per_sample() const {
+    return impl_->get_bits_per_sample();
+}
+
+} // namespace utils
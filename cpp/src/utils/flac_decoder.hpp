@@ -0,0 +1,44 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace utils {
+
+// Native FLAC decoder over an encoded file in memory, e.g. a mapped file or
+// an upload. Decodes one frame at a time and mixes it down to mono the same
+// way as a wav: stereo is averaged, more channels keep the first one.
+// Up to 24 bits per sample, which covers what encoders produce for speech.
+class FlacDecoder {
+public:
+    FlacDecoder();
+    ~FlacDecoder();
+
+    // data must stay valid until close()
+    bool open(const uint8_t* data, size_t size);
+    void close();
+
+    // Write up to max_frames mono samples in [-1.0, 1.0] to mono. Returns
+    // the number written, 0 at the end of the stream, -1 on a corrupt frame.
+    int read(float* mono, int max_frames);
+
+    int get_sample_rate() const;
+    int get_channels() const;
+    int get_bits_per_sample() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace utils
@@ -43,7 +43,7 @@ typedef Eigen::Matrix<std::complex<float>, Eigen::Dynamic, Eigen::Dynamic, Eigen
 
 namespace internal{
 
-static Vectorf pad(Vectorf &x, int left, int right, const std::string &mode, float value){
+static Vectorf pad(const Eigen::Ref<const Vectorf> &x, int left, int right, const std::string &mode, float value){
   Vectorf x_paded = Vectorf::Constant(left+x.size()+right, value);
   x_paded.segment(left, x.size()) = x;
 
@@ -76,7 +76,7 @@ static Vectorf pad(Vectorf &x, int left, int right, const std::string &mode, flo
   return x_paded;
 }
 
-static Matrixcf stft(Vectorf &x, int n_fft, int n_hop, const std::string &win, bool center, const std::string &mode){
+static Matrixcf stft(const Eigen::Ref<const Vectorf> &x, int n_fft, int n_hop, const std::string &win, bool center, const std::string &mode){
   // hanning
   Vectorf window = 0.5*(1.f-(Vectorf::LinSpaced(n_fft, 0.f, static_cast<float>(n_fft-1))*2.f*M_PI/n_fft).array().cos());
 
@@ -143,7 +143,7 @@ static Matrixf melfilter(int sr, int n_fft, int n_mels, int fmin, int fmax){
   return weights;
 }
 
-static Matrixf melspectrogram(Vectorf &x, int sr, int n_fft, int n_hop,
+static Matrixf melspectrogram(const Eigen::Ref<const Vectorf> &x, int sr, int n_fft, int n_hop,
                         const std::string &win, bool center,
                         const std::string &mode, float power,
                         int n_mels, int fmin, int fmax){
@@ -192,7 +192,7 @@ public:
                                                             int n_fft, int n_hop,
                                                             const std::string &win, bool center,
                                                             const std::string &mode){
-    Vectorf map_x = Eigen::Map<Vectorf>(x.data(), x.size());
+    Eigen::Map<const Vectorf> map_x(x.data(), x.size());
     Matrixcf X = internal::stft(map_x, n_fft, n_hop, win, center, mode);
     std::vector<std::vector<std::complex<float>>> X_vector(X.rows(), std::vector<std::complex<float>>(X.cols(), 0));
     for (int i = 0; i < X.rows(); ++i){
@@ -218,7 +218,7 @@ public:
   static std::vector<std::vector<float>> melspectrogram(std::vector<float> &x, int sr, 
                                                         int n_fft, int n_hop, const std::string &win, bool center, const std::string &mode,
                                                         float power, int n_mels, int fmin, int fmax){
-    Vectorf map_x = Eigen::Map<Vectorf>(x.data(), x.size());
+    Eigen::Map<const Vectorf> map_x(x.data(), x.size());
     Matrixf mel = internal::melspectrogram(map_x, sr, n_fft, n_hop, win, center, mode, power, n_mels, fmin, fmax).transpose();
     std::vector<std::vector<float>> mel_vector(mel.rows(), std::vector<float>(mel.cols(), 0.f));
     for (int i = 0; i < mel.rows(); ++i){
@@ -248,7 +248,7 @@ public:
                                               int n_fft, int n_hop, const std::string &win, bool center, const std::string &mode,
                                               float power, int n_mels, int fmin, int fmax,
                                               int n_mfcc, bool norm, int type) {
-    Vectorf map_x = Eigen::Map<Vectorf>(x.data(), x.size());
+    Eigen::Map<const Vectorf> map_x(x.data(), x.size());
     Matrixf mel = internal::melspectrogram(map_x, sr, n_fft, n_hop, win, center, mode, power, n_mels, fmin, fmax).transpose();
     Matrixf mel_db = internal::power2db(mel);
     Matrixf dct = internal::dct(mel_db, norm, type).leftCols(n_mfcc);
@@ -0,0 +1,147 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <vector>
+
+#include "utils/opus_file_decoder.hpp"
+#include "utils/logger.h"
+#if defined(HAVE_OPUSFILE)
+#include <opusfile.h>
+#endif
+
+#define OPUS_SAMPLE_RATE    48000
+
+namespace utils {
+
+#if defined(HAVE_OPUSFILE)
+
+class OpusFileDecoder::Impl {
+public:
+    ~Impl() {
+        close();
+    }
+
+    bool open(const uint8_t* data, size_t size) {
+        close();
+        int error = 0;
+        file_ = op_open_memory(data, size, &error);
+        if (!file_) {
+            ALOGE("Cannot open ogg/opus stream, error %d", error);
+            return false;
+        }
+        channels_ = op_channel_count(file_, -1);
+        failed_ = false;
+        return true;
+    }
+
+    void close(void) {
+        if (file_) {
+            op_free(file_);
+            file_ = nullptr;
+        }
+    }
+
+    int read(float* mono, int max_frames) {
+        if (!file_ || failed_)
+            return -1;
+
+        // Downmixed to stereo by opusfile whatever the channel layout, a
+        // mono stream comes back as two equal channels
+        stereo_.resize((size_t)max_frames * 2);
+        int frames = 0;
+        while (frames < max_frames) {
+            int n = op_read_float_stereo(file_, stereo_.data(), (max_frames - frames) * 2);
+            if (n == OP_HOLE) {
+                ALOGW("Gap in ogg/opus stream, skipped");
+                continue;
+            }
+            if (n < 0) {
+                ALOGE("Decode ogg/opus failed, error %d", n);
+                failed_ = true;
+                break;
+            }
+            if (n == 0)
+                break;
+            for (int i = 0; i < n; i++) {
+                mono[frames + i] = (stereo_[i * 2] + stereo_[i * 2 + 1]) / 2;
+            }
+            frames += n;
+        }
+        return frames == 0 && failed_ ? -1 : frames;
+    }
+
+    inline int get_channels() const {
+        return channels_;
+    }
+
+private:
+    OggOpusFile* file_ = nullptr;
+    int channels_ = 0;
+    bool failed_ = false;
+    std::vector<float> stereo_;
+};
+
+#else
+
+class OpusFileDecoder::Impl {
+public:
+    bool open(const uint8_t* /*data*/, size_t /*size*/) {
+        ALOGE("Ogg/Opus input needs a build with -DENABLE_OPUS=ON");
+        return false;
+    }
+
+    void close(void) {}
+
+    int read(float* /*mono*/, int /*max_frames*/) {
+        return -1;
+    }
+
+    inline int get_channels() const {
+        return 0;
+    }
+};
+
+#endif
+
+OpusFileDecoder::OpusFileDecoder():
+    impl_(std::make_unique<OpusFileDecoder::Impl>()) {
+
+}
+
+OpusFileDecoder::~OpusFileDecoder() = default;
+
+bool OpusFileDecoder::available() {
+#if defined(HAVE_OPUSFILE)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool OpusFileDecoder::open(const uint8_t* data, size_t size) {
+    return impl_->open(data, size);
+}
+
+void OpusFileDecoder::close() {
+    impl_->close();
+}
+
+int OpusFileDecoder::read(float* mono, int max_frames) {
+    return impl_->read(mono, max_frames);
+}
+
+int OpusFileDecoder::get_sample_rate() const {
+    return OPUS_SAMPLE_RATE;
+}
+
+int OpusFileDecoder::get_channels() const {
+    return impl_->get_channels();
+}
+
+} // namespace utils
@@ -0,0 +1,45 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace utils {
+
+// Ogg/Opus over an encoded file in memory, decoded packet by packet with
+// libopusfile. Only built in with ENABLE_OPUS, otherwise open() fails.
+// Opus always decodes at 48kHz; channels are mixed down to mono.
+class OpusFileDecoder {
+public:
+    OpusFileDecoder();
+    ~OpusFileDecoder();
+
+    // Whether this build can decode Ogg/Opus at all
+    static bool available();
+
+    // data must stay valid until close()
+    bool open(const uint8_t* data, size_t size);
+    void close();
+
+    // Write up to max_frames mono samples in [-1.0, 1.0] to mono. Returns
+    // the number written, 0 at the end of the stream, -1 on a decode error.
+    int read(float* mono, int max_frames);
+
+    int get_sample_rate() const;
+    int get_channels() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace utils
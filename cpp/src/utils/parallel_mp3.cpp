@@ -0,0 +1,344 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "utils/parallel_mp3.hpp"
+#include "utils/logger.h"
+// minimp3 itself is compiled in AudioLoader.cpp
+#define MINIMP3_FLOAT_OUTPUT
+#include "minimp3.h"
+#include "minimp3_ext.h"
+
+// Frames per range, about 6.5s at 44.1kHz
+#define MP3_RANGE_FRAMES        256
+// Frames decoded and dropped before a range. main_data_begin reaches back
+// at most 511 bytes, which is a few frames even at the lowest bitrates, and
+// the IMDCT overlap and synthesis window need one more good frame.
+#define MP3_WARMUP_FRAMES       10
+// Ranges decoded ahead of the reader per thread
+#define MP3_LOOKAHEAD_PER_THREAD 2
+
+namespace utils {
+
+class ParallelMp3Decoder::Impl {
+public:
+    ~Impl() {
+        close();
+    }
+
+    bool open(const uint8_t* data, size_t size, int num_threads) {
+        close();
+
+        // Same start offset, encoder delay and padding as the serial
+        // decoder, without its full index scan
+        mp3dec_ex_t probe;
+        if (mp3dec_ex_open_buf(&probe, data, size, MP3D_SEEK_TO_BYTE | MP3D_DO_NOT_SCAN))
+            return false;
+        hz_ = probe.info.hz;
+        layer_ = probe.info.layer;
+        channels_ = probe.info.channels;
+        start_delay_ = probe.start_delay;
+        detected_samples_ = probe.detected_samples;
+        uint64_t start_offset = probe.start_offset;
+        end_offset_ = probe.end_offset ? probe.end_offset : size;
+        bool free_format = probe.free_format_bytes != 0;
+        mp3dec_ex_close(&probe);
+
+        if (free_format || hz_ <= 0 || channels_ < 1 || channels_ > 2 || start_offset >= end_offset_)
+            return false;
+
+        data_ = data;
+        index_frames_(start_offset);
+        if (frames_.size() <= MP3_RANGE_FRAMES) {
+            frames_.clear();
+            return false;
+        }
+
+        num_ranges_ = (frames_.size() + MP3_RANGE_FRAMES - 1) / MP3_RANGE_FRAMES;
+        next_range_ = 0;
+        returned_ = 0;
+        failed_ = false;
+        stop_ = false;
+        lookahead_ = std::max(1, num_threads) * MP3_LOOKAHEAD_PER_THREAD;
+        schedule_();
+        for (int i = 0; i < std::max(1, num_threads); i++) {
+            workers_.emplace_back(&Impl::loop_, this);
+        }
+        ALOGD("Parallel mp3: %zu frames, %d ranges, %d threads", frames_.size(), num_ranges_, num_threads);
+        return true;
+    }
+
+    void close(void) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+        window_.clear();
+        frames_.clear();
+    }
+
+    bool read(std::vector<float>& mono) {
+        mono.clear();
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (failed_ || window_.empty())
+            return false;
+
+        // A failed range ahead of the reader doesn't spoil the ones before it
+        done_cond_.wait(lock, [this] { return window_.front()->state == RANGE_DONE; });
+        if (window_.front()->failed) {
+            failed_ = true;
+            lock.unlock();
+            cond_.notify_all();
+            return false;
+        }
+
+        mono.swap(window_.front()->mono);
+        window_.pop_front();
+        schedule_();
+        lock.unlock();
+        cond_.notify_all();
+
+        // The tag's sample count cuts the encoder padding off the end
+        if (detected_samples_ > 0) {
+            uint64_t limit = detected_samples_ / channels_;
+            if (returned_ + mono.size() > limit)
+                mono.resize(limit > returned_ ? limit - returned_ : 0);
+        }
+        returned_ += mono.size();
+        return true;
+    }
+
+    inline bool failed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return failed_;
+    }
+
+    inline int get_sample_rate() const {
+        return hz_;
+    }
+
+    inline int get_channels() const {
+        return channels_;
+    }
+
+private:
+    struct Frame {
+        uint64_t offset;
+        int bytes;              // up to the next frame, skipped garbage included
+        int samples;            // per channel
+    };
+
+    enum RangeState {
+        RANGE_PENDING,
+        RANGE_RUNNING,
+        RANGE_DONE,
+    };
+
+    struct Range {
+        int index;
+        RangeState state = RANGE_PENDING;
+        bool failed = false;
+        std::vector<float> mono;
+    };
+
+    // Walk the frames the way mp3dec_ex_read_frame does, header only. The
+    // decoder's sync search is stricter than mp3dec_iterate_buf, which
+    // drops the frames before a tag in the middle of the stream.
+    void index_frames_(uint64_t offset) {
+        frames_.clear();
+        mp3dec_t scan;
+        mp3dec_init(&scan);
+        while (offset < end_offset_) {
+            mp3dec_frame_info_t info;
+            const uint8_t* buf = data_ + offset;
+            mp3dec_decode_frame(&scan, buf, (int)std::min<uint64_t>(end_offset_ - offset, INT_MAX), nullptr, &info);
+            if (!info.frame_bytes)
+                break;
+
+            Frame frame;
+            frame.offset = offset;
+            frame.bytes = info.frame_bytes;
+            // hdr_frame_samples() of the bytes at offset, used to count the
+            // encoder delay of frames that decode to nothing
+            frame.samples = (buf[1] & 6) == 6 ? 384 : ((buf[1] & 14) == 2 ? 576 : 1152);
+            frames_.push_back(frame);
+            offset += info.frame_bytes;
+        }
+    }
+
+    // Call with mutex_ held, keeps lookahead_ ranges queued or decoded
+    void schedule_(void) {
+        while ((int)window_.size() < lookahead_ && next_range_ < num_ranges_) {
+            auto range = std::make_shared<Range>();
+            range->index = next_range_++;
+            window_.push_back(range);
+        }
+    }
+
+    void loop_(void) {
+        std::vector<float> pcm(MINIMP3_MAX_SAMPLES_PER_FRAME);
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            std::shared_ptr<Range> range;
+            cond_.wait(lock, [this, &range] {
+                if (stop_ || failed_)
+                    return true;
+                for (auto& r : window_) {
+                    if (r->state == RANGE_PENDING) {
+                        range = r;
+                        return true;
+                    }
+                }
+                return false;
+            });
+            if (stop_ || failed_)
+                break;
+
+            range->state = RANGE_RUNNING;
+            lock.unlock();
+            bool ok = decode_(range->index, pcm, range->mono);
+            lock.lock();
+
+            range->failed = !ok;
+            range->state = RANGE_DONE;
+            done_cond_.notify_all();
+        }
+    }
+
+    // Runs without the lock, only reads the frame index
+    bool decode_(int index, std::vector<float>& pcm, std::vector<float>& mono) const {
+        const int first = index * MP3_RANGE_FRAMES;
+        const int last = std::min<int>(first + MP3_RANGE_FRAMES, frames_.size());
+        mono.clear();
+        mono.reserve((size_t)(last - first) * 1152);
+
+        mp3dec_t dec;
+        mp3dec_init(&dec);
+        // The serial decoder skips the encoder delay at the start of the
+        // stream, counted in interleaved samples
+        int to_skip = index == 0 ? start_delay_ : 0;
+        // Kept across frames like mp3dec_ex, a trailing chunk without a
+        // frame leaves it as it was
+        mp3dec_frame_info_t info;
+        memset(&info, 0, sizeof(info));
+        info.hz = hz_;
+        info.layer = layer_;
+        for (int f = std::max(0, first - MP3_WARMUP_FRAMES); f < last; f++) {
+            const uint8_t* buf = data_ + frames_[f].offset;
+            uint64_t buf_size = end_offset_ - frames_[f].offset;
+            int samples = mp3dec_decode_frame(&dec, buf, (int)std::min<uint64_t>(buf_size, INT_MAX), pcm.data(), &info);
+            if (f < first)
+                continue;
+
+            if (info.frame_bytes != frames_[f].bytes) {
+                ALOGE("mp3 frame %d decoded as %d bytes, indexed as %d", f, info.frame_bytes, frames_[f].bytes);
+                return false;
+            }
+            if (info.hz != hz_ || info.layer != layer_) {
+                ALOGE("mp3 format changes at frame %d", f);
+                return false;
+            }
+            if (samples == 0) {
+                // Frames the decoder cannot start from still count as delay
+                if (to_skip)
+                    to_skip -= std::min(frames_[f].samples * info.channels, to_skip);
+                continue;
+            }
+
+            int total = samples * info.channels;
+            int consumed = 0;
+            if (to_skip) {
+                consumed = std::min(total, to_skip);
+                to_skip -= consumed;
+            }
+            if (consumed != total && info.channels != channels_) {
+                ALOGE("mp3 channels change at frame %d", f);
+                return false;
+            }
+            // Same mixdown as AudioReader
+            if (channels_ == 1) {
+                mono.insert(mono.end(), pcm.begin() + consumed, pcm.begin() + total);
+            } else {
+                for (int i = consumed; i + 1 < total; i += 2) {
+                    mono.push_back((pcm[i] + pcm[i + 1]) / 2.0f);
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    uint64_t end_offset_ = 0;
+    int hz_ = 0;
+    int layer_ = 0;
+    int channels_ = 0;
+    int start_delay_ = 0;
+    uint64_t detected_samples_ = 0;
+    std::vector<Frame> frames_;
+
+    int num_ranges_ = 0;
+    int lookahead_ = 0;
+    uint64_t returned_ = 0;         // mono samples returned by read()
+
+    // Shared with the workers
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;          // a range to decode, or stop
+    std::condition_variable done_cond_;     // a range has been decoded
+    std::deque<std::shared_ptr<Range>> window_;
+    int next_range_ = 0;
+    bool failed_ = false;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
+
+ParallelMp3Decoder::ParallelMp3Decoder():
+    impl_(std::make_unique<ParallelMp3Decoder::Impl>()) {
+
+}
+
+ParallelMp3Decoder::~ParallelMp3Decoder() = default;
+
+bool ParallelMp3Decoder::open(const uint8_t* data, size_t size, int num_threads) {
+    return impl_->open(data, size, num_threads);
+}
+
+void ParallelMp3Decoder::close() {
+    impl_->close();
+}
+
+bool ParallelMp3Decoder::read(std::vector<float>& mono) {
+    return impl_->read(mono);
+}
+
+bool ParallelMp3Decoder::failed() const {
+    return impl_->failed();
+}
+
+int ParallelMp3Decoder::get_sample_rate() const {
+    return impl_->get_sample_rate();
+}
+
+int ParallelMp3Decoder::get_channels() const {
+    return impl_->get_channels();
+}
+
+} // namespace utils
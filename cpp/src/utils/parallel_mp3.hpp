@@ -0,0 +1,55 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace utils {
+
+// Decode an mp3 held in memory on several threads, mixed down to mono.
+//
+// Frame offsets are indexed in one header-only scan, the frames are split
+// into ranges and each range is decoded by its own mp3dec_t, starting a
+// few frames early so the bit reservoir and the synthesis state are filled
+// when the range begins. The warm-up output is dropped, so the samples
+// returned by read() are the same as those of a serial mp3dec_ex decode,
+// including the encoder delay and padding given by a LAME/Xing tag.
+//
+// Ranges are decoded a bounded number ahead of the reader, memory does not
+// grow with the file length.
+class ParallelMp3Decoder {
+public:
+    ParallelMp3Decoder();
+    ~ParallelMp3Decoder();
+
+    // data must stay valid until close(). Fails for streams that cannot be
+    // split (free format, fewer frames than one range), use mp3dec_ex for
+    // those.
+    bool open(const uint8_t* data, size_t size, int num_threads);
+    void close();
+
+    // Replace mono with the next range of samples in file order. Returns
+    // false once everything has been returned, or on a decode error, see
+    // failed().
+    bool read(std::vector<float>& mono);
+    bool failed() const;
+
+    int get_sample_rate() const;
+    int get_channels() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace utils
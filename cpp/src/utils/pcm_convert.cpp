@@ -0,0 +1,54 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#include <cstdint>
+#include <cstring>
+
+#include "utils/pcm_convert.hpp"
+#include "utils/simd.hpp"
+
+// Scaling by a power of two is exact, so the vector paths give the same
+// floats as s / 32768.0f and (l + r) / 2
+#define S16_SCALE   (1.0f / 32768.0f)
+
+namespace utils {
+
+void s16_to_f32(const int16_t* pcm, size_t n, float scale, float* out) {
+    s16_scale_f32(reinterpret_cast<const uint8_t*>(pcm), n, scale, out);
+}
+
+void s16_to_mono(const void* pcm, size_t frames, int channels, float* out) {
+    const uint8_t* p = static_cast<const uint8_t*>(pcm);
+    if (channels == 1) {
+        s16_scale_f32(p, frames, S16_SCALE, out);
+    } else if (channels == 2) {
+        s16x2_mix_f32(p, frames, S16_SCALE, out);
+    } else {
+        const size_t stride = (size_t)channels * 2;
+        for (size_t i = 0; i < frames; i++) {
+            out[i] = load_s16(p + i * stride) * S16_SCALE;
+        }
+    }
+}
+
+void f32_to_mono(const void* pcm, size_t frames, int channels, float* out) {
+    const uint8_t* p = static_cast<const uint8_t*>(pcm);
+    if (channels == 1) {
+        memcpy(out, p, frames * sizeof(float));
+    } else if (channels == 2) {
+        f32x2_mix_f32(p, frames, out);
+    } else {
+        const size_t stride = (size_t)channels * 4;
+        for (size_t i = 0; i < frames; i++) {
+            out[i] = load_f32(p + i * stride);
+        }
+    }
+}
+
+} // namespace utils
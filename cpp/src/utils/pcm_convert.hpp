@@ -0,0 +1,31 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace utils {
+
+// Interleaved little-endian PCM to mono float in one pass: stereo is
+// averaged, more channels keep the first one, the same as AudioLoader.
+// pcm needs no alignment, e.g. the data chunk of a mapped wav file.
+
+// 16 bit signed, scaled by 1/32768
+void s16_to_mono(const void* pcm, size_t frames, int channels, float* out);
+
+// 32 bit float, copied as is
+void f32_to_mono(const void* pcm, size_t frames, int channels, float* out);
+
+// Mono 16 bit samples times scale: 1/32768 for [-1.0, 1.0], 1 for the
+// int16 range fbank works in
+void s16_to_f32(const int16_t* pcm, size_t n, float scale, float* out);
+
+} // namespace utils
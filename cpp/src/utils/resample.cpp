@@ -21,11 +21,18 @@
  */
 #include "utils/resample.h"
 #include "utils/logger.h"
+#include "utils/pcm_convert.hpp"
+#include "utils/simd.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 #include <memory>
@@ -38,6 +45,9 @@
 #define M_PI 3.1415926535897932384626433832795
 #endif
 
+// Filter banks kept for reuse; a process sees a handful of rate pairs
+#define RESAMPLE_MAX_CACHED_FILTERS 16
+
 namespace utils {
 
 template <class I>
@@ -72,14 +82,31 @@ static I Lcm(I m, I n) {
   return gcd * (m / gcd) * (n / gcd);
 }
 
-static float DotProduct(const float *a, const float *b, int32_t n) {
-  float sum = 0;
-  for (int32_t i = 0; i != n; ++i) {
-    sum += a[i] * b[i];
-  }
-  return sum;
+// Rows of weights are padded to a multiple of 4 floats with zeros, but the
+// input is not, so only n elements are read from a and b.
+static inline float DotProduct(const float *a, const float *b, int32_t n) {
+  return utils::dot_f32(a, b, n);
 }
 
+/// For each output-sample index within a unit: the first input-sample index
+/// that we sum over (may be negative; any truncation at the beginning is
+/// handled separately) and the weights on the input samples from there.
+/// This is just for the first few output samples, but we can extrapolate
+/// the correct input-sample index for arbitrary output samples.
+struct LinearResample::FilterBank {
+  std::vector<int32_t> first_index;
+  std::vector<int32_t> num_weights;
+  int32_t stride = 0;          ///< floats between rows of weights
+  std::vector<float> weights;  ///< all rows, contiguous
+
+  const float *Row(int32_t i) const { return weights.data() + (size_t)i * stride; }
+};
+
+typedef std::tuple<int32_t, int32_t, float, int32_t> FilterKey;
+
+static std::mutex filter_cache_mutex;
+static std::map<FilterKey, std::shared_ptr<const LinearResample::FilterBank>> filter_cache;
+
 LinearResample::LinearResample(int32_t samp_rate_in_hz,
                                int32_t samp_rate_out_hz, float filter_cutoff_hz,
                                int32_t num_zeros)
@@ -97,16 +124,33 @@ LinearResample::LinearResample(int32_t samp_rate_in_hz,
   input_samples_in_unit_ = samp_rate_in_ / base_freq;
   output_samples_in_unit_ = samp_rate_out_ / base_freq;
 
-  SetIndexesAndWeights();
+  FilterKey key(samp_rate_in_, samp_rate_out_, filter_cutoff_, num_zeros_);
+  {
+    std::lock_guard<std::mutex> lock(filter_cache_mutex);
+    auto it = filter_cache.find(key);
+    if (it != filter_cache.end()) filter_ = it->second;
+  }
+  if (!filter_) {
+    // Computed outside the lock; two threads may both build the same bank,
+    // the first one stored wins
+    auto filter = std::make_shared<FilterBank>();
+    SetIndexesAndWeights(filter.get());
+    filter_ = filter;
+    std::lock_guard<std::mutex> lock(filter_cache_mutex);
+    if (filter_cache.size() < RESAMPLE_MAX_CACHED_FILTERS)
+      filter_ = filter_cache.emplace(key, filter_).first->second;
+  }
   Reset();
 }
 
-void LinearResample::SetIndexesAndWeights() {
-  first_index_.resize(output_samples_in_unit_);
-  weights_.resize(output_samples_in_unit_);
+void LinearResample::SetIndexesAndWeights(FilterBank *filter) const {
+  filter->first_index.resize(output_samples_in_unit_);
+  filter->num_weights.resize(output_samples_in_unit_);
 
   double window_width = num_zeros_ / (2.0 * filter_cutoff_);
 
+  // Rows differ by at most one weight, size them all for the longest
+  int32_t max_weights = 0;
   for (int32_t i = 0; i < output_samples_in_unit_; i++) {
     double output_t = i / static_cast<double>(samp_rate_out_);
     double min_t = output_t - window_width, max_t = output_t + window_width;
@@ -120,14 +164,22 @@ void LinearResample::SetIndexesAndWeights() {
     int32_t min_input_index = ceil(min_t * samp_rate_in_),
             max_input_index = floor(max_t * samp_rate_in_),
             num_indices = max_input_index - min_input_index + 1;
-    first_index_[i] = min_input_index;
-    weights_[i].resize(num_indices);
-    for (int32_t j = 0; j < num_indices; j++) {
-      int32_t input_index = min_input_index + j;
+    filter->first_index[i] = min_input_index;
+    filter->num_weights[i] = num_indices;
+    max_weights = std::max(max_weights, num_indices);
+  }
+  filter->stride = (max_weights + 3) & ~3;
+  filter->weights.assign((size_t)filter->stride * output_samples_in_unit_, 0.0f);
+
+  for (int32_t i = 0; i < output_samples_in_unit_; i++) {
+    double output_t = i / static_cast<double>(samp_rate_out_);
+    float *weights = filter->weights.data() + (size_t)i * filter->stride;
+    for (int32_t j = 0; j < filter->num_weights[i]; j++) {
+      int32_t input_index = filter->first_index[i] + j;
       double input_t = input_index / static_cast<double>(samp_rate_in_),
              delta_t = input_t - output_t;
       // sign of delta_t doesn't matter.
-      weights_[i][j] = FilterFunc(delta_t) / samp_rate_in_;
+      weights[j] = FilterFunc(delta_t) / samp_rate_in_;
     }
   }
 }
@@ -167,34 +219,41 @@ void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
 
   output->resize(tot_output_samp - output_sample_offset_);
 
+  const FilterBank &filter = *filter_;
+  // The unit and the index within it are stepped along rather than divided
+  // out for every sample; with an integer ratio such as 48k->16k or
+  // 8k->16k there are only one or two rows of weights.
+  int64_t first_samp_in = 0;
+  int32_t samp_out_wrapped = 0;
+  GetIndexes(output_sample_offset_, &first_samp_in, &samp_out_wrapped);
+  int64_t unit_first_samp_in = first_samp_in - filter.first_index[samp_out_wrapped];
+  std::vector<float> window;
+
   // samp_out is the index into the total output signal, not just the part
   // of it we are producing here.
   for (int64_t samp_out = output_sample_offset_; samp_out < tot_output_samp;
        samp_out++) {
-    int64_t first_samp_in = 0;
-    int32_t samp_out_wrapped = 0;
-    GetIndexes(samp_out, &first_samp_in, &samp_out_wrapped);
-    const std::vector<float> &weights = weights_[samp_out_wrapped];
+    const float *weights = filter.Row(samp_out_wrapped);
+    int32_t num_weights = filter.num_weights[samp_out_wrapped];
+    first_samp_in = unit_first_samp_in + filter.first_index[samp_out_wrapped];
     // first_input_index is the first index into "input" that we have a weight
     // for.
     int32_t first_input_index =
         static_cast<int32_t>(first_samp_in - input_sample_offset_);
     float this_output = 0;
-    if (first_input_index >= 0 &&
-        first_input_index + static_cast<int32_t>(weights.size()) <= input_dim) {
-      this_output =
-          DotProduct(input + first_input_index, weights.data(), weights.size());
+    if (first_input_index >= 0 && first_input_index + num_weights <= input_dim) {
+      this_output = DotProduct(input + first_input_index, weights, num_weights);
     } else {  // Handle edge cases.
-      this_output = 0.0;
-      for (int32_t i = 0; i < static_cast<int32_t>(weights.size()); i++) {
-        float weight = weights[i];
+      // Gather the window and use the same DotProduct, so a signal gives the
+      // same output whether or not it is processed a piece at a time.
+      window.assign(num_weights, 0.0f);
+      for (int32_t i = 0; i < num_weights; i++) {
         int32_t input_index = first_input_index + i;
         if (input_index < 0 &&
             static_cast<int32_t>(input_remainder_.size()) + input_index >= 0) {
-          this_output +=
-              weight * input_remainder_[input_remainder_.size() + input_index];
+          window[i] = input_remainder_[input_remainder_.size() + input_index];
         } else if (input_index >= 0 && input_index < input_dim) {
-          this_output += weight * input[input_index];
+          window[i] = input[input_index];
         } else if (input_index >= input_dim) {
           // We're past the end of the input and are adding zero; should only
           // happen if the user specified flush == true, or else we would not
@@ -202,10 +261,16 @@ void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
           assert(flush);
         }
       }
+      this_output = DotProduct(window.data(), weights, num_weights);
     }
     int32_t output_index =
         static_cast<int32_t>(samp_out - output_sample_offset_);
     (*output)[output_index] = this_output;
+
+    if (++samp_out_wrapped == output_samples_in_unit_) {
+      samp_out_wrapped = 0;
+      unit_first_samp_in += input_samples_in_unit_;
+    }
   }
 
   if (flush) {
@@ -274,8 +339,8 @@ void LinearResample::GetIndexes(int64_t samp_out, int64_t *first_samp_in,
   // samp_out_wrapped is equal to samp_out % output_samples_in_unit_
   *samp_out_wrapped =
       static_cast<int32_t>(samp_out - unit_index * output_samples_in_unit_);
-  *first_samp_in =
-      first_index_[*samp_out_wrapped] + unit_index * input_samples_in_unit_;
+  *first_samp_in = filter_->first_index[*samp_out_wrapped] +
+                   unit_index * input_samples_in_unit_;
 }
 
 void LinearResample::SetRemainder(const float *input, int32_t input_dim) {
@@ -306,21 +371,52 @@ void LinearResample::SetRemainder(const float *input, int32_t input_dim) {
 }
 
 std::vector<float> resample(const std::vector<float>& audio_data, int orig_sr, int target_sr) {
+    if (orig_sr == target_sr)
+        return audio_data;
+    std::vector<float> resampled_data;
+    resample(audio_data.data(), audio_data.size(), orig_sr, target_sr, resampled_data);
+    return resampled_data;
+}
+
+void resample(const float* audio_data, size_t num_samples, int orig_sr, int target_sr, std::vector<float>& out) {
     if (orig_sr != target_sr) {
         ALOGD("Audio resample: %d -> %d", orig_sr, target_sr);
-        std::vector<float> resampled_data;
         float min_freq = std::min<int32_t>(orig_sr, target_sr);
         float lowpass_cutoff = 0.99 * 0.5 * min_freq;
 
         int32_t lowpass_filter_width = 6;
-        auto resampler = std::make_unique<LinearResample>(
-            orig_sr, target_sr, lowpass_cutoff,
-            lowpass_filter_width);
-
-        resampler->Resample(audio_data.data(), audio_data.size(), true, &resampled_data);
-        return resampled_data;
+        LinearResample resampler(orig_sr, target_sr, lowpass_cutoff, lowpass_filter_width);
+        resampler.Resample(audio_data, num_samples, true, &out);
     } else {
-        return audio_data;
+        out.assign(audio_data, audio_data + num_samples);
+    }
+}
+
+void resample_s16(const int16_t* pcm, size_t num_samples, int orig_sr, int target_sr, std::vector<float>& out) {
+    if (orig_sr == target_sr) {
+        out.resize(num_samples);
+        s16_to_f32(pcm, num_samples, 1.0f / 32768.0f, out.data());
+        return;
+    }
+
+    ALOGD("Audio resample: %d -> %d", orig_sr, target_sr);
+    float min_freq = std::min<int32_t>(orig_sr, target_sr);
+    float lowpass_cutoff = 0.99 * 0.5 * min_freq;
+
+    int32_t lowpass_filter_width = 6;
+    LinearResample resampler(orig_sr, target_sr, lowpass_cutoff, lowpass_filter_width);
+
+    // A resampler fed piece by piece gives the same output as one call
+    const size_t block = 4096;
+    float converted[block];
+    std::vector<float> piece;
+    out.clear();
+    out.reserve(num_samples * (size_t)target_sr / orig_sr + 1);
+    for (size_t i = 0; i < num_samples; i += block) {
+        size_t n = std::min(block, num_samples - i);
+        s16_to_f32(pcm + i, n, 1.0f / 32768.0f, converted);
+        resampler.Resample(converted, (int32_t)n, i + n >= num_samples, &piece);
+        out.insert(out.end(), piece.begin(), piece.end());
     }
 }
 
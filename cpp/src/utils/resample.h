@@ -22,6 +22,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace utils {
@@ -33,12 +34,18 @@ namespace utils {
 
 class LinearResample {
  public:
+  /// Filter weights of one (input rate, output rate, cutoff, num_zeros),
+  /// shared by every resampler with the same parameters.
+  struct FilterBank;
+
   /// Constructor.  We make the input and output sample rates integers, because
   /// we are going to need to find a common divisor.  This should just remind
   /// you that they need to be integers.  The filter cutoff needs to be less
   /// than samp_rate_in_hz/2 and less than samp_rate_out_hz/2.  num_zeros
   /// controls the sharpness of the filter, more == sharper but less efficient.
   /// We suggest around 4 to 10 for normal use.
+  /// The weights are computed once per parameter set and cached, so
+  /// constructing a resampler for a rate pair seen before is cheap.
   LinearResample(int32_t samp_rate_in_hz, int32_t samp_rate_out_hz,
                  float filter_cutoff_hz, int32_t num_zeros);
 
@@ -75,7 +82,7 @@ class LinearResample {
   int32_t GetOutputSamplingRate() const { return samp_rate_out_; }
 
  private:
-  void SetIndexesAndWeights();
+  void SetIndexesAndWeights(FilterBank *filter) const;
 
   float FilterFunc(float) const;
 
@@ -91,7 +98,7 @@ class LinearResample {
 
   /// Given an output-sample index, this function outputs to *first_samp_in the
   /// first input-sample index that we have a weight on (may be negative),
-  /// and to *samp_out_wrapped the index into weights_ where we can get the
+  /// and to *samp_out_wrapped the row of filter_ where we can get the
   /// corresponding weights on the input.
   inline void GetIndexes(int64_t samp_out, int64_t *first_samp_in,
                          int32_t *samp_out_wrapped) const;
@@ -115,14 +122,9 @@ class LinearResample {
                                     ///< = samp_rate_out_hz /
                                     ///< Gcd(samp_rate_in_hz, samp_rate_out_hz)
 
-  /// The first input-sample index that we sum over, for this output-sample
-  /// index.  May be negative; any truncation at the beginning is handled
-  /// separately.  This is just for the first few output samples, but we can
-  /// extrapolate the correct input-sample index for arbitrary output samples.
-  std::vector<int32_t> first_index_;
-
-  /// Weights on the input samples, for this output-sample index.
-  std::vector<std::vector<float>> weights_;
+  /// First input-sample index and weights for each output-sample index of a
+  /// unit, see FilterBank in resample.cpp.
+  std::shared_ptr<const FilterBank> filter_;
 
   // the following variables keep track of where we are in a particular signal,
   // if it is being provided over multiple calls to Resample().
@@ -138,4 +140,12 @@ class LinearResample {
 
 std::vector<float> resample(const std::vector<float>& audio_data, int orig_sr, int target_sr);
 
+// Replace out with num_samples of audio_data at target_sr. Resampled straight
+// into out, or copied once if the rates match.
+void resample(const float* audio_data, size_t num_samples, int orig_sr, int target_sr, std::vector<float>& out);
+
+// Same for 16 bit PCM, out is in [-1.0, 1.0]. Converted block by block on
+// the way into the resampler, so no float copy of the input is made.
+void resample_s16(const int16_t* pcm, size_t num_samples, int orig_sr, int target_sr, std::vector<float>& out);
+
 } // namespace utils
\ No newline at end of file
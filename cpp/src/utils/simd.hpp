@@ -0,0 +1,248 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+// Small float kernels used on the feature and audio paths.
+// NEON when HAVE_NEON is set by cmake/detect_neon.cmake, SSE2 for x86 host
+// builds without it, plain loops otherwise. This is the only place vector
+// paths are selected.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(HAVE_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#ifndef HAVE_SSE2
+#define HAVE_SSE2 1
+#endif
+#endif
+
+namespace utils {
+
+// y[i] = x[i] * scale[i] + bias[i]
+inline void affine_f32(const float* x, const float* scale, const float* bias, float* y, int n) {
+    int i = 0;
+#if defined(HAVE_NEON)
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a0 = vld1q_f32(x + i);
+        float32x4_t a1 = vld1q_f32(x + i + 4);
+        float32x4_t r0 = vmlaq_f32(vld1q_f32(bias + i), a0, vld1q_f32(scale + i));
+        float32x4_t r1 = vmlaq_f32(vld1q_f32(bias + i + 4), a1, vld1q_f32(scale + i + 4));
+        vst1q_f32(y + i, r0);
+        vst1q_f32(y + i + 4, r1);
+    }
+#endif
+    for (; i < n; i++) {
+        y[i] = x[i] * scale[i] + bias[i];
+    }
+}
+
+// y[i] = x[i] * s
+inline void scale_f32(const float* x, float s, float* y, int n) {
+    int i = 0;
+#if defined(HAVE_NEON)
+    float32x4_t vs = vdupq_n_f32(s);
+    for (; i + 8 <= n; i += 8) {
+        vst1q_f32(y + i, vmulq_f32(vld1q_f32(x + i), vs));
+        vst1q_f32(y + i + 4, vmulq_f32(vld1q_f32(x + i + 4), vs));
+    }
+#endif
+    for (; i < n; i++) {
+        y[i] = x[i] * s;
+    }
+}
+
+// Index of the largest element, the first one on ties like std::max_element.
+// n must be positive.
+inline int argmax_f32(const float* x, int n) {
+    int i = 1;
+    int best = 0;
+    float best_value = x[0];
+#if defined(HAVE_NEON)
+    if (n >= 8) {
+        // Per lane running max and the index it was seen at, a strict
+        // compare keeps the earliest index within each lane
+        static const uint32_t kLaneIndex[4] = {0, 1, 2, 3};
+        float32x4_t vmax = vld1q_f32(x);
+        uint32x4_t vidx = vld1q_u32(kLaneIndex);
+        uint32x4_t vcur = vidx;
+        const uint32x4_t vstep = vdupq_n_u32(4);
+        for (i = 4; i + 4 <= n; i += 4) {
+            vcur = vaddq_u32(vcur, vstep);
+            float32x4_t v = vld1q_f32(x + i);
+            uint32x4_t gt = vcgtq_f32(v, vmax);
+            vmax = vbslq_f32(gt, v, vmax);
+            vidx = vbslq_u32(gt, vcur, vidx);
+        }
+
+        float lane_max[4];
+        uint32_t lane_idx[4];
+        vst1q_f32(lane_max, vmax);
+        vst1q_u32(lane_idx, vidx);
+        best_value = lane_max[0];
+        best = lane_idx[0];
+        for (int k = 1; k < 4; k++) {
+            if (lane_max[k] > best_value || (lane_max[k] == best_value && (int)lane_idx[k] < best)) {
+                best_value = lane_max[k];
+                best = lane_idx[k];
+            }
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (x[i] > best_value) {
+            best_value = x[i];
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Sum of a[i] * b[i], no alignment needed
+inline float dot_f32(const float* a, const float* b, int n) {
+    int i = 0;
+#if defined(HAVE_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0), acc1 = vdupq_n_f32(0);
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    if (i + 4 <= n) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        i += 4;
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    float sum = vget_lane_f32(vpadd_f32(half, half), 0);
+#elif defined(HAVE_SSE2)
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    if (i + 4 <= n) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        i += 4;
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+    float sum = 0;
+#endif
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// The PCM kernels read interleaved little-endian samples from p, which needs
+// no alignment, e.g. the data chunk of a mapped wav file
+
+inline int16_t load_s16(const uint8_t* p) {
+    int16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline float load_f32(const uint8_t* p) {
+    float v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// out[i] = s16[i] * scale, mono
+inline void s16_scale_f32(const uint8_t* p, size_t n, float scale, float* out) {
+    size_t i = 0;
+#if defined(HAVE_NEON)
+    const float32x4_t vs = vdupq_n_f32(scale);
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t s = vreinterpretq_s16_u8(vld1q_u8(p + i * 2));
+        vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), vs));
+        vst1q_f32(out + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), vs));
+    }
+#elif defined(HAVE_SSE2)
+    const __m128 vs = _mm_set1_ps(scale);
+    for (; i + 8 <= n; i += 8) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 2));
+        // Sign extend by moving each sample to the top half and shifting back
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vs));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vs));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = load_s16(p + i * 2) * scale;
+    }
+}
+
+// out[i] = (l[i] * scale + r[i] * scale) / 2, 16 bit stereo
+inline void s16x2_mix_f32(const uint8_t* p, size_t frames, float scale, float* out) {
+    size_t i = 0;
+#if defined(HAVE_NEON)
+    const float32x4_t vs = vdupq_n_f32(scale);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (; i + 8 <= frames; i += 8) {
+        uint8x16x2_t bytes = {{vld1q_u8(p + i * 4), vld1q_u8(p + i * 4 + 16)}};
+        int16x8x2_t lr = vuzpq_s16(vreinterpretq_s16_u8(bytes.val[0]), vreinterpretq_s16_u8(bytes.val[1]));
+        float32x4_t l0 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(lr.val[0]))), vs);
+        float32x4_t r0 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(lr.val[1]))), vs);
+        float32x4_t l1 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(lr.val[0]))), vs);
+        float32x4_t r1 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(lr.val[1]))), vs);
+        vst1q_f32(out + i, vmulq_f32(vaddq_f32(l0, r0), half));
+        vst1q_f32(out + i + 4, vmulq_f32(vaddq_f32(l1, r1), half));
+    }
+#elif defined(HAVE_SSE2)
+    const __m128 vs = _mm_set1_ps(scale);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= frames; i += 4) {
+        // One frame per 32 bit lane, left in the low half
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 4));
+        __m128i l = _mm_srai_epi32(_mm_slli_epi32(s, 16), 16);
+        __m128i r = _mm_srai_epi32(s, 16);
+        __m128 sum = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(l), vs), _mm_mul_ps(_mm_cvtepi32_ps(r), vs));
+        _mm_storeu_ps(out + i, _mm_mul_ps(sum, half));
+    }
+#endif
+    for (; i < frames; i++) {
+        out[i] = (load_s16(p + i * 4) * scale + load_s16(p + i * 4 + 2) * scale) / 2;
+    }
+}
+
+// out[i] = (l[i] + r[i]) / 2, float stereo
+inline void f32x2_mix_f32(const uint8_t* p, size_t frames, float* out) {
+    size_t i = 0;
+#if defined(HAVE_NEON)
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t lr = vuzpq_f32(vreinterpretq_f32_u8(vld1q_u8(p + i * 8)),
+                                     vreinterpretq_f32_u8(vld1q_u8(p + i * 8 + 16)));
+        vst1q_f32(out + i, vmulq_f32(vaddq_f32(lr.val[0], lr.val[1]), half));
+    }
+#elif defined(HAVE_SSE2)
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(reinterpret_cast<const float*>(p + i * 8));
+        __m128 b = _mm_loadu_ps(reinterpret_cast<const float*>(p + i * 8 + 16));
+        __m128 l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(l, r), half));
+    }
+#endif
+    for (; i < frames; i++) {
+        out[i] = (load_f32(p + i * 8) + load_f32(p + i * 8 + 4)) / 2;
+    }
+}
+
+} // namespace utils
@@ -0,0 +1,84 @@
+/**************************************************************************************************
+ *
+ * Copyright (c) 2019-2026 Axera Semiconductor (Ningbo) Co., Ltd. All Rights Reserved.
+ *
+ * This source file is the property of Axera Semiconductor (Ningbo) Co., Ltd. and
+ * may not be copied or distributed in any isomorphic form without the prior
+ * written consent of Axera Semiconductor (Ningbo) Co., Ltd.
+ *
+ **************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace utils {
+
+// Lock-free single producer / single consumer ring buffer.
+// push() must only be called from one thread and pop() from another one.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        buffer_.resize(n);
+        mask_ = n - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // All or nothing, returns false if there is not enough free space
+    bool push(const T* data, size_t n) {
+        return push(data, n, [](const T& v) { return v; });
+    }
+
+    // Same, each element goes through convert on its way into the ring
+    template <typename U, typename Convert>
+    bool push(const U* data, size_t n, Convert convert) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        if (n > capacity() - (tail - head))
+            return false;
+
+        for (size_t i = 0; i < n; i++) {
+            buffer_[(tail + i) & mask_] = convert(data[i]);
+        }
+        tail_.store(tail + n, std::memory_order_release);
+        return true;
+    }
+
+    // Append everything available to out, returns number of elements popped
+    size_t pop(std::vector<T>& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t n = tail - head;
+        if (n == 0)
+            return 0;
+
+        out.reserve(out.size() + n);
+        for (size_t i = 0; i < n; i++) {
+            out.push_back(buffer_[(head + i) & mask_]);
+        }
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    inline size_t capacity() const {
+        return mask_ + 1;
+    }
+
+private:
+    std::vector<T> buffer_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+} // namespace utils
@@ -0,0 +1,133 @@
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "utils/cmdline.hpp"
+#include "utils/AudioLoader.hpp"
+#include "asr/lfr_frontend.hpp"
+#include "kaldi-native-fbank/csrc/online-feature.h"
+
+// Zipformer features from LfrFrontend, fed in chunks, against a
+// kaldi-native-fbank reference set up the way icefall extracts them
+// (kaldifeat FbankOptions defaults, waveform in [-1, 1])
+
+static std::vector<float> reference_fbank(const std::vector<float>& audio, int n_mels, int& num_frames) {
+    knf::FbankOptions opts;
+    opts.frame_opts.samp_freq = 16000;
+    opts.frame_opts.dither = 0.0f;
+    opts.frame_opts.snip_edges = false;
+    opts.frame_opts.window_type = "povey";
+    opts.mel_opts.num_bins = n_mels;
+    opts.mel_opts.low_freq = 20;
+    opts.mel_opts.high_freq = -400;
+
+    knf::OnlineFbank fbank(opts);
+    fbank.AcceptWaveform(16000, audio.data(), audio.size());
+    fbank.InputFinished();
+
+    num_frames = fbank.NumFramesReady();
+    std::vector<float> feats;
+    feats.reserve((size_t)num_frames * n_mels);
+    for (int i = 0; i < num_frames; i++) {
+        const float* f = fbank.GetFrame(i);
+        feats.insert(feats.end(), f, f + n_mels);
+    }
+    return feats;
+}
+
+static std::vector<float> frontend_fbank(const std::vector<float>& audio, const std::vector<int16_t>& pcm_s16,
+                                         int n_mels, int chunk_samples) {
+    LfrFrontend frontend(icefall_frontend_config(n_mels));
+    std::vector<float> feats;
+    int n_samples = pcm_s16.empty() ? (int)audio.size() : (int)pcm_s16.size();
+    for (int offset = 0; offset < n_samples; offset += chunk_samples) {
+        int n = std::min(chunk_samples, n_samples - offset);
+        if (pcm_s16.empty())
+            frontend.accept_waveform(audio.data() + offset, n, 16000);
+        else
+            frontend.accept_waveform_s16(pcm_s16.data() + offset, n, 16000);
+        frontend.pop_frames(feats);
+    }
+    frontend.input_finished();
+    frontend.pop_frames(feats);
+    return feats;
+}
+
+static bool compare(const char* name, const std::vector<float>& feats, const std::vector<float>& ref,
+                    int n_mels, float tolerance) {
+    if (feats.size() != ref.size()) {
+        printf("%s: %zu frames, reference %zu\n", name, feats.size() / n_mels, ref.size() / n_mels);
+        return false;
+    }
+
+    float max_diff = 0;
+    size_t max_index = 0;
+    for (size_t i = 0; i < ref.size(); i++) {
+        float diff = fabsf(feats[i] - ref[i]);
+        if (diff > max_diff) {
+            max_diff = diff;
+            max_index = i;
+        }
+    }
+    printf("%s: %zu frames, max diff %.6f at frame %zu bin %zu\n", name, ref.size() / n_mels, max_diff,
+           max_index / n_mels, max_index % n_mels);
+    return max_diff <= tolerance;
+}
+
+int main(int argc, char** argv) {
+    cmdline::parser cmd;
+    cmd.add<std::string>("audio", 'a', "audio file, support wav and mp3, a synthetic signal if empty", false, "");
+    cmd.add<int>("n_mels", 'n', "fbank bins", false, 80);
+    cmd.add<int>("chunk_ms", 'c', "feed size in milliseconds", false, 100);
+    cmd.add<float>("tolerance", 't', "max abs difference of log mel energies", false, 1e-4f);
+    cmd.parse_check(argc, argv);
+
+    auto audio_file = cmd.get<std::string>("audio");
+    auto n_mels = cmd.get<int>("n_mels");
+    auto chunk_ms = cmd.get<int>("chunk_ms");
+    auto tolerance = cmd.get<float>("tolerance");
+
+    std::vector<float> audio;
+    if (!audio_file.empty()) {
+        utils::AudioLoader audio_loader;
+        if (!audio_loader.load(audio_file, 16000)) {
+            printf("load audio failed!\n");
+            return -1;
+        }
+        audio = std::move(audio_loader.samples);
+    } else {
+        // 3s chirp over low level noise, an odd length so the last frame is partial
+        const int n = 16000 * 3 + 123;
+        audio.resize(n);
+        uint32_t x = 1;
+        for (int i = 0; i < n; i++) {
+            float t = i / 16000.0f;
+            x = x * 1664525u + 1013904223u;
+            float noise = ((x >> 8) / 16777216.0f - 0.5f) * 0.01f;
+            audio[i] = 0.5f * sinf(2 * (float)M_PI * (100 + 1000 * t) * t) + noise;
+        }
+    }
+
+    // The s16 path is compared against the reference fed the same quantized samples
+    std::vector<int16_t> pcm_s16(audio.size());
+    std::vector<float> quantized(audio.size());
+    for (size_t i = 0; i < audio.size(); i++) {
+        float s = std::max(-1.0f, std::min(audio[i], 32767.0f / 32768.0f));
+        pcm_s16[i] = (int16_t)lrintf(s * 32768.0f);
+        quantized[i] = pcm_s16[i] / 32768.0f;
+    }
+
+    int chunk_samples = std::max(16000 * chunk_ms / 1000, 1);
+    int num_frames;
+    bool ok = true;
+
+    std::vector<float> ref = reference_fbank(audio, n_mels, num_frames);
+    ok &= compare("float", frontend_fbank(audio, {}, n_mels, chunk_samples), ref, n_mels, tolerance);
+
+    ref = reference_fbank(quantized, n_mels, num_frames);
+    ok &= compare("s16", frontend_fbank(audio, pcm_s16, n_mels, chunk_samples), ref, n_mels, tolerance);
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "utils/cmdline.hpp"
+#include "utils/timer.hpp"
+#include "utils/AudioReader.hpp"
+
+// Decode the whole file with AudioReader, at the file's own rate
+static bool decode(const std::string& audio_file, int num_threads, std::vector<float>& samples, int& sample_rate) {
+    utils::AudioReader reader;
+    reader.set_decode_threads(num_threads);
+    if (!reader.open(audio_file, 0))
+        return false;
+
+    samples.clear();
+    std::vector<float> block;
+    while (reader.read(block)) {
+        samples.insert(samples.end(), block.begin(), block.end());
+    }
+    sample_rate = reader.get_sample_rate();
+    return !reader.failed();
+}
+
+int main(int argc, char** argv) {
+    cmdline::parser cmd;
+    cmd.add<std::string>("audio", 'a', "mp3 file, a few minutes or longer", true, "");
+    cmd.add<int>("threads", 't', "largest number of decode threads to compare", false, 4);
+    cmd.add<int>("repeat", 'r', "decodes per thread count, the fastest is reported", false, 3);
+    cmd.parse_check(argc, argv);
+
+    auto audio_file = cmd.get<std::string>("audio");
+    auto max_threads = cmd.get<int>("threads");
+    auto repeat = cmd.get<int>("repeat");
+
+    Timer timer;
+    std::vector<float> serial;
+    float serial_time = 0;
+    int sample_rate = 0;
+    for (int i = 0; i < repeat; i++) {
+        timer.start();
+        if (!decode(audio_file, 1, serial, sample_rate)) {
+            printf("decode %s failed!\n", audio_file.c_str());
+            return -1;
+        }
+        timer.stop();
+        float t = timer.elapsed<std::chrono::milliseconds>();
+        serial_time = i == 0 ? t : std::min(serial_time, t);
+    }
+
+    float duration = serial.size() * 1.f / sample_rate;
+    printf("%s: %.2f seconds, %d Hz\n", audio_file.c_str(), duration, sample_rate);
+    printf("threads=1: %.2fms, %.1fx realtime\n", serial_time, duration * 1000 / serial_time);
+
+    int ret = 0;
+    for (int threads = 2; threads <= max_threads; threads++) {
+        std::vector<float> samples;
+        float best = 0;
+        for (int i = 0; i < repeat; i++) {
+            timer.start();
+            if (!decode(audio_file, threads, samples, sample_rate)) {
+                printf("decode %s with %d threads failed!\n", audio_file.c_str(), threads);
+                return -1;
+            }
+            timer.stop();
+            float t = timer.elapsed<std::chrono::milliseconds>();
+            best = i == 0 ? t : std::min(best, t);
+        }
+
+        // Ranges are stitched sample-exactly, any difference is a bug
+        bool same = samples.size() == serial.size() &&
+                    memcmp(samples.data(), serial.data(), serial.size() * sizeof(float)) == 0;
+        printf("threads=%d: %.2fms, %.1fx realtime, speedup %.2f, %s\n", threads, best,
+               duration * 1000 / best, serial_time / best, same ? "same output" : "OUTPUT DIFFERS");
+        if (!same)
+            ret = -1;
+    }
+    return ret;
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include "utils/cmdline.hpp"
+#include "utils/timer.hpp"
+#include "utils/AudioLoader.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "ax_asr_api.h"
+#ifdef __cplusplus
+}
+#endif
+
+int main(int argc, char** argv) {
+    cmdline::parser cmd;
+    cmd.add<std::string>("audio", 'a', "audio file, support wav and mp3", true, "");
+#if defined(CHIP_AX650) || defined(CHIP_AX8850)
+    cmd.add<std::string>("model_path", 'p', "model path which contains axmodel", false, "./models-ax650");
+#else
+    cmd.add<std::string>("model_path", 'p', "model path which contains axmodel", false, "./models-ax630c");
+#endif
+    cmd.add<int>("batch", 'b', "also run the audio N times through AX_ASR_RunPCMBatch", false, 0);
+    cmd.parse_check(argc, argv);
+
+    auto audio_file = cmd.get<std::string>("audio");
+    auto model_path = cmd.get<std::string>("model_path");
+    auto batch = cmd.get<int>("batch");
+
+    utils::AudioLoader audio_loader;
+    if (!audio_loader.load(audio_file)) {
+        printf("load audio failed!\n");
+        return -1;
+    }
+
+    int n_samples = audio_loader.get_num_samples();
+    float duration = n_samples * 1.f / 16000;
+
+    Timer timer;
+
+    timer.start();
+    AX_ASR_HANDLE handle = AX_ASR_Init(AX_PARAFORMER, model_path.c_str());
+    timer.stop();
+
+    if (!handle) {
+        printf("AX_ASR_Init failed!\n");
+        return -1;
+    }
+
+    printf("Init asr success, take %.4fseconds\n", timer.elapsed<std::chrono::seconds>());
+
+    // Run
+    timer.start();
+    char* result;
+    if (0 != AX_ASR_RunFile(handle, audio_file.c_str(), "zh", &result)) {
+        printf("AX_ASR_RunFile failed!\n");
+        AX_ASR_Uninit(handle);
+        return -1;
+    }
+    timer.stop();
+    float inference_time = timer.elapsed<std::chrono::seconds>();
+
+    printf("Result: %s\n", result);
+    printf("RTF(%.2f / %.2f) = %.4f\n", inference_time, duration, inference_time / duration);
+
+    AX_ASR_Free(result);
+
+    if (batch > 0) {
+        std::vector<const float*> pcm_list(batch, audio_loader.samples.data());
+        std::vector<int> num_samples(batch, n_samples);
+        std::vector<char*> results(batch, nullptr);
+
+        timer.start();
+        int ret = AX_ASR_RunPCMBatch(handle, pcm_list.data(), num_samples.data(), batch,
+            audio_loader.get_sample_rate(), "zh", results.data());
+        timer.stop();
+        if (0 != ret) {
+            printf("AX_ASR_RunPCMBatch failed!\n");
+            AX_ASR_Uninit(handle);
+            return -1;
+        }
+        float batch_time = timer.elapsed<std::chrono::seconds>();
+
+        for (int i = 0; i < batch; i++) {
+            printf("Batch[%d]: %s\n", i, results[i]);
+            AX_ASR_Free(results[i]);
+        }
+        printf("Batch RTF(%.2f / %.2f) = %.4f\n", batch_time, duration * batch, batch_time / (duration * batch));
+    }
+
+    AX_ASR_Uninit(handle);
+    return 0;
+}
@@ -20,11 +20,15 @@ int main(int argc, char** argv) {
     cmd.add<std::string>("model_path", 'p', "model path which contains axmodel", false, "./models-ax630c");
 #endif
     cmd.add<std::string>("language", 'l', "auto, en, zh, yue, ja, ko", false, "zh");
+    cmd.add<int>("batch", 'b', "also run the audio N times through AX_ASR_RunPCMBatch", false, 0);
+    cmd.add("timestamps", 't', "also print word timestamps from AX_ASR_RunPCMDetailed");
     cmd.parse_check(argc, argv);
 
     auto audio_file = cmd.get<std::string>("audio");
     auto model_path = cmd.get<std::string>("model_path");
     auto language = cmd.get<std::string>("language");
+    auto batch = cmd.get<int>("batch");
+    bool timestamps = cmd.exist("timestamps");
 
     utils::AudioLoader audio_loader;
     if (!audio_loader.load(audio_file)) {
@@ -63,6 +67,46 @@ int main(int argc, char** argv) {
     printf("RTF(%.2f / %.2f) = %.4f\n", inference_time, duration, inference_time / duration);
 
     AX_ASR_Free(result);
+
+    if (batch > 0) {
+        std::vector<const float*> pcm_list(batch, audio_loader.samples.data());
+        std::vector<int> num_samples(batch, n_samples);
+        std::vector<char*> results(batch, nullptr);
+
+        timer.start();
+        int ret = AX_ASR_RunPCMBatch(handle, pcm_list.data(), num_samples.data(), batch,
+            audio_loader.get_sample_rate(), language.c_str(), results.data());
+        timer.stop();
+        if (0 != ret) {
+            printf("AX_ASR_RunPCMBatch failed!\n");
+            AX_ASR_Uninit(handle);
+            return -1;
+        }
+        float batch_time = timer.elapsed<std::chrono::seconds>();
+
+        for (int i = 0; i < batch; i++) {
+            printf("Batch[%d]: %s\n", i, results[i]);
+            AX_ASR_Free(results[i]);
+        }
+        printf("Batch RTF(%.2f / %.2f) = %.4f\n", batch_time, duration * batch, batch_time / (duration * batch));
+    }
+
+    if (timestamps) {
+        AX_ASR_DETAILED_RESULT_T* detailed = nullptr;
+        if (0 != AX_ASR_RunPCMDetailed(handle, audio_loader.samples.data(), n_samples,
+                audio_loader.get_sample_rate(), language.c_str(), &detailed)) {
+            printf("AX_ASR_RunPCMDetailed failed!\n");
+            AX_ASR_Uninit(handle);
+            return -1;
+        }
+
+        for (int i = 0; i < detailed->num_words; i++) {
+            printf("[%6.2f - %6.2f] %s\n", detailed->words[i].start_ms / 1000.0f,
+                detailed->words[i].end_ms / 1000.0f, detailed->words[i].text);
+        }
+        AX_ASR_FreeDetailed(detailed);
+    }
+
     AX_ASR_Uninit(handle);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include "utils/cmdline.hpp"
+#include "utils/timer.hpp"
+#include "utils/AudioLoader.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "ax_asr_api.h"
+#ifdef __cplusplus
+}
+#endif
+
+int main(int argc, char** argv) {
+    cmdline::parser cmd;
+    cmd.add<std::string>("audio", 'a', "audio file, support wav and mp3", true, "");
+#if defined(CHIP_AX650) || defined(CHIP_AX8850)
+    cmd.add<std::string>("model_path", 'p', "model path which contains axmodel", false, "./models-ax650");
+#else
+    cmd.add<std::string>("model_path", 'p', "model path which contains axmodel", false, "./models-ax630c");
+#endif
+    cmd.add<int>("chunk_ms", 'c', "streaming feed size in milliseconds", false, 100);
+    cmd.add<int>("beam_size", 'b', "modified beam search paths, 1 is greedy", false, 4);
+    cmd.add("s16", 's', "stream 16 bit PCM through AX_ASR_StreamFeed_S16, like a capture device");
+    cmd.parse_check(argc, argv);
+
+    auto audio_file = cmd.get<std::string>("audio");
+    auto model_path = cmd.get<std::string>("model_path");
+    auto chunk_ms = cmd.get<int>("chunk_ms");
+    auto beam_size = cmd.get<int>("beam_size");
+    bool use_s16 = cmd.exist("s16");
+
+    utils::AudioLoader audio_loader;
+    if (!audio_loader.load(audio_file)) {
+        printf("load audio failed!\n");
+        return -1;
+    }
+
+    int n_samples = audio_loader.get_num_samples();
+    int sample_rate = audio_loader.get_sample_rate();
+    float duration = n_samples * 1.f / sample_rate;
+
+    Timer timer;
+
+    timer.start();
+    AX_ASR_HANDLE handle = AX_ASR_Init(AX_ZIPFORMER, model_path.c_str());
+    timer.stop();
+
+    if (!handle) {
+        printf("AX_ASR_Init failed!\n");
+        return -1;
+    }
+
+    printf("Init asr success, take %.4fseconds\n", timer.elapsed<std::chrono::seconds>());
+
+    if (0 != AX_ASR_SetParam(handle, "beam_size", std::to_string(beam_size).c_str())) {
+        printf("AX_ASR_SetParam beam_size failed!\n");
+        AX_ASR_Uninit(handle);
+        return -1;
+    }
+
+    // Offline
+    timer.start();
+    char* result;
+    if (0 != AX_ASR_RunFile(handle, audio_file.c_str(), "auto", &result)) {
+        printf("AX_ASR_RunFile failed!\n");
+        AX_ASR_Uninit(handle);
+        return -1;
+    }
+    timer.stop();
+    float inference_time = timer.elapsed<std::chrono::seconds>();
+
+    printf("Result: %s\n", result);
+    printf("RTF(%.2f / %.2f) = %.4f\n", inference_time, duration, inference_time / duration);
+
+    AX_ASR_Free(result);
+
+    // Streaming, the cost of every feed stays flat however long the audio is
+    if (0 != AX_ASR_StreamInit(handle)) {
+        printf("AX_ASR_StreamInit failed!\n");
+        AX_ASR_Uninit(handle);
+        return -1;
+    }
+
+    std::vector<int16_t> pcm_s16;
+    if (use_s16) {
+        pcm_s16.resize(n_samples);
+        for (int i = 0; i < n_samples; i++) {
+            float s = std::max(-1.0f, std::min(audio_loader.samples[i], 32767.0f / 32768.0f));
+            pcm_s16[i] = (int16_t)lrintf(s * 32768.0f);
+        }
+    }
+
+    int chunk_samples = sample_rate * chunk_ms / 1000;
+    float max_feed_ms = 0;
+    std::string last_text;
+    for (int offset = 0; offset < n_samples; offset += chunk_samples) {
+        int n = std::min(chunk_samples, n_samples - offset);
+
+        timer.start();
+        if (use_s16)
+            AX_ASR_StreamFeed_S16(handle, pcm_s16.data() + offset, n, sample_rate);
+        else
+            AX_ASR_StreamFeed(handle, audio_loader.samples.data() + offset, n, sample_rate);
+        timer.stop();
+        max_feed_ms = std::max(max_feed_ms, timer.elapsed<std::chrono::milliseconds>());
+
+        const char* partial = nullptr;
+        if (0 == AX_ASR_StreamResult(handle, &partial) && partial && last_text != partial) {
+            last_text = partial;
+            printf("[%6.2f] %s\n", (offset + n) * 1.f / sample_rate, partial);
+        }
+    }
+    printf("Stream: %dms chunks, slowest feed %.1fms\n", chunk_ms, max_feed_ms);
+
+    AX_ASR_Uninit(handle);
+    return 0;
+}
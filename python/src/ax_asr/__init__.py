@@ -1,6 +1,6 @@
 """ax_asr — Python binding for Axera ASR speech recognition."""
 
-from .recognizer import AX_ASR
+from .recognizer import AX_ASR, StreamSession
 
-__all__ = ["AX_ASR"]
+__all__ = ["AX_ASR", "StreamSession"]
 __version__ = "0.1.0"
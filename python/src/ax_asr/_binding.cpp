@@ -18,6 +18,10 @@ static void check_ret(int ret, const char* context) {
         case AX_ASR_ERR_AUDIO_LOAD_FAILED:msg = "Audio load failed"; break;
         case AX_ASR_ERR_RUN_FAILED:       msg = "Run failed"; break;
         case AX_ASR_ERR_NO_MEMORY:        msg = "No memory"; break;
+        case AX_ASR_ERR_STREAM_NOT_SUPPORTED: msg = "Stream not supported"; break;
+        case AX_ASR_ERR_QUEUE_FULL:       msg = "Queue full"; break;
+        case AX_ASR_ERR_NOT_READY:        msg = "Not ready"; break;
+        case AX_ASR_ERR_CANCELLED:        msg = "Cancelled"; break;
     }
     throw std::runtime_error(std::string(context) + ": " + msg);
 }
@@ -31,6 +35,29 @@ static AX_ASR_HANDLE init_handle(int asr_type, const std::string& model_path) {
     return h;
 }
 
+static AX_ASR_HANDLE init_by_name(const std::string& model_name, const std::string& model_path) {
+    AX_ASR_HANDLE h = AX_ASR_InitByName(model_name.c_str(), model_path.c_str());
+    if (!h) {
+        throw std::runtime_error("AX_ASR_InitByName returned NULL");
+    }
+    return h;
+}
+
+static std::vector<std::string> list_models(const std::string& model_path) {
+    char* names = nullptr;
+    check_ret(AX_ASR_ListModels(model_path.c_str(), &names), "AX_ASR_ListModels");
+    std::vector<std::string> result;
+    const char* begin = names;
+    while (*begin) {
+        const char* end = strchr(begin, ',');
+        if (!end) end = begin + strlen(begin);
+        result.emplace_back(begin, end);
+        begin = *end ? end + 1 : end;
+    }
+    AX_ASR_Free(names);
+    return result;
+}
+
 static void uninit_handle(AX_ASR_HANDLE handle) {
     if (handle) {
         AX_ASR_Uninit(handle);
@@ -49,6 +76,23 @@ static std::string run_file(AX_ASR_HANDLE handle, const std::string& wav_file,
     return text;
 }
 
+static std::string run_buffer(AX_ASR_HANDLE handle, py::bytes data, const std::string& format,
+                              const std::string& language) {
+    if (!handle)
+        throw std::runtime_error("Handle is null");
+    char* buffer = nullptr;
+    py::ssize_t size = 0;
+    if (PYBIND11_BYTES_AS_STRING_AND_SIZE(data.ptr(), &buffer, &size) != 0)
+        throw std::runtime_error("Cannot read audio bytes");
+    char* result = nullptr;
+    int ret = AX_ASR_RunBuffer(handle, buffer, static_cast<size_t>(size), format.c_str(),
+                               language.c_str(), &result);
+    check_ret(ret, "AX_ASR_RunBuffer");
+    std::string text(result ? result : "");
+    AX_ASR_Free(result);
+    return text;
+}
+
 static std::string run_pcm(AX_ASR_HANDLE handle, py::array_t<float, py::array::c_style> pcm,
                             int sample_rate, const std::string& language) {
     if (!handle)
@@ -60,14 +104,130 @@ static std::string run_pcm(AX_ASR_HANDLE handle, py::array_t<float, py::array::c
     int num_samples = static_cast<int>(buf.size);
 
     char* result = nullptr;
-    int ret = AX_ASR_RunPCM(handle, const_cast<float*>(data),
-                             num_samples, sample_rate, language.c_str(), &result);
+    int ret = AX_ASR_RunPCM(handle, data, num_samples, sample_rate, language.c_str(), &result);
     check_ret(ret, "AX_ASR_RunPCM");
     std::string text(result ? result : "");
     AX_ASR_Free(result);
     return text;
 }
 
+static std::string run_pcm_s16(AX_ASR_HANDLE handle, py::array_t<int16_t, py::array::c_style> pcm,
+                                int sample_rate, const std::string& language) {
+    if (!handle)
+        throw std::runtime_error("Handle is null");
+    auto buf = pcm.request();
+    if (buf.ndim != 1)
+        throw std::runtime_error("PCM data must be 1-dimensional int16 array");
+    const int16_t* data = static_cast<const int16_t*>(buf.ptr);
+    int num_samples = static_cast<int>(buf.size);
+
+    char* result = nullptr;
+    int ret = AX_ASR_RunPCM_S16(handle, data, num_samples, sample_rate, language.c_str(), &result);
+    check_ret(ret, "AX_ASR_RunPCM_S16");
+    std::string text(result ? result : "");
+    AX_ASR_Free(result);
+    return text;
+}
+// {"text": str, "tokens": [(text, start_ms, end_ms)], "words": [...]}
+static py::dict run_pcm_detailed(AX_ASR_HANDLE handle, py::array_t<float, py::array::c_style> pcm,
+                                 int sample_rate, const std::string& language) {
+    if (!handle)
+        throw std::runtime_error("Handle is null");
+    auto buf = pcm.request();
+    if (buf.ndim != 1)
+        throw std::runtime_error("PCM data must be 1-dimensional float32 array");
+
+    AX_ASR_DETAILED_RESULT_T* result = nullptr;
+    int ret = AX_ASR_RunPCMDetailed(handle, static_cast<const float*>(buf.ptr),
+                                    static_cast<int>(buf.size), sample_rate, language.c_str(), &result);
+    check_ret(ret, "AX_ASR_RunPCMDetailed");
+
+    auto to_list = [](const AX_ASR_TIMESTAMP_T* stamps, int num) {
+        py::list out;
+        for (int i = 0; i < num; i++) {
+            out.append(py::make_tuple(std::string(stamps[i].text), stamps[i].start_ms, stamps[i].end_ms));
+        }
+        return out;
+    };
+
+    py::dict out;
+    out["text"] = std::string(result->text);
+    out["tokens"] = to_list(result->tokens, result->num_tokens);
+    out["words"] = to_list(result->words, result->num_words);
+    AX_ASR_FreeDetailed(result);
+    return out;
+}
+
+static std::vector<std::string> run_pcm_batch(AX_ASR_HANDLE handle,
+                                              const std::vector<py::array_t<float, py::array::c_style>>& pcm_list,
+                                              int sample_rate, const std::string& language) {
+    if (!handle)
+        throw std::runtime_error("Handle is null");
+    int count = static_cast<int>(pcm_list.size());
+    if (count == 0)
+        return {};
+
+    std::vector<const float*> data(count);
+    std::vector<int> num_samples(count);
+    for (int i = 0; i < count; i++) {
+        auto buf = pcm_list[i].request();
+        if (buf.ndim != 1)
+            throw std::runtime_error("PCM data must be 1-dimensional float32 array");
+        data[i] = static_cast<const float*>(buf.ptr);
+        num_samples[i] = static_cast<int>(buf.size);
+    }
+
+    std::vector<char*> results(count, nullptr);
+    int ret = AX_ASR_RunPCMBatch(handle, data.data(), num_samples.data(), count,
+                                 sample_rate, language.c_str(), results.data());
+    check_ret(ret, "AX_ASR_RunPCMBatch");
+
+    std::vector<std::string> texts(count);
+    for (int i = 0; i < count; i++) {
+        texts[i] = results[i] ? results[i] : "";
+        AX_ASR_Free(results[i]);
+    }
+    return texts;
+}
+
+// Files that failed come back as None, the others are still recognized
+static py::list run_batch(AX_ASR_HANDLE handle, const std::vector<std::string>& files,
+                          const std::string& language) {
+    if (!handle)
+        throw std::runtime_error("Handle is null");
+    int count = static_cast<int>(files.size());
+    py::list out;
+    if (count == 0)
+        return out;
+
+    std::vector<const char*> paths(count);
+    for (int i = 0; i < count; i++) {
+        paths[i] = files[i].c_str();
+    }
+
+    std::vector<char*> results(count, nullptr);
+    {
+        py::gil_scoped_release release;
+        AX_ASR_RunBatch(handle, paths.data(), count, language.c_str(), results.data());
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (results[i]) {
+            out.append(std::string(results[i]));
+            AX_ASR_Free(results[i]);
+        } else {
+            out.append(py::none());
+        }
+    }
+    return out;
+}
+
+static void set_param(AX_ASR_HANDLE handle, const std::string& key, const std::string& value) {
+    if (!handle)
+        throw std::runtime_error("Handle is null");
+    int ret = AX_ASR_SetParam(handle, key.c_str(), value.c_str());
+    check_ret(ret, "AX_ASR_SetParam");
+}
 
 // ---- Streaming API ----
 
@@ -85,10 +245,22 @@ static void stream_feed(AX_ASR_HANDLE handle, py::array_t<float, py::array::c_st
         throw std::runtime_error("PCM data must be 1-dimensional float32 array");
     const float* data = static_cast<const float*>(buf.ptr);
     int n = static_cast<int>(buf.size);
-    int ret = AX_ASR_StreamFeed(handle, const_cast<float*>(data), n, sample_rate);
+    int ret = AX_ASR_StreamFeed(handle, data, n, sample_rate);
     check_ret(ret, "AX_ASR_StreamFeed");
 }
 
+static void stream_feed_s16(AX_ASR_HANDLE handle, py::array_t<int16_t, py::array::c_style> pcm,
+                             int sample_rate) {
+    if (!handle) throw std::runtime_error("Handle is null");
+    auto buf = pcm.request();
+    if (buf.ndim != 1)
+        throw std::runtime_error("PCM data must be 1-dimensional int16 array");
+    const int16_t* data = static_cast<const int16_t*>(buf.ptr);
+    int n = static_cast<int>(buf.size);
+    int ret = AX_ASR_StreamFeed_S16(handle, data, n, sample_rate);
+    check_ret(ret, "AX_ASR_StreamFeed_S16");
+}
+
 static std::string stream_result(AX_ASR_HANDLE handle) {
     if (!handle) throw std::runtime_error("Handle is null");
     const char* result = nullptr;
@@ -105,6 +277,95 @@ static void stream_reset(AX_ASR_HANDLE handle) {
     check_ret(ret, "AX_ASR_StreamReset");
 }
 
+// ---- Streaming sessions ----
+
+static AX_ASR_STREAM_HANDLE stream_create(AX_ASR_HANDLE handle) {
+    if (!handle) throw std::runtime_error("Handle is null");
+    AX_ASR_STREAM_HANDLE s = AX_ASR_StreamCreate(handle);
+    if (!s)
+        throw std::runtime_error("AX_ASR_StreamCreate returned NULL");
+    return s;
+}
+
+static void stream_destroy(AX_ASR_STREAM_HANDLE stream) {
+    if (stream) {
+        AX_ASR_StreamDestroy(stream);
+    }
+}
+
+static void session_feed(AX_ASR_STREAM_HANDLE stream, py::array_t<float, py::array::c_style> pcm,
+                          int sample_rate) {
+    if (!stream) throw std::runtime_error("Stream is null");
+    auto buf = pcm.request();
+    if (buf.ndim != 1)
+        throw std::runtime_error("PCM data must be 1-dimensional float32 array");
+    const float* data = static_cast<const float*>(buf.ptr);
+    int n = static_cast<int>(buf.size);
+    int ret;
+    {
+        // Sessions may be fed from several Python threads
+        py::gil_scoped_release release;
+        ret = AX_ASR_SessionFeed(stream, data, n, sample_rate);
+    }
+    check_ret(ret, "AX_ASR_SessionFeed");
+}
+
+static void session_feed_s16(AX_ASR_STREAM_HANDLE stream, py::array_t<int16_t, py::array::c_style> pcm,
+                              int sample_rate) {
+    if (!stream) throw std::runtime_error("Stream is null");
+    auto buf = pcm.request();
+    if (buf.ndim != 1)
+        throw std::runtime_error("PCM data must be 1-dimensional int16 array");
+    const int16_t* data = static_cast<const int16_t*>(buf.ptr);
+    int n = static_cast<int>(buf.size);
+    int ret;
+    {
+        py::gil_scoped_release release;
+        ret = AX_ASR_SessionFeed_S16(stream, data, n, sample_rate);
+    }
+    check_ret(ret, "AX_ASR_SessionFeed_S16");
+}
+
+static std::string session_result(AX_ASR_STREAM_HANDLE stream) {
+    if (!stream) throw std::runtime_error("Stream is null");
+    const char* result = nullptr;
+    int ret = AX_ASR_SessionResult(stream, &result);
+    if (ret == AX_ASR_ERR_STREAM_NOT_SUPPORTED)
+        return "";
+    check_ret(ret, "AX_ASR_SessionResult");
+    return result ? std::string(result) : std::string("");
+}
+
+static void session_reset(AX_ASR_STREAM_HANDLE stream) {
+    if (!stream) throw std::runtime_error("Stream is null");
+    int ret = AX_ASR_SessionReset(stream);
+    check_ret(ret, "AX_ASR_SessionReset");
+}
+
+static void session_set_endpoint(AX_ASR_STREAM_HANDLE stream, bool enable,
+                                  int min_trailing_silence_ms, int max_utterance_ms,
+                                  int min_speech_ms, float silence_dbfs) {
+    if (!stream) throw std::runtime_error("Stream is null");
+    AX_ASR_ENDPOINT_CONFIG_T config;
+    config.enable = enable ? 1 : 0;
+    config.min_trailing_silence_ms = min_trailing_silence_ms;
+    config.max_utterance_ms = max_utterance_ms;
+    config.min_speech_ms = min_speech_ms;
+    config.silence_dbfs = silence_dbfs;
+    int ret = AX_ASR_SessionSetEndpoint(stream, &config);
+    check_ret(ret, "AX_ASR_SessionSetEndpoint");
+}
+
+static py::object session_final_result(AX_ASR_STREAM_HANDLE stream) {
+    if (!stream) throw std::runtime_error("Stream is null");
+    const char* result = nullptr;
+    int ret = AX_ASR_SessionFinalResult(stream, &result);
+    check_ret(ret, "AX_ASR_SessionFinalResult");
+    if (!result)
+        return py::none();
+    return py::str(result);
+}
+
 PYBIND11_MODULE(_ax_asr_core, m) {
     m.doc() = "Low-level pybind11 binding for ax_asr_api";
 
@@ -114,6 +375,10 @@ PYBIND11_MODULE(_ax_asr_core, m) {
         .value("WHISPER_SMALL", AX_WHISPER_SMALL)
         .value("WHISPER_TURBO", AX_WHISPER_TURBO)
         .value("SENSEVOICE", AX_SENSEVOICE)
+        .value("SENSEVOICE_WHISPER_SMALL", AX_SENSEVOICE_WHISPER_SMALL)
+        .value("SENSEVOICE_WHISPER_TURBO", AX_SENSEVOICE_WHISPER_TURBO)
+        .value("ZIPFORMER", AX_ZIPFORMER)
+        .value("PARAFORMER", AX_PARAFORMER)
         .export_values();
 
     py::enum_<AX_ASR_STATUS_E>(m, "AsrStatus")
@@ -123,17 +388,42 @@ PYBIND11_MODULE(_ax_asr_core, m) {
         .value("ERR_AUDIO_LOAD_FAILED", AX_ASR_ERR_AUDIO_LOAD_FAILED)
         .value("ERR_RUN_FAILED", AX_ASR_ERR_RUN_FAILED)
         .value("ERR_NO_MEMORY", AX_ASR_ERR_NO_MEMORY)
+        .value("ERR_STREAM_NOT_SUPPORTED", AX_ASR_ERR_STREAM_NOT_SUPPORTED)
+        .value("ERR_QUEUE_FULL", AX_ASR_ERR_QUEUE_FULL)
+        .value("ERR_NOT_READY", AX_ASR_ERR_NOT_READY)
+        .value("ERR_CANCELLED", AX_ASR_ERR_CANCELLED)
         .export_values();
 
     m.def("init", &init_handle, py::arg("asr_type"), py::arg("model_path"),
           "Initialize ASR handle. Returns opaque handle.");
+    m.def("init_by_name", &init_by_name, py::arg("model_name"), py::arg("model_path"),
+          "Initialize ASR handle by registered model name. Returns opaque handle.");
+    m.def("list_models", &list_models, py::arg("model_path"),
+          "Built-in model names plus variants with a manifest.json under model_path.");
     m.def("uninit", &uninit_handle, py::arg("handle"),
           "Release ASR handle.");
     m.def("run_file", &run_file, py::arg("handle"), py::arg("wav_file"),
           py::arg("language"), "Transcribe audio file, return text.");
+    m.def("run_buffer", &run_buffer, py::arg("handle"), py::arg("data"),
+          py::arg("format"), py::arg("language"),
+          "Transcribe wav/mp3/flac/opus file content held in memory, return text.");
     m.def("run_pcm", &run_pcm, py::arg("handle"), py::arg("pcm"),
           py::arg("sample_rate"), py::arg("language"),
           "Transcribe PCM float32 array, return text.");
+    m.def("run_pcm_s16", &run_pcm_s16, py::arg("handle"), py::arg("pcm"),
+          py::arg("sample_rate"), py::arg("language"),
+          "Transcribe PCM int16 array, return text.");
+    m.def("run_pcm_detailed", &run_pcm_detailed, py::arg("handle"), py::arg("pcm"),
+          py::arg("sample_rate"), py::arg("language"),
+          "Transcribe PCM float32 array, return text with token and word timestamps.");
+    m.def("run_pcm_batch", &run_pcm_batch, py::arg("handle"), py::arg("pcm_list"),
+          py::arg("sample_rate"), py::arg("language"),
+          "Transcribe a list of PCM float32 arrays, return list of text.");
+    m.def("run_batch", &run_batch, py::arg("handle"), py::arg("files"),
+          py::arg("language"),
+          "Transcribe a list of audio files, return list of text or None for failed files.");
+    m.def("set_param", &set_param, py::arg("handle"), py::arg("key"),
+          py::arg("value"), "Set a model specific parameter.");
 
     // Streaming
     m.def("stream_init", &stream_init, py::arg("handle"),
@@ -141,9 +431,35 @@ PYBIND11_MODULE(_ax_asr_core, m) {
     m.def("stream_feed", &stream_feed, py::arg("handle"), py::arg("pcm"),
           py::arg("sample_rate"),
           "Feed audio chunk for streaming recognition.");
+    m.def("stream_feed_s16", &stream_feed_s16, py::arg("handle"), py::arg("pcm"),
+          py::arg("sample_rate"),
+          "Feed int16 audio chunk for streaming recognition.");
     m.def("stream_result", &stream_result, py::arg("handle"),
           "Get current partial streaming result.");
     m.def("stream_reset", &stream_reset, py::arg("handle"),
           "Reset streaming state.");
+
+    // Streaming sessions
+    m.def("stream_create", &stream_create, py::arg("handle"),
+          "Create a streaming session sharing the handle's model.");
+    m.def("stream_destroy", &stream_destroy, py::arg("stream"),
+          "Release a streaming session.");
+    m.def("session_feed", &session_feed, py::arg("stream"), py::arg("pcm"),
+          py::arg("sample_rate"),
+          "Feed audio chunk to a streaming session.");
+    m.def("session_feed_s16", &session_feed_s16, py::arg("stream"), py::arg("pcm"),
+          py::arg("sample_rate"),
+          "Feed int16 audio chunk to a streaming session.");
+    m.def("session_result", &session_result, py::arg("stream"),
+          "Get current partial result of a streaming session.");
+    m.def("session_reset", &session_reset, py::arg("stream"),
+          "Reset a streaming session.");
+    m.def("session_set_endpoint", &session_set_endpoint, py::arg("stream"),
+          py::arg("enable"), py::arg("min_trailing_silence_ms") = 0,
+          py::arg("max_utterance_ms") = 0, py::arg("min_speech_ms") = 0,
+          py::arg("silence_dbfs") = 0.0f,
+          "Configure endpoint detection, 0 means default.");
+    m.def("session_final_result", &session_final_result, py::arg("stream"),
+          "Pop the oldest finalized utterance, None if there is none.");
 }
 
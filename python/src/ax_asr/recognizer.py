@@ -3,21 +3,109 @@
 from __future__ import annotations
 
 import os
-from typing import Optional
+import weakref
+from typing import List, Optional
 
 import numpy as np
 
-_MODEL_TYPES = {
-    "whisper_tiny": 0,
-    "whisper_base": 1,
-    "whisper_small": 2,
-    "whisper_turbo": 3,
-    "sensevoice": 4,
-}
+# Built-in models, variants described by a manifest.json under the model
+# path are looked up in the native registry
+_MODEL_TYPE_NAMES = frozenset({
+    "whisper_tiny",
+    "whisper_base",
+    "whisper_small",
+    "whisper_turbo",
+    "sensevoice",
+    "sensevoice_whisper_small",
+    "sensevoice_whisper_turbo",
+    "zipformer",
+    "paraformer",
+})
 
 _DEFAULT_MODEL_PATH_ENV = "AX_ASR_MODEL_PATH"
 
-_MODEL_TYPE_NAMES = frozenset(_MODEL_TYPES)
+
+def _available_models(model_path: str) -> List[str]:
+    try:
+        from ._ax_asr_core import list_models as _list_models
+    except ImportError:
+        return sorted(_MODEL_TYPE_NAMES)
+    return _list_models(model_path)
+
+
+class StreamSession:
+    """One streaming recognition session created by :meth:`AX_ASR.create_stream`.
+
+    Sessions of the same recognizer share its loaded model, so many
+    concurrent streams only cost their own feature buffers. Different
+    sessions may be fed from different threads.
+    """
+
+    def __init__(self, asr: "AX_ASR", stream):
+        # Keep the recognizer alive for as long as the session exists
+        self._asr = asr
+        self._stream = stream
+
+    def __enter__(self) -> StreamSession:
+        return self
+
+    def __exit__(self, *args) -> None:
+        self.close()
+
+    def close(self) -> None:
+        """Release the session. Safe to call multiple times."""
+        if self._stream is None:
+            return
+        from ._ax_asr_core import stream_destroy as _stream_destroy
+
+        _stream_destroy(self._stream)
+        self._stream = None
+
+    def __del__(self) -> None:
+        if getattr(self, "_stream", None) is not None:
+            self.close()
+
+    def feed(self, pcm: np.ndarray, sample_rate: int) -> None:
+        """Feed an audio chunk, see :meth:`AX_ASR.stream_feed`."""
+        if pcm.ndim != 1:
+            raise ValueError("PCM data must be 1-dimensional")
+        if pcm.dtype == np.int16:
+            from ._ax_asr_core import session_feed_s16 as _session_feed_s16
+            _session_feed_s16(self._stream, np.ascontiguousarray(pcm), sample_rate)
+            return
+        if pcm.dtype != np.float32:
+            pcm = pcm.astype(np.float32)
+        from ._ax_asr_core import session_feed as _session_feed
+        _session_feed(self._stream, pcm, sample_rate)
+
+    def result(self) -> str:
+        """Get the current partial result of this session."""
+        from ._ax_asr_core import session_result as _session_result
+        return _session_result(self._stream)
+
+    def reset(self) -> None:
+        """Reset this session to start a new utterance."""
+        from ._ax_asr_core import session_reset as _session_reset
+        _session_reset(self._stream)
+
+    def set_endpoint(
+        self,
+        enable: bool = True,
+        min_trailing_silence_ms: int = 0,
+        max_utterance_ms: int = 0,
+        min_speech_ms: int = 0,
+        silence_dbfs: float = 0.0,
+    ) -> None:
+        """Enable endpoint detection. Zero values use the library defaults
+        (800ms silence, 20s utterance, 200ms speech, -50dBFS)."""
+        from ._ax_asr_core import session_set_endpoint as _set_endpoint
+        _set_endpoint(self._stream, enable, min_trailing_silence_ms,
+                      max_utterance_ms, min_speech_ms, silence_dbfs)
+
+    def final_result(self) -> Optional[str]:
+        """Pop the oldest utterance closed by endpoint detection, or None."""
+        from ._ax_asr_core import session_final_result as _final_result
+        return _final_result(self._stream)
 
 
 class AX_ASR:
@@ -27,7 +115,10 @@ class AX_ASR:
     ----------
     model_type : str
         One of ``whisper_tiny``, ``whisper_base``, ``whisper_small``,
-        ``whisper_turbo``, ``sensevoice``.
+        ``whisper_turbo``, ``sensevoice``, ``sensevoice_whisper_small``,
+        ``sensevoice_whisper_turbo``, ``zipformer``,
+        ``paraformer``, or the name of a variant described by a
+        ``manifest.json`` in a sub directory of ``model_path``.
     model_path : str or None
         Root directory containing model files. If None, reads the
         ``AX_ASR_MODEL_PATH`` environment variable.
@@ -39,24 +130,26 @@ class AX_ASR:
     """
 
     def __init__(self, model_type: str, model_path: Optional[str] = None):
-        if model_type not in _MODEL_TYPES:
-            raise ValueError(
-                f"Unknown model_type '{model_type}'. "
-                f"Choose from: {sorted(_MODEL_TYPES)}"
-            )
         self._model_type = model_type
         self._model_path = model_path or os.environ.get(_DEFAULT_MODEL_PATH_ENV)
+        if model_type not in _MODEL_TYPE_NAMES:
+            available = _available_models(self._model_path or "")
+            if model_type not in available:
+                raise ValueError(
+                    f"Unknown model_type '{model_type}'. "
+                    f"Choose from: {available}"
+                )
         if not self._model_path:
             raise ValueError(
                 "model_path must be provided or set via "
                 f"{_DEFAULT_MODEL_PATH_ENV} environment variable"
             )
         self._handle = None
+        self._sessions = weakref.WeakSet()
 
-        from ._ax_asr_core import AsrType, init as _init
+        from ._ax_asr_core import init_by_name as _init_by_name
 
-        native_type = _MODEL_TYPES[model_type]
-        self._handle = _init(native_type, self._model_path)
+        self._handle = _init_by_name(model_type, self._model_path)
 
     def __enter__(self) -> AX_ASR:
         return self
@@ -69,6 +162,11 @@ class AX_ASR:
         if self._handle is None:
             return
         from ._ax_asr_core import uninit as _uninit
+        # Uninit releases sessions that are still open, make sure their
+        # wrappers do not destroy them a second time.
+        for session in self._sessions:
+            session._stream = None
+        self._sessions.clear()
 
         _uninit(self._handle)
         self._handle = None
@@ -86,26 +184,109 @@ class AX_ASR:
         return self._model_path
 
     def transcribe_file(self, audio_path: str, language: str = "zh") -> str:
-        """Transcribe an audio file (.wav or .mp3)."""
+        """Transcribe an audio file (.wav, .mp3, .flac, or .opus/.ogg)."""
         from ._ax_asr_core import run_file as _run_file
 
         return _run_file(self._handle, audio_path, language)
 
+    def transcribe_bytes(
+        self,
+        data: bytes,
+        format: str = "",
+        language: str = "zh",
+    ) -> str:
+        """Transcribe the content of an audio file held in memory.
+
+        ``format`` is ``"wav"``, ``"mp3"``, ``"flac"`` or ``"opus"``, guessed
+        from the data if empty.
+        """
+        from ._ax_asr_core import run_buffer as _run_buffer
+
+        return _run_buffer(self._handle, bytes(data), format, language)
+
+    def transcribe_files(
+        self,
+        audio_paths: List[str],
+        language: str = "zh",
+    ) -> List[Optional[str]]:
+        """Transcribe many audio files in one call.
+
+        Decoding and feature extraction of the next files run on worker
+        threads while the NPU works on the current ones. Files that cannot
+        be loaded or recognized give None, the rest are returned in order.
+        """
+        from ._ax_asr_core import run_batch as _run_batch
+
+        return _run_batch(self._handle, [os.fspath(p) for p in audio_paths], language)
+
     def transcribe_pcm(
         self,
         pcm: np.ndarray,
         sample_rate: int,
         language: str = "zh",
     ) -> str:
-        """Transcribe raw PCM float32 audio data."""
-        if pcm.dtype != np.float32:
-            pcm = pcm.astype(np.float32)
+        """Transcribe raw PCM audio data, float32 in [-1.0, 1.0] or int16."""
         if pcm.ndim != 1:
             raise ValueError("PCM data must be 1-dimensional")
+        if pcm.dtype == np.int16:
+            from ._ax_asr_core import run_pcm_s16 as _run_pcm_s16
+
+            return _run_pcm_s16(self._handle, np.ascontiguousarray(pcm), sample_rate, language)
+        if pcm.dtype != np.float32:
+            pcm = pcm.astype(np.float32)
         from ._ax_asr_core import run_pcm as _run_pcm
 
         return _run_pcm(self._handle, pcm, sample_rate, language)
 
+    def transcribe_pcm_detailed(
+        self,
+        pcm: np.ndarray,
+        sample_rate: int,
+        language: str = "zh",
+    ) -> dict:
+        """Transcribe raw PCM float32 audio data with timestamps.
+
+        Returns ``{"text": str, "tokens": [(text, start_ms, end_ms), ...],
+        "words": [...]}``. Models without alignment (whisper) return empty
+        ``tokens`` and ``words``.
+        """
+        if pcm.dtype != np.float32:
+            pcm = pcm.astype(np.float32)
+        if pcm.ndim != 1:
+            raise ValueError("PCM data must be 1-dimensional")
+        from ._ax_asr_core import run_pcm_detailed as _run_pcm_detailed
+
+        return _run_pcm_detailed(self._handle, np.ascontiguousarray(pcm), sample_rate, language)
+
+    def transcribe_pcm_batch(
+        self,
+        pcm_list: List[np.ndarray],
+        sample_rate: int,
+        language: str = "zh",
+    ) -> List[str]:
+        """Transcribe several short PCM float32 utterances in one call.
+
+        SenseVoice packs them into shared encoder runs, which is much faster
+        than calling :meth:`transcribe_pcm` for each keyword-length clip.
+        """
+        arrays = []
+        for pcm in pcm_list:
+            if pcm.dtype != np.float32:
+                pcm = pcm.astype(np.float32)
+            if pcm.ndim != 1:
+                raise ValueError("PCM data must be 1-dimensional")
+            arrays.append(np.ascontiguousarray(pcm))
+        from ._ax_asr_core import run_pcm_batch as _run_pcm_batch
+
+        return _run_pcm_batch(self._handle, arrays, sample_rate, language)
+
+    def set_param(self, key: str, value) -> None:
+        """Set a model specific parameter, e.g. ``set_param("vad", 0)``.
+        See ``AX_ASR_SetParam`` in ax_asr_api.h for the supported keys."""
+        from ._ax_asr_core import set_param as _set_param
+
+        _set_param(self._handle, key, str(value))
+
     def stream_init(self) -> None:
         """Initialize streaming recognition state.
         Call once before feeding audio chunks. Clears any previous partial results."""
@@ -118,15 +299,20 @@ class AX_ASR:
         Parameters
         ----------
         pcm:
-            float32 numpy array (1-D), range [-1.0, 1.0]. 
+            float32 numpy array (1-D), range [-1.0, 1.0], or int16 as
+            captured, which is passed through without a float copy.
             Typical chunk sizes: 400-1600 samples at 16kHz (25-100ms).
         sample_rate:
             Sample rate of the audio. Resampled to 16kHz internally.
         """
-        if pcm.dtype != np.float32:
-            pcm = pcm.astype(np.float32)
         if pcm.ndim != 1:
             raise ValueError("PCM data must be 1-dimensional")
+        if pcm.dtype == np.int16:
+            from ._ax_asr_core import stream_feed_s16 as _stream_feed_s16
+            _stream_feed_s16(self._handle, np.ascontiguousarray(pcm), sample_rate)
+            return
+        if pcm.dtype != np.float32:
+            pcm = pcm.astype(np.float32)
         from ._ax_asr_core import stream_feed as _stream_feed
         _stream_feed(self._handle, pcm, sample_rate)
 
@@ -143,3 +329,14 @@ class AX_ASR:
         """Reset streaming state. Call to start a new utterance."""
         from ._ax_asr_core import stream_reset as _stream_reset
         _stream_reset(self._handle)
+
+    def create_stream(self) -> StreamSession:
+        """Create an independent streaming session on this model.
+
+        Unlike the ``stream_*`` methods, which use a single built-in session,
+        any number of sessions can be live at the same time.
+        """
+        from ._ax_asr_core import stream_create as _stream_create
+        session = StreamSession(self, _stream_create(self._handle))
+        self._sessions.add(session)
+        return session